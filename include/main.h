@@ -1,12 +1,41 @@
 #include <Arduino.h>
 #include <SPI.h>
 #include <ArduinoJson.h>
+#include <LittleFS.h>
+#include <WiFi.h>
 #include "components/Utils/ESPUtils.h"
+#include "components/Utils/BumpAllocator.h"
+#include "components/Utils/Logger.h"
 #include "components/LoRa/LoRa.h"
+#include "components/Gateway/LinkStats.h"
+#include "components/Gateway/SerialUplink.h"
+#include "components/Gateway/SegmentLog.h"
+#include "components/Gateway/HttpForwarder.h"
 
 #define ss 5
 #define rst 14
 #define dio0 2
 
+#define SERIAL_BAUD 115200
+#define SERIAL_UPLINK 0 // 1: binary records for tools/uplink instead of text
+#define UPLINK_BAUD 921600
+
+#define LORA_NETWORK 0x01
+#define LORA_ADDRESS 0x01
+#define LORA_TASK_CORE 0 // the Arduino loop runs on core 1
+#define LORA_TASK_PRIORITY 5
+
+#define LINK_STATS_REPORT_MS 60000
+#define LINK_STATS_ROWS_PER_LOOP 4
+#define LINK_STATS_ROW_SIZE 128
+
+#define WIFI_SSID ""
+#define WIFI_PASSWORD ""
+#define FORWARD_URL "" // e.g. "http://192.168.1.10:8080/frames", empty disables forwarding
+#define FORWARD_FORMAT FORWARD_NDJSON
+#define STORE_PATH "/littlefs/store"
+
 void receivePayload(const char *payload, int rssi);
-String sendPayload();
+const char *sendPayload();
+JsonDocument &resetJson();
+void logLinkStats();
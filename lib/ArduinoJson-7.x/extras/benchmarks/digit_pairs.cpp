@@ -0,0 +1,41 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2025, Benoit BLANCHON
+// MIT License
+
+// Serialization time of integers, with and without ARDUINOJSON_DIGIT_PAIRS.
+// Arrays of 1000 values shaped like the fields of the gateway frames: RSSI,
+// millis() timestamps, epoch timestamps in milliseconds, and 64-bit device ids.
+
+#include <random>
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+
+double serializeByDigit(const std::vector<int64_t>& values, long iterations);
+double serializeByPair(const std::vector<int64_t>& values, long iterations);
+
+static std::vector<int64_t> makeValues(int64_t min, int64_t max) {
+  std::mt19937_64 rng(42);
+  std::uniform_int_distribution<int64_t> distribution(min, max);
+  std::vector<int64_t> values;
+  for (int i = 0; i < 1000; i++)
+    values.push_back(distribution(rng));
+  return values;
+}
+
+static void run(const char* name, const std::vector<int64_t>& values) {
+  long iterations = 5000;
+  double digit = serializeByDigit(values, iterations);
+  double pair = serializeByPair(values, iterations);
+  printf("%-16s %10.1f %10.1f %7.2fx\n", name, digit, pair, digit / pair);
+}
+
+int main() {
+  printf("%-16s %10s %10s %8s\n", "values", "digit (ns)", "pair (ns)",
+         "speedup");
+  run("rssi", makeValues(-120, -30));
+  run("millis()", makeValues(0, 4294967295));
+  run("epoch (ms)", makeValues(1600000000000, 1800000000000));
+  run("device id", makeValues(INT64_MIN, INT64_MAX));
+  return 0;
+}
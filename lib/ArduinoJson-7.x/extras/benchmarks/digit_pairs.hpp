@@ -0,0 +1,35 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2025, Benoit BLANCHON
+// MIT License
+
+// Body of the digit pairs benchmark, included once per configuration with
+// BENCHMARK_SERIALIZE naming the entry point
+
+#include <ArduinoJson.h>
+
+#include <chrono>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// Average time to serialize one value, in nanoseconds
+double BENCHMARK_SERIALIZE(const std::vector<int64_t>& values,
+                           long iterations) {
+  JsonDocument doc;
+  for (int64_t value : values)
+    doc.add(value);
+  std::string output(values.size() * 24, '\0');
+  auto start = std::chrono::steady_clock::now();
+  for (long i = -1; i < iterations; i++) {
+    if (i == 0)  // the first pass warms up the caches
+      start = std::chrono::steady_clock::now();
+    if (!serializeJson(doc, &output[0], output.size()))
+      return -1;
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  return static_cast<double>(
+             std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed)
+                 .count()) /
+         static_cast<double>(iterations) /
+         static_cast<double>(values.size());
+}
@@ -0,0 +1,3 @@
+#define ARDUINOJSON_DIGIT_PAIRS 0
+#define BENCHMARK_SERIALIZE serializeByDigit
+#include "digit_pairs.hpp"
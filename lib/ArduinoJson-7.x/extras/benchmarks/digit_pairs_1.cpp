@@ -0,0 +1,3 @@
+#define ARDUINOJSON_DIGIT_PAIRS 1
+#define BENCHMARK_SERIALIZE serializeByPair
+#include "digit_pairs.hpp"
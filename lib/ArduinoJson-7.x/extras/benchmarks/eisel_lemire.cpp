@@ -0,0 +1,54 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2025, Benoit BLANCHON
+// MIT License
+
+// Parsing time of floating point values, with and without
+// ARDUINOJSON_EISEL_LEMIRE, and how many differ from strtod(). The values
+// look like sensor readings (a few decimals), coordinates (6 to 8 decimals),
+// or doubles printed with all their digits.
+
+#include <random>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+double parseWithPowersOfTen(const std::vector<std::string>& numbers,
+                            long iterations);
+double parseWithEiselLemire(const std::vector<std::string>& numbers,
+                            long iterations);
+long checkWithPowersOfTen(const std::vector<std::string>& numbers);
+long checkWithEiselLemire(const std::vector<std::string>& numbers);
+
+static std::vector<std::string> makeNumbers(int decimals, bool scientific,
+                                            double min, double max) {
+  std::mt19937_64 rng(42);
+  std::uniform_real_distribution<double> distribution(min, max);
+  std::vector<std::string> numbers;
+  for (int i = 0; i < 10000; i++) {
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), scientific ? "%.*e" : "%.*f", decimals,
+             distribution(rng));
+    numbers.push_back(buffer);
+  }
+  return numbers;
+}
+
+static void run(const char* name, const std::vector<std::string>& numbers) {
+  long iterations = 200;
+  double slow = parseWithPowersOfTen(numbers, iterations) / 10000;
+  double fast = parseWithEiselLemire(numbers, iterations) / 10000;
+  printf("%-12s %12.1f %12.1f %7.1fx %10ld %10ld\n", name, slow, fast,
+         slow / fast, checkWithPowersOfTen(numbers),
+         checkWithEiselLemire(numbers));
+}
+
+int main() {
+  printf("%-12s %12s %12s %8s %10s %10s\n", "values", "pow10 (ns)",
+         "E-L (ns)", "speedup", "pow10 err", "E-L err");
+  run("sensor", makeNumbers(2, false, -40, 85));
+  run("pressure", makeNumbers(3, false, 900, 1100));
+  run("coordinate", makeNumbers(8, false, -180, 180));
+  run("small", makeNumbers(4, true, 1e-9, 1e-3));
+  run("full", makeNumbers(16, true, -1e6, 1e6));
+  return 0;
+}
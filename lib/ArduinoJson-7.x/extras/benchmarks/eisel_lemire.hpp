@@ -0,0 +1,56 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2025, Benoit BLANCHON
+// MIT License
+
+// Body of the Eisel-Lemire benchmark, included once per configuration with
+// BENCHMARK_PARSE and BENCHMARK_CHECK naming the entry points
+
+#include <ArduinoJson.h>
+
+#include <chrono>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+// Average time to parse every number once, in nanoseconds; like
+// JsonDeserializer, passes the end of the string
+double BENCHMARK_PARSE(const std::vector<std::string>& numbers,
+                       long iterations) {
+  double sum = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (long i = -1; i < iterations; i++) {
+    if (i == 0)  // the first pass warms up the caches
+      start = std::chrono::steady_clock::now();
+    for (const auto& number : numbers) {
+      const char* s = number.c_str();
+      sum += ArduinoJson::detail::parseNumber(s, s + number.size())
+                 .convertTo<double>();
+    }
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  if (sum != sum)  // keeps the loop from being optimized out
+    return -1;
+  return static_cast<double>(
+             std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed)
+                 .count()) /
+         static_cast<double>(iterations);
+}
+
+// Number of values that differ from strtod() or strtof(), depending on the
+// type parseNumber() picks
+long BENCHMARK_CHECK(const std::vector<std::string>& numbers) {
+  using namespace ArduinoJson::detail;
+  long mismatches = 0;
+  for (const auto& number : numbers) {
+    Number n = parseNumber(number.c_str());
+    if (n.type() == NumberType::Float) {
+      float a = n.asFloat(), b = strtof(number.c_str(), nullptr);
+      mismatches += memcmp(&a, &b, sizeof(a)) != 0;
+    } else if (n.type() == NumberType::Double) {
+      double a = n.asDouble(), b = strtod(number.c_str(), nullptr);
+      mismatches += memcmp(&a, &b, sizeof(a)) != 0;
+    }
+  }
+  return mismatches;
+}
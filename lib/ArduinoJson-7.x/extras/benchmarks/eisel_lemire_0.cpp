@@ -0,0 +1,4 @@
+#define ARDUINOJSON_EISEL_LEMIRE 0
+#define BENCHMARK_PARSE parseWithPowersOfTen
+#define BENCHMARK_CHECK checkWithPowersOfTen
+#include "eisel_lemire.hpp"
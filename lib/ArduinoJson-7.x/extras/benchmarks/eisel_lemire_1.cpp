@@ -0,0 +1,4 @@
+#define ARDUINOJSON_EISEL_LEMIRE 1
+#define BENCHMARK_PARSE parseWithEiselLemire
+#define BENCHMARK_CHECK checkWithEiselLemire
+#include "eisel_lemire.hpp"
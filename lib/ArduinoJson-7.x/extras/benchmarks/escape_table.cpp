@@ -0,0 +1,54 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2025, Benoit BLANCHON
+// MIT License
+
+// Serialization time of string-heavy documents, with and without
+// ARDUINOJSON_ESCAPE_TABLE. Strings of 8 to 512 characters, either clean or
+// with an escaped character every 8 characters.
+
+#include <stdio.h>
+#include <string>
+
+double serializeWithList(const std::string& json, long iterations);
+double serializeWithTable(const std::string& json, long iterations);
+
+static std::string makeString(long length, bool escaped) {
+  std::string s;
+  for (long i = 0; i < length; i++) {
+    if (escaped && i % 8 == 7)
+      s += "\\n";
+    else
+      s += char('a' + i % 26);
+  }
+  return s;
+}
+
+// An array of 100 strings
+static std::string makeArray(long length, bool escaped) {
+  std::string json = "[";
+  for (int i = 0; i < 100; i++) {
+    if (i)
+      json += ',';
+    json += "\"" + makeString(length, escaped) + "\"";
+  }
+  return json + "]";
+}
+
+static void run(const char* name, bool escaped) {
+  printf("%-8s %8s %14s %14s %8s\n", name, "length", "list (us)",
+         "table (us)", "speedup");
+  for (long length = 8; length <= 512; length *= 4) {
+    std::string json = makeArray(length, escaped);
+    long iterations = 2000000 / static_cast<long>(json.size()) + 1;
+    double list = serializeWithList(json, iterations);
+    double table = serializeWithTable(json, iterations);
+    printf("%-8s %8ld %14.1f %14.1f %7.1fx\n", "", length, list / 1000,
+           table / 1000, list / table);
+  }
+}
+
+int main() {
+  run("clean", false);
+  run("escaped", true);
+  return 0;
+}
@@ -0,0 +1,29 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2025, Benoit BLANCHON
+// MIT License
+
+// Body of the escape table benchmark, included once per configuration with
+// BENCHMARK_SERIALIZE naming the entry point
+
+#include <ArduinoJson.h>
+
+#include <chrono>
+#include <string>
+
+// Average time to serialize json to a buffer, in nanoseconds
+double BENCHMARK_SERIALIZE(const std::string& json, long iterations) {
+  JsonDocument doc;
+  if (deserializeJson(doc, json) != DeserializationError::Ok)
+    return -1;
+  std::string output(json.size() + 1, '\0');
+  auto start = std::chrono::steady_clock::now();
+  for (long i = 0; i < iterations; i++) {
+    if (serializeJson(doc, &output[0], output.size()) != json.size())
+      return -1;
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  return static_cast<double>(
+             std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed)
+                 .count()) /
+         static_cast<double>(iterations);
+}
@@ -0,0 +1,3 @@
+#define ARDUINOJSON_ESCAPE_TABLE 0
+#define BENCHMARK_SERIALIZE serializeWithList
+#include "escape_table.hpp"
@@ -0,0 +1,3 @@
+#define ARDUINOJSON_ESCAPE_TABLE 1
+#define BENCHMARK_SERIALIZE serializeWithTable
+#include "escape_table.hpp"
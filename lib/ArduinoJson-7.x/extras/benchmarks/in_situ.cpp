@@ -0,0 +1,121 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2025, Benoit BLANCHON
+// MIT License
+
+// Deserialization of a received buffer, with deserializeJson(), which copies
+// the keys and the strings, versus deserializeJsonInSitu(), which leaves them
+// in the buffer. The inputs are a LoRa frame and gateway reports of N frames.
+// Measures the time and the peak of the heap; both loops restore the buffer
+// before each run, as the in situ mode modifies it.
+
+#include <ArduinoJson.h>
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+// Tracks the bytes in use and their peak
+class PeakAllocator : public ArduinoJson::Allocator {
+ public:
+  size_t peak = 0;
+
+  virtual ~PeakAllocator() {}
+
+  void* allocate(size_t n) override {
+    auto p = static_cast<size_t*>(malloc(n + sizeof(size_t)));
+    if (!p)
+      return nullptr;
+    *p = n;
+    add(n);
+    return p + 1;
+  }
+
+  void deallocate(void* p) override {
+    auto block = static_cast<size_t*>(p) - 1;
+    current_ -= *block;
+    free(block);
+  }
+
+  void* reallocate(void* p, size_t n) override {
+    auto block = static_cast<size_t*>(p) - 1;
+    current_ -= *block;
+    block = static_cast<size_t*>(realloc(block, n + sizeof(size_t)));
+    if (!block)
+      return nullptr;
+    *block = n;
+    add(n);
+    return block + 1;
+  }
+
+ private:
+  void add(size_t n) {
+    current_ += n;
+    if (current_ > peak)
+      peak = current_;
+  }
+
+  size_t current_ = 0;
+};
+
+static std::string makeFrame(int i) {
+  return "{\"id\":\"" + std::to_string(1718000000000 + i) +
+         "\",\"type\":\"telemetry\",\"node\":\"node-" +
+         std::to_string(i % 16) +
+         "\",\"fw\":\"v2.3.1-lora\",\"payload\":\"AQIDBAUGBwgJCgsMDQ4PEA==\","
+         "\"status\":\"ok\",\"rssi\":-97}";
+}
+
+static std::string makeReport(int frames) {
+  std::string json = "{\"gateway\":\"gw-01\",\"frames\":[";
+  for (int i = 0; i < frames; i++) {
+    if (i)
+      json += ',';
+    json += makeFrame(i);
+  }
+  return json + "]}";
+}
+
+// Average time of one run in microseconds, and the peak of the heap
+static double measure(const std::string& json, bool inSitu, size_t& peak) {
+  long iterations = 20000000 / static_cast<long>(json.size()) + 1;
+  std::string buffer(json);
+  PeakAllocator allocator;
+  auto start = std::chrono::steady_clock::now();
+  for (long i = 0; i < iterations; i++) {
+    memcpy(&buffer[0], json.data(), json.size());
+    JsonDocument doc(&allocator);
+    DeserializationError err = inSitu
+                                   ? deserializeJsonInSitu(doc, &buffer[0])
+                                   : deserializeJson(doc, buffer.c_str());
+    if (err)
+      return -1;
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  peak = allocator.peak;
+  return static_cast<double>(
+             std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed)
+                 .count()) /
+         static_cast<double>(iterations) / 1000;
+}
+
+static void run(const char* name, const std::string& json) {
+  size_t copyPeak, inSituPeak;
+  double copy = measure(json, false, copyPeak);
+  double inSitu = measure(json, true, inSituPeak);
+  printf("%-12s %8zu %10.2f %8zu %10.2f %8zu\n", name, json.size(), copy,
+         copyPeak, inSitu, inSituPeak);
+}
+
+int main() {
+  printf("%-12s %8s %10s %8s %10s %8s\n", "input", "bytes", "copy (us)",
+         "(heap)", "situ (us)", "(heap)");
+  run("frame", makeFrame(0));
+  for (int frames = 10; frames <= 1000; frames *= 10) {
+    char name[16];
+    snprintf(name, sizeof(name), "report/%d", frames);
+    run(name, makeReport(frames));
+  }
+  return 0;
+}
@@ -0,0 +1,144 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2025, Benoit BLANCHON
+// MIT License
+
+// A gateway report with N frames, received in chunks of a given size: the
+// chunks appended to a growing buffer that deserializeJson() parses at the
+// end, versus JsonIncrementalDeserializer fed with each chunk. Measures the
+// time and the peak of the heap, plus the size of the parser, which lives on
+// the stack.
+
+#include <ArduinoJson.h>
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+// Tracks the bytes in use and their peak
+class PeakAllocator : public ArduinoJson::Allocator {
+ public:
+  size_t peak = 0;
+
+  virtual ~PeakAllocator() {}
+
+  void* allocate(size_t n) override {
+    auto p = static_cast<size_t*>(malloc(n + sizeof(size_t)));
+    if (!p)
+      return nullptr;
+    *p = n;
+    add(n);
+    return p + 1;
+  }
+
+  void deallocate(void* p) override {
+    auto block = static_cast<size_t*>(p) - 1;
+    current_ -= *block;
+    free(block);
+  }
+
+  void* reallocate(void* p, size_t n) override {
+    auto block = static_cast<size_t*>(p) - 1;
+    current_ -= *block;
+    block = static_cast<size_t*>(realloc(block, n + sizeof(size_t)));
+    if (!block)
+      return nullptr;
+    *block = n;
+    add(n);
+    return block + 1;
+  }
+
+ private:
+  void add(size_t n) {
+    current_ += n;
+    if (current_ > peak)
+      peak = current_;
+  }
+
+  size_t current_ = 0;
+};
+
+static std::string makeReport(int frames) {
+  std::string json = "{\"gateway\":\"gw-01\",\"frames\":[";
+  for (int i = 0; i < frames; i++) {
+    if (i)
+      json += ',';
+    json += "{\"node\":\"node-" + std::to_string(i % 16) +
+            "\",\"rssi\":-" + std::to_string(90 + i % 20) +
+            ",\"snr\":9.5,\"temp\":23.45,\"payload\":\"AQIDBAUGBwgJCgsM\"}";
+  }
+  return json + "]}";
+}
+
+// Appends the chunks to a buffer that doubles, like a String would, then
+// parses it
+static int bufferThenParse(const std::string& json, size_t chunkSize,
+                           PeakAllocator& allocator) {
+  size_t capacity = 64, size = 0;
+  auto buffer = static_cast<char*>(allocator.allocate(capacity));
+  for (size_t i = 0; i < json.size(); i += chunkSize) {
+    size_t n = json.size() - i < chunkSize ? json.size() - i : chunkSize;
+    while (size + n > capacity) {
+      capacity *= 2;
+      buffer = static_cast<char*>(allocator.reallocate(buffer, capacity));
+    }
+    memcpy(buffer + size, json.data() + i, n);
+    size += n;
+  }
+  JsonDocument doc(&allocator);
+  deserializeJson(doc, buffer, size);
+  allocator.deallocate(buffer);
+  return static_cast<int>(doc["frames"].size());
+}
+
+static int incremental(const std::string& json, size_t chunkSize,
+                       PeakAllocator& allocator) {
+  JsonDocument doc(&allocator);
+  JsonIncrementalDeserializer parser(doc);
+  for (size_t i = 0; i < json.size(); i += chunkSize) {
+    size_t n = json.size() - i < chunkSize ? json.size() - i : chunkSize;
+    parser.feed(json.data() + i, n);
+  }
+  parser.finish();
+  return static_cast<int>(doc["frames"].size());
+}
+
+// Average time of one report in microseconds, and the peak of the heap
+static double measure(const std::string& json, size_t chunkSize, int frames,
+                      bool isIncremental, size_t& peak) {
+  long iterations = 20000000 / static_cast<long>(json.size()) + 1;
+  PeakAllocator allocator;
+  auto start = std::chrono::steady_clock::now();
+  for (long i = 0; i < iterations; i++) {
+    int n = isIncremental ? incremental(json, chunkSize, allocator)
+                          : bufferThenParse(json, chunkSize, allocator);
+    if (n != frames)
+      return -1;
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  peak = allocator.peak;
+  return static_cast<double>(
+             std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed)
+                 .count()) /
+         static_cast<double>(iterations) / 1000;
+}
+
+int main() {
+  printf("sizeof(JsonIncrementalDeserializer) = %zu\n\n",
+         sizeof(JsonIncrementalDeserializer));
+  printf("%6s %6s %8s %12s %8s %12s %8s\n", "chunk", "frames", "bytes",
+         "buffer (us)", "(heap)", "incr. (us)", "(heap)");
+  const size_t chunkSizes[] = {51, 255, 1460};
+  for (size_t chunkSize : chunkSizes) {
+    for (int frames = 1; frames <= 1000; frames *= 10) {
+      std::string json = makeReport(frames);
+      size_t bufferPeak, incrementalPeak;
+      double buffer = measure(json, chunkSize, frames, false, bufferPeak);
+      double incr = measure(json, chunkSize, frames, true, incrementalPeak);
+      printf("%6zu %6d %8zu %12.2f %8zu %12.2f %8zu\n", chunkSize, frames,
+             json.size(), buffer, bufferPeak, incr, incrementalPeak);
+    }
+  }
+  return 0;
+}
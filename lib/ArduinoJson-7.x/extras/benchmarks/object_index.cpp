@@ -0,0 +1,62 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2025, Benoit BLANCHON
+// MIT License
+
+// Parse time of objects with 10 to 10000 members, and time to look up all
+// their keys, with and without ARDUINOJSON_OBJECT_INDEX.
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+double parseWithoutIndex(const std::string& json, long iterations);
+double parseWithIndex(const std::string& json, long iterations);
+double lookUpWithoutIndex(const std::string& json,
+                          const std::vector<std::string>& keys,
+                          long iterations);
+double lookUpWithIndex(const std::string& json,
+                       const std::vector<std::string>& keys, long iterations);
+
+static std::vector<std::string> makeKeys(long count) {
+  std::vector<std::string> keys;
+  for (long i = 0; i < count; i++)
+    keys.push_back("sensor_" + std::to_string(i));
+  return keys;
+}
+
+static std::string makeObject(const std::vector<std::string>& keys) {
+  std::string json = "{";
+  for (size_t i = 0; i < keys.size(); i++) {
+    if (i)
+      json += ',';
+    json += "\"" + keys[i] + "\":" + std::to_string(i);
+  }
+  return json + "}";
+}
+
+static void printRow(long members, double without, double with) {
+  printf("%-8s %8ld %14.1f %14.1f %7.1fx\n", "", members, without / 1000,
+         with / 1000, without / with);
+}
+
+int main() {
+  printf("%-8s %8s %14s %14s %8s\n", "parse", "members", "scan (us)",
+         "index (us)", "speedup");
+  for (long members = 10; members <= 10000; members *= 10) {
+    std::string json = makeObject(makeKeys(members));
+    long iterations = 100000 / members + 1;
+    printRow(members, parseWithoutIndex(json, iterations),
+             parseWithIndex(json, iterations));
+  }
+
+  printf("%-8s %8s %14s %14s %8s\n", "lookup", "members", "scan (us)",
+         "index (us)", "speedup");
+  for (long members = 10; members <= 10000; members *= 10) {
+    auto keys = makeKeys(members);
+    std::string json = makeObject(keys);
+    long iterations = 100000 / members + 1;
+    printRow(members, lookUpWithoutIndex(json, keys, iterations),
+             lookUpWithIndex(json, keys, iterations));
+  }
+  return 0;
+}
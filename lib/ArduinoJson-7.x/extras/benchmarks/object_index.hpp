@@ -0,0 +1,50 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2025, Benoit BLANCHON
+// MIT License
+
+// Body of the object index benchmark, included once per configuration with
+// BENCHMARK_PARSE and BENCHMARK_LOOKUP naming the entry points
+
+#include <ArduinoJson.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+static double elapsedNs(std::chrono::steady_clock::time_point start,
+                        long iterations) {
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  return static_cast<double>(
+             std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed)
+                 .count()) /
+         static_cast<double>(iterations);
+}
+
+// Average time to parse json, in nanoseconds
+double BENCHMARK_PARSE(const std::string& json, long iterations) {
+  JsonDocument doc;
+  auto start = std::chrono::steady_clock::now();
+  for (long i = 0; i < iterations; i++) {
+    if (deserializeJson(doc, json) != DeserializationError::Ok)
+      return -1;
+  }
+  return elapsedNs(start, iterations);
+}
+
+// Average time to look up every key of json once, in nanoseconds
+double BENCHMARK_LOOKUP(const std::string& json,
+                        const std::vector<std::string>& keys,
+                        long iterations) {
+  JsonDocument doc;
+  if (deserializeJson(doc, json) != DeserializationError::Ok)
+    return -1;
+  JsonObjectConst obj = doc.as<JsonObjectConst>();
+  long sum = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (long i = 0; i < iterations; i++) {
+    for (const auto& key : keys)
+      sum += obj[key].as<long>();
+  }
+  double result = elapsedNs(start, iterations);
+  return sum >= 0 ? result : -1;  // keeps the lookups from being optimized out
+}
@@ -0,0 +1,4 @@
+#define ARDUINOJSON_OBJECT_INDEX 0
+#define BENCHMARK_PARSE parseWithoutIndex
+#define BENCHMARK_LOOKUP lookUpWithoutIndex
+#include "object_index.hpp"
@@ -0,0 +1,4 @@
+#define ARDUINOJSON_OBJECT_INDEX 1
+#define BENCHMARK_PARSE parseWithIndex
+#define BENCHMARK_LOOKUP lookUpWithIndex
+#include "object_index.hpp"
@@ -0,0 +1,191 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2025, Benoit BLANCHON
+// MIT License
+
+// Extraction of one field, data.serverTime, from a response padded with N
+// other records: parseJson() with a handler that stops at the field, versus
+// deserializeJson() with a Filter. Measures the time and the peak of the heap
+// used by the library, from a string and from a stream.
+
+#include <ArduinoJson.h>
+
+#include <chrono>
+#include <sstream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+
+// Tracks the bytes in use and their peak
+class PeakAllocator : public ArduinoJson::Allocator {
+ public:
+  size_t peak = 0;
+
+  virtual ~PeakAllocator() {}
+
+  void* allocate(size_t n) override {
+    auto p = static_cast<size_t*>(malloc(n + sizeof(size_t)));
+    if (!p)
+      return nullptr;
+    *p = n;
+    add(n);
+    return p + 1;
+  }
+
+  void deallocate(void* p) override {
+    auto block = static_cast<size_t*>(p) - 1;
+    current_ -= *block;
+    free(block);
+  }
+
+  void* reallocate(void* p, size_t n) override {
+    auto block = static_cast<size_t*>(p) - 1;
+    current_ -= *block;
+    block = static_cast<size_t*>(realloc(block, n + sizeof(size_t)));
+    if (!block)
+      return nullptr;
+    *block = n;
+    add(n);
+    return block + 1;
+  }
+
+ private:
+  void add(size_t n) {
+    current_ += n;
+    if (current_ > peak)
+      peak = current_;
+  }
+
+  size_t current_ = 0;
+};
+
+// Finds data.serverTime, as a number or a string, and stops there; skips
+// the other members like the Filter
+class ServerTimeHandler : public JsonHandler {
+ public:
+  long long serverTime = 0;
+
+  bool skipValue() {
+    return (depth_ == 1 && !inData_) || (depth_ == 2 && !found_);
+  }
+
+  bool startObject() {
+    depth_++;
+    return true;
+  }
+
+  bool endObject() {
+    depth_--;
+    return true;
+  }
+
+  bool startArray() {
+    depth_++;
+    return true;
+  }
+
+  bool endArray() {
+    depth_--;
+    return true;
+  }
+
+  bool key(JsonString key) {
+    if (depth_ == 1)
+      inData_ = key == "data";
+    else if (depth_ == 2 && inData_)
+      found_ = key == "serverTime";
+    return true;
+  }
+
+  bool string(JsonString s) {
+    if (!found_)
+      return true;
+    serverTime = strtoll(std::string(s.c_str(), s.size()).c_str(), nullptr, 10);
+    return false;
+  }
+
+  bool unsignedInteger(JsonUInt i) {
+    if (!found_)
+      return true;
+    serverTime = static_cast<long long>(i);
+    return false;
+  }
+
+ private:
+  int depth_ = 0;
+  bool inData_ = false;
+  bool found_ = false;
+};
+
+static std::string makeResponse(int records) {
+  std::string json = "{\"code\":\"00000\",\"msg\":\"success\",\"records\":[";
+  for (int i = 0; i < records; i++) {
+    if (i)
+      json += ',';
+    json += "{\"symbol\":\"BTCUSDT\",\"price\":\"67234.5\",\"ts\":" +
+            std::to_string(1718000000000 + i) + ",\"note\":\"a\\nb\"}";
+  }
+  return json + "],\"data\":{\"serverTime\":\"1718000000123\"}}";
+}
+
+template <typename TInput>
+static long long withHandler(TInput&& input, PeakAllocator& allocator) {
+  ServerTimeHandler handler;
+  parseJson(input, handler, {}, &allocator);
+  return handler.serverTime;
+}
+
+template <typename TInput>
+static long long withFilter(TInput&& input, PeakAllocator& allocator) {
+  JsonDocument filter(&allocator);
+  filter["data"]["serverTime"] = true;
+  JsonDocument doc(&allocator);
+  deserializeJson(doc, input, DeserializationOption::Filter(filter));
+  return strtoll(doc["data"]["serverTime"] | "0", nullptr, 10);
+}
+
+static long long extract(const std::string& json, bool stream, bool handler,
+                         PeakAllocator& allocator) {
+  if (stream) {
+    std::istringstream s(json);
+    return handler ? withHandler(s, allocator) : withFilter(s, allocator);
+  }
+  const char* s = json.c_str();
+  return handler ? withHandler(s, allocator) : withFilter(s, allocator);
+}
+
+// Average time of one extraction in microseconds, and the peak of the heap
+static double measure(const std::string& json, bool stream, bool handler,
+                      size_t& peak) {
+  long iterations = 20000000 / static_cast<long>(json.size()) + 1;
+  PeakAllocator allocator;
+  auto start = std::chrono::steady_clock::now();
+  for (long i = 0; i < iterations; i++) {
+    if (extract(json, stream, handler, allocator) != 1718000000123)
+      return -1;
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  peak = allocator.peak;
+  return static_cast<double>(
+             std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed)
+                 .count()) /
+         static_cast<double>(iterations) / 1000;
+}
+
+static void run(const char* name, bool stream) {
+  printf("%-8s %8s %8s %12s %8s %12s %8s\n", name, "records", "bytes",
+         "filter (us)", "(heap)", "handler (us)", "(heap)");
+  for (int records = 0; records <= 1000; records = records ? records * 10 : 1) {
+    std::string json = makeResponse(records);
+    size_t filterPeak, handlerPeak;
+    double filter = measure(json, stream, false, filterPeak);
+    double handler = measure(json, stream, true, handlerPeak);
+    printf("%-8s %8d %8zu %12.2f %8zu %12.2f %8zu\n", "", records, json.size(),
+           filter, filterPeak, handler, handlerPeak);
+  }
+}
+
+int main() {
+  run("string", false);
+  run("stream", true);
+  return 0;
+}
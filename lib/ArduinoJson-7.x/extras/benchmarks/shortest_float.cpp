@@ -0,0 +1,136 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2025, Benoit BLANCHON
+// MIT License
+
+// Serialization of floating point values, with and without
+// ARDUINOJSON_SHORTEST_FLOAT: time per value, then the size of telemetry
+// frames serialized again, and how many don't parse back to the same values.
+// Pass NDJSON files of recorded frames (one JSON document per line) to
+// measure them; without arguments, uses synthetic frames shaped like the
+// node readings.
+
+#include <chrono>
+#include <fstream>
+#include <random>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#  include <x86intrin.h>
+#endif
+
+double formatFixed(const std::vector<double>& values, bool asFloat,
+                   long iterations);
+double formatShortest(const std::vector<double>& values, bool asFloat,
+                      long iterations);
+size_t rewriteFixed(const std::vector<std::string>& frames, long& lossy);
+size_t rewriteShortest(const std::vector<std::string>& frames, long& lossy);
+
+// Time stamp counter ticks per nanosecond, or 0 if unknown
+static double ticksPerNanosecond() {
+#if defined(__x86_64__) || defined(__i386__)
+  auto start = std::chrono::steady_clock::now();
+  auto ticks = __rdtsc();
+  while (std::chrono::steady_clock::now() - start <
+         std::chrono::milliseconds(100)) {
+  }
+  ticks = __rdtsc() - ticks;
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  return static_cast<double>(ticks) /
+         static_cast<double>(
+             std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed)
+                 .count());
+#else
+  return 0;
+#endif
+}
+
+static std::vector<double> makeValues(double min, double max, int decimals) {
+  std::mt19937_64 rng(42);
+  std::uniform_real_distribution<double> distribution(min, max);
+  std::vector<double> values;
+  for (int i = 0; i < 1000; i++) {
+    double value = distribution(rng);
+    if (decimals >= 0) {
+      double scale = 1;
+      for (int j = 0; j < decimals; j++)
+        scale *= 10;
+      value = static_cast<double>(static_cast<long long>(value * scale)) /
+              scale;
+    }
+    values.push_back(value);
+  }
+  return values;
+}
+
+static void runFormat(const char* name, const std::vector<double>& values,
+                      bool asFloat, double ticks) {
+  long iterations = 2000;
+  double fixed = formatFixed(values, asFloat, iterations);
+  double shortest = formatShortest(values, asFloat, iterations);
+  printf("%-22s %8.1f %8.0f %10.1f %8.0f %7.2fx\n", name, fixed, fixed * ticks,
+         shortest, shortest * ticks, fixed / shortest);
+}
+
+static std::string makeFrame(long i, std::mt19937_64& rng) {
+  std::uniform_real_distribution<double> unit(0, 1);
+  char frame[256];
+  snprintf(frame, sizeof(frame),
+           "{\"src\":%ld,\"seq\":%ld,\"rssi\":%d,\"snr\":%.2f,"
+           "\"temp\":%.1f,\"hum\":%.1f,\"bat\":%.3f,\"lat\":%.7f,"
+           "\"lon\":%.7f,\"loss\":%.17g}",
+           i % 16, i, -40 - static_cast<int>(unit(rng) * 80),
+           -10 + unit(rng) * 20, -10 + unit(rng) * 50, unit(rng) * 100,
+           3.3 + unit(rng), 18.4 + unit(rng) / 10, -69.9 - unit(rng) / 10,
+           static_cast<double>(static_cast<int>(unit(rng) * 50)) / 49);
+  return frame;
+}
+
+static void runRewrite(const char* name,
+                       const std::vector<std::string>& frames) {
+  size_t input = 0;
+  for (const auto& frame : frames)
+    input += frame.size();
+  long fixedLossy, shortestLossy;
+  size_t fixed = rewriteFixed(frames, fixedLossy);
+  size_t shortest = rewriteShortest(frames, shortestLossy);
+  printf("%s: %zu frames, %zu bytes\n", name, frames.size(), input);
+  printf("  %-10s %10s %10s\n", "", "bytes", "lossy");
+  printf("  %-10s %10zu %10ld\n", "fixed", fixed, fixedLossy);
+  printf("  %-10s %10zu %10ld\n", "shortest", shortest, shortestLossy);
+}
+
+static std::vector<std::string> readFrames(const char* path) {
+  std::vector<std::string> frames;
+  std::ifstream file(path);
+  std::string line;
+  while (std::getline(file, line)) {
+    if (!line.empty())
+      frames.push_back(line);
+  }
+  return frames;
+}
+
+int main(int argc, char* argv[]) {
+  double ticks = ticksPerNanosecond();
+  printf("%-22s %8s %8s %10s %8s %8s\n", "values", "fixed", "(ticks)",
+         "shortest", "(ticks)", "speedup");
+  runFormat("sensor float (%.1f)", makeValues(-10, 40, 1), true, ticks);
+  runFormat("voltage float (%.3f)", makeValues(3, 4.2, 3), true, ticks);
+  runFormat("coordinate (%.7f)", makeValues(-180, 180, 7), false, ticks);
+  runFormat("random double", makeValues(-1e6, 1e6, -1), false, ticks);
+  printf("(ns per value, with time stamp counter ticks)\n\n");
+
+  if (argc > 1) {
+    for (int i = 1; i < argc; i++)
+      runRewrite(argv[i], readFrames(argv[i]));
+  } else {
+    std::mt19937_64 rng(42);
+    std::vector<std::string> frames;
+    for (long i = 0; i < 1000; i++)
+      frames.push_back(makeFrame(i, rng));
+    runRewrite("synthetic telemetry", frames);
+  }
+  return 0;
+}
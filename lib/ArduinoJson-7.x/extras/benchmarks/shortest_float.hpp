@@ -0,0 +1,64 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2025, Benoit BLANCHON
+// MIT License
+
+// Body of the shortest float benchmark, included once per configuration with
+// BENCHMARK_FORMAT and BENCHMARK_REWRITE naming the entry points. Both parse
+// with ARDUINOJSON_EISEL_LEMIRE, so that the round-trip check only depends on
+// the formatter.
+
+#define ARDUINOJSON_EISEL_LEMIRE 1
+#include <ArduinoJson.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+// Average time to serialize one value, in nanoseconds; the values are
+// stored as floats if asFloat is true
+double BENCHMARK_FORMAT(const std::vector<double>& values, bool asFloat,
+                        long iterations) {
+  JsonDocument doc;
+  for (double value : values) {
+    if (asFloat)
+      doc.add(static_cast<float>(value));
+    else
+      doc.add(value);
+  }
+  std::string output(values.size() * 32, '\0');
+  auto start = std::chrono::steady_clock::now();
+  for (long i = -1; i < iterations; i++) {
+    if (i == 0)  // the first pass warms up the caches
+      start = std::chrono::steady_clock::now();
+    if (!serializeJson(doc, &output[0], output.size()))
+      return -1;
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  return static_cast<double>(
+             std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed)
+                 .count()) /
+         static_cast<double>(iterations) /
+         static_cast<double>(values.size());
+}
+
+// Parses and serializes every frame again, returns the total size of the
+// output; lossy counts the frames that don't parse back to the same values.
+// With the shortest output, the remaining ones are values like -69.9918100,
+// stored as double because of the trailing zeros, whose shortest form has few
+// enough digits to be parsed back as a float.
+size_t BENCHMARK_REWRITE(const std::vector<std::string>& frames, long& lossy) {
+  JsonDocument doc, copy;
+  std::string output;
+  size_t bytes = 0;
+  lossy = 0;
+  for (const auto& frame : frames) {
+    if (deserializeJson(doc, frame))
+      continue;
+    output.clear();
+    bytes += serializeJson(doc, output);
+    deserializeJson(copy, output);
+    if (copy != doc)
+      lossy++;
+  }
+  return bytes;
+}
@@ -0,0 +1,4 @@
+#define ARDUINOJSON_SHORTEST_FLOAT 0
+#define BENCHMARK_FORMAT formatFixed
+#define BENCHMARK_REWRITE rewriteFixed
+#include "shortest_float.hpp"
@@ -0,0 +1,4 @@
+#define ARDUINOJSON_SHORTEST_FLOAT 1
+#define BENCHMARK_FORMAT formatShortest
+#define BENCHMARK_REWRITE rewriteShortest
+#include "shortest_float.hpp"
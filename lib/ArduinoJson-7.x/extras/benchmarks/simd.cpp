@@ -0,0 +1,106 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2025, Benoit BLANCHON
+// MIT License
+
+// Parse throughput of gateway frames with and without ARDUINOJSON_ENABLE_SIMD
+//
+//   ./simd_benchmark [corpus.ndjson...]
+//
+// A corpus holds one frame per line, such as the batches saved by
+// tools/forwarder/stand_in_server.py --save. Without arguments, the benchmark
+// uses synthetic frames shaped like the forwarder's records: compact,
+// pretty-printed, and carrying a 2 KB base64 payload.
+
+#include <fstream>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+double parseScalar(const std::vector<std::string>& frames, bool bounded,
+                   long iterations);
+double parseSimd(const std::vector<std::string>& frames, bool bounded,
+                 long iterations);
+
+static std::string makeFrame(long i, bool pretty) {
+  std::string nl = pretty ? "\n  " : "";
+  std::string sp = pretty ? " " : "";
+  std::string payload = "{\\\"id\\\":\\\"A4CF12" + std::to_string(i % 16) +
+                        "\\\",\\\"type\\\":\\\"reading\\\",\\\"data\\\":\\\"" +
+                        std::string(static_cast<size_t>(20 + i % 60), 'x') +
+                        "\\\",\\\"date\\\":" + std::to_string(i * 977) + "}";
+  std::string frame = "{" + nl + "\"src\":" + sp + std::to_string(i % 16) +
+                      "," + nl + "\"seq\":" + sp + std::to_string(i) + "," +
+                      nl + "\"hops\":" + sp + "1," + nl + "\"rssi\":" + sp +
+                      "-87," + nl + "\"snr\":" + sp + "7.25," + nl +
+                      "\"time\":" + sp + std::to_string(1760000000 + i) +
+                      "," + nl + "\"payload\":" + sp + "\"" + payload + "\"";
+  return frame + (pretty ? "\n}" : "}");
+}
+
+static std::string makeBulkFrame(long i) {
+  static const char digits[] =
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  std::string payload;
+  for (long j = 0; j < 2048; j++)
+    payload += digits[(i * 31 + j * 7) % 64];
+  return "{\"src\":" + std::to_string(i % 16) + ",\"seq\":" +
+         std::to_string(i) + ",\"payload\":\"" + payload + "\"}";
+}
+
+static bool loadCorpus(const char* path, std::vector<std::string>& frames) {
+  std::ifstream file(path);
+  if (!file)
+    return false;
+  std::string line;
+  while (std::getline(file, line)) {
+    if (line.find_first_not_of(" \t\r") != std::string::npos)
+      frames.push_back(line);
+  }
+  return true;
+}
+
+static void run(const char* name, const std::vector<std::string>& frames) {
+  size_t bytes = 0;
+  for (const auto& frame : frames)
+    bytes += frame.size();
+  long iterations = static_cast<long>(20000000 / (bytes + 1)) + 1;
+  printf("%s: %zu frames, %zu bytes\n", name, frames.size(), bytes);
+  printf("  %-10s %14s %14s %8s\n", "input", "scalar (MB/s)", "simd (MB/s)",
+         "speedup");
+  for (int bounded = 1; bounded >= 0; bounded--) {
+    double scalar = parseScalar(frames, bounded != 0, iterations);
+    double simd = parseSimd(frames, bounded != 0, iterations);
+    if (scalar < 0 || simd < 0) {
+      printf("  invalid frame\n");
+      return;
+    }
+    printf("  %-10s %14.1f %14.1f %7.2fx\n", bounded ? "bounded" : "NUL-term",
+           static_cast<double>(bytes) * 1000 / scalar,
+           static_cast<double>(bytes) * 1000 / simd, scalar / simd);
+  }
+}
+
+int main(int argc, char* argv[]) {
+  if (argc > 1) {
+    for (int i = 1; i < argc; i++) {
+      std::vector<std::string> frames;
+      if (!loadCorpus(argv[i], frames)) {
+        fprintf(stderr, "can't read %s\n", argv[i]);
+        return 1;
+      }
+      run(argv[i], frames);
+    }
+    return 0;
+  }
+
+  std::vector<std::string> compact, pretty, bulk;
+  for (long i = 0; i < 1000; i++) {
+    compact.push_back(makeFrame(i, false));
+    pretty.push_back(makeFrame(i, true));
+    bulk.push_back(makeBulkFrame(i));
+  }
+  run("synthetic compact", compact);
+  run("synthetic pretty", pretty);
+  run("synthetic bulk", bulk);
+  return 0;
+}
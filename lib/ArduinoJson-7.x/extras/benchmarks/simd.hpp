@@ -0,0 +1,35 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2025, Benoit BLANCHON
+// MIT License
+
+// Body of the SIMD benchmark, included once per configuration with
+// BENCHMARK_PARSE naming the entry point
+
+#include <ArduinoJson.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+// Average time to parse every frame once, in nanoseconds; frames are passed
+// with their size, or NUL-terminated if bounded is false
+double BENCHMARK_PARSE(const std::vector<std::string>& frames, bool bounded,
+                       long iterations) {
+  JsonDocument doc;
+  auto start = std::chrono::steady_clock::now();
+  for (long i = -1; i < iterations; i++) {
+    if (i == 0)  // the first pass warms up the allocator and the caches
+      start = std::chrono::steady_clock::now();
+    for (const auto& frame : frames) {
+      auto err = bounded ? deserializeJson(doc, frame.data(), frame.size())
+                         : deserializeJson(doc, frame.c_str());
+      if (err)
+        return -1;
+    }
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  return static_cast<double>(
+             std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed)
+                 .count()) /
+         static_cast<double>(iterations);
+}
@@ -0,0 +1,3 @@
+#define ARDUINOJSON_ENABLE_SIMD 0
+#define BENCHMARK_PARSE parseScalar
+#include "simd.hpp"
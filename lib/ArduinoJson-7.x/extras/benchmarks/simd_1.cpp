@@ -0,0 +1,3 @@
+#define ARDUINOJSON_ENABLE_SIMD 1
+#define BENCHMARK_PARSE parseSimd
+#include "simd.hpp"
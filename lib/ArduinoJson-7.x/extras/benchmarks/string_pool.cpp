@@ -0,0 +1,53 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2025, Benoit BLANCHON
+// MIT License
+
+// Parse time of documents with 10 to 10000 distinct strings, with and
+// without ARDUINOJSON_STRING_POOL_INDEX. Arrays measure the string pool
+// alone; objects also look up every key among the previous members.
+
+#include <stdio.h>
+#include <string>
+
+double parseWithList(const std::string& json, long iterations);
+double parseWithIndex(const std::string& json, long iterations);
+
+static std::string makeArray(long count) {
+  std::string json = "[";
+  for (long i = 0; i < count; i++) {
+    if (i)
+      json += ',';
+    json += "\"reading_" + std::to_string(i) + "\"";
+  }
+  return json + "]";
+}
+
+static std::string makeObject(long count) {
+  std::string json = "{";
+  for (long i = 0; i < count; i++) {
+    if (i)
+      json += ',';
+    json += "\"sensor_" + std::to_string(i) + "\":\"reading_" +
+            std::to_string(i) + "\"";
+  }
+  return json + "}";
+}
+
+static void run(const char* name, std::string (*make)(long), long perString) {
+  printf("%-8s %8s %14s %14s %8s\n", name, "strings", "list (us)",
+         "index (us)", "speedup");
+  for (long strings = 10; strings <= 10000; strings *= 10) {
+    std::string json = make(strings / perString);
+    long iterations = 200000 / strings + 1;
+    double list = parseWithList(json, iterations);
+    double index = parseWithIndex(json, iterations);
+    printf("%-8s %8ld %14.1f %14.1f %7.1fx\n", "", strings, list / 1000,
+           index / 1000, list / index);
+  }
+}
+
+int main() {
+  run("array", makeArray, 1);
+  run("object", makeObject, 2);
+  return 0;
+}
@@ -0,0 +1,26 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2025, Benoit BLANCHON
+// MIT License
+
+// Body of the string pool benchmark, included once per configuration with
+// BENCHMARK_PARSE naming the entry point
+
+#include <ArduinoJson.h>
+
+#include <chrono>
+#include <string>
+
+// Average time to parse json, in nanoseconds
+double BENCHMARK_PARSE(const std::string& json, long iterations) {
+  JsonDocument doc;
+  auto start = std::chrono::steady_clock::now();
+  for (long i = 0; i < iterations; i++) {
+    if (deserializeJson(doc, json) != DeserializationError::Ok)
+      return -1;
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  return static_cast<double>(
+             std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed)
+                 .count()) /
+         static_cast<double>(iterations);
+}
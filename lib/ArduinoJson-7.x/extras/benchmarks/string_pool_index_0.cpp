@@ -0,0 +1,3 @@
+#define ARDUINOJSON_STRING_POOL_INDEX 0
+#define BENCHMARK_PARSE parseWithList
+#include "string_pool.hpp"
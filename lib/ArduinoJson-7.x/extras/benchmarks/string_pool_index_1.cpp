@@ -0,0 +1,3 @@
+#define ARDUINOJSON_STRING_POOL_INDEX 1
+#define BENCHMARK_PARSE parseWithIndex
+#include "string_pool.hpp"
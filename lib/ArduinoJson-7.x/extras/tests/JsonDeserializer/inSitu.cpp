@@ -0,0 +1,141 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2025, Benoit BLANCHON
+// MIT License
+
+#include <ArduinoJson.h>
+
+#include <catch.hpp>
+#include <string.h>
+#include <string>
+
+#include "Allocators.hpp"
+
+using ArduinoJson::detail::sizeofObject;
+
+static bool isIn(const char* s, const char* buffer, size_t size) {
+  return s >= buffer && s < buffer + size;
+}
+
+TEST_CASE("deserializeJsonInSitu()") {
+  JsonDocument doc;
+
+  SECTION("links the strings to the buffer") {
+    char input[] = "{\"id\":\"1718000000123\",\"type\":\"test\"}";
+
+    auto err = deserializeJsonInSitu(doc, input);
+
+    REQUIRE(err == DeserializationError::Ok);
+    REQUIRE(doc["id"] == "1718000000123");
+    REQUIRE(doc["type"] == "test");
+    REQUIRE(isIn(doc["id"].as<const char*>(), input, sizeof(input)));
+    REQUIRE(isIn(doc["type"].as<const char*>(), input, sizeof(input)));
+    JsonString key = doc.as<JsonObject>().begin()->key();
+    REQUIRE(isIn(key.c_str(), input, sizeof(input)));
+  }
+
+  SECTION("unescapes the strings in place") {
+    char input[] =
+        "[\"a\\nb\",\"\\u00e9t\\u00e9\",'it\\'s',\"x\\\"y\",\"\\ud83d\\ude00\","
+        "\"\\\\\",\"'\",'\"']";
+
+    auto err = deserializeJsonInSitu(doc, input);
+
+    REQUIRE(err == DeserializationError::Ok);
+    REQUIRE(doc[0] == "a\nb");
+    REQUIRE(doc[1] == "\xC3\xA9t\xC3\xA9");
+    REQUIRE(doc[2] == "it's");
+    REQUIRE(doc[3] == "x\"y");
+    REQUIRE(doc[4] == "\xF0\x9F\x98\x80");
+    REQUIRE(doc[5] == "\\");
+    REQUIRE(doc[6] == "'");
+    REQUIRE(doc[7] == "\"");
+    for (size_t i = 0; i < 8; i++)
+      REQUIRE(isIn(doc[i].as<const char*>(), input, sizeof(input)));
+  }
+
+  SECTION("gives the same document as deserializeJson()") {
+    const char* json =
+        "{\"gw\":\"gw-01\",\"frames\":[{\"node\":\"n\\/1\",\"rssi\":-97,"
+        "\"snr\":9.5,\"ok\":true,\"data\":null,key:\"AQID\"}]}";
+    std::string buffer(json);
+
+    JsonDocument expected;
+    REQUIRE(deserializeJson(expected, json) == DeserializationError::Ok);
+    REQUIRE(deserializeJsonInSitu(doc, &buffer[0]) == DeserializationError::Ok);
+
+    std::string a, b;
+    serializeJson(doc, a);
+    serializeJson(expected, b);
+    REQUIRE(a == b);
+  }
+
+  SECTION("copies the strings that contain NUL") {
+    char input[] = "[\"a\\u0000b\"]";
+
+    REQUIRE(deserializeJsonInSitu(doc, input) == DeserializationError::Ok);
+
+    JsonString s = doc[0];
+    REQUIRE(s.size() == 3);
+    REQUIRE(memcmp(s.c_str(), "a\0b", 3) == 0);
+    REQUIRE_FALSE(isIn(s.c_str(), input, sizeof(input)));
+  }
+
+  SECTION("reads a buffer of a given size") {
+    char input[] = "[\"abc\"]\"def\"";
+
+    REQUIRE(deserializeJsonInSitu(doc, input, 7) == DeserializationError::Ok);
+    REQUIRE(doc[0] == "abc");
+  }
+
+  SECTION("stops at the end of the buffer") {
+    char input[] = "[\"abc\"]";
+
+    REQUIRE(deserializeJsonInSitu(doc, input, 5) ==
+            DeserializationError::IncompleteInput);
+  }
+
+  SECTION("supports the options") {
+    char input[] = "{\"a\":\"x\",\"b\":[\"y\"],\"c\":[[1]]}";
+    JsonDocument filter;
+    filter["a"] = true;
+    filter["c"] = true;
+
+    auto err = deserializeJsonInSitu(doc, input,
+                                     DeserializationOption::Filter(filter),
+                                     DeserializationOption::NestingLimit(3));
+
+    REQUIRE(err == DeserializationError::Ok);
+    REQUIRE(doc.as<std::string>() == "{\"a\":\"x\",\"c\":[[1]]}");
+  }
+
+  SECTION("reports errors") {
+    char incomplete[] = "[\"abc";
+    char invalid[] = "[\"\\x\"]";
+    char badHex[] = "[\"\\u00G0\"]";
+    char incompleteEscape[] = "[\"\\";
+
+    REQUIRE(deserializeJsonInSitu(doc, incomplete) ==
+            DeserializationError::IncompleteInput);
+    REQUIRE(deserializeJsonInSitu(doc, invalid) ==
+            DeserializationError::InvalidInput);
+    REQUIRE(deserializeJsonInSitu(doc, badHex) ==
+            DeserializationError::InvalidInput);
+    REQUIRE(deserializeJsonInSitu(doc, incompleteEscape) ==
+            DeserializationError::IncompleteInput);
+  }
+}
+
+TEST_CASE("deserializeJsonInSitu() memory") {
+  SpyingAllocator spy;
+  JsonDocument doc(&spy);
+
+  SECTION("allocates no string") {
+    char input[] = "{\"hello\":\"world\",\"escaped\":\"a\\tb\"}";
+
+    REQUIRE(deserializeJsonInSitu(doc, input) == DeserializationError::Ok);
+    REQUIRE(spy.log() == AllocatorLog{
+                             Allocate(sizeofPool()),
+                             Reallocate(sizeofPool(), sizeofObject(2)),
+                         });
+  }
+}
@@ -0,0 +1,188 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2025, Benoit BLANCHON
+// MIT License
+
+#define ARDUINOJSON_ENABLE_COMMENTS 1
+#include <ArduinoJson.h>
+
+#include <catch.hpp>
+#include <string>
+
+#include "Allocators.hpp"
+
+static std::string toJson(const JsonDocument& doc) {
+  std::string json;
+  serializeJson(doc, json);
+  return json;
+}
+
+// Feeds the input in two pieces, split at each position, and compares with
+// deserializeJson(); the content of the document is unspecified on error
+static void checkAllSplits(const std::string& input) {
+  JsonDocument expected;
+  DeserializationError expectedError = deserializeJson(expected, input);
+
+  for (size_t i = 0; i <= input.size(); i++) {
+    CAPTURE(input.substr(0, i));
+    JsonDocument doc;
+    JsonIncrementalDeserializer parser(doc);
+    parser.feed(input.c_str(), i);
+    parser.feed(input.c_str() + i, input.size() - i);
+
+    REQUIRE(parser.finish() == expectedError);
+    if (!expectedError)
+      REQUIRE(toJson(doc) == toJson(expected));
+  }
+}
+
+TEST_CASE("JsonIncrementalDeserializer") {
+  JsonDocument doc;
+  JsonIncrementalDeserializer parser(doc);
+
+  SECTION("gives the same result wherever the input is split") {
+    const char* inputs[] = {
+        "{\"a\":[1,-2,1.5,\"x\",true,false,null],\"b\":{},\"c\":[]}",
+        " [ 1 , [ 2 , { \"k\" : \"v\" } ] , 3 ] ",
+        "{\"data\":{\"serverTime\":\"1718000000123\"}}",
+        "{\"id\":\"node-7\",\"temp\":23.45,\"rssi\":-97,\"snr\":9.5}",
+        "[\"a\\nb\",\"\\u00e9\",'it\\'s',\"x\\\"y\",\"\\ud83d\\ude00\"]",
+        "{key:1,other_key:[true]}",
+        "{\"a\":1,\"a\":2}",
+        "[1 /* one */, 2 // two\n]",
+        "\"hello\"",
+        "true",
+        "42",
+        "-1.5e3",
+        "[1,2]garbage",
+        "[1 2]",
+        "{\"a\" 1}",
+        "[tru]",
+        "1.5x",
+        "[\"\\x\"]",
+        "[1,",
+        "",
+    };
+    for (auto input : inputs)
+      checkAllSplits(input);
+  }
+
+  SECTION("accepts one character at a time") {
+    std::string input =
+        "{\"gw\":\"gw-01\",\"frames\":[{\"rssi\":-97,\"data\":\"\\u0041B\"}]}";
+
+    for (size_t i = 0; i < input.size() - 1; i++)
+      REQUIRE(parser.feed(&input[i], 1) ==
+              DeserializationError::IncompleteInput);
+    REQUIRE(parser.feed(&input.back(), 1) == DeserializationError::Ok);
+
+    REQUIRE(toJson(doc) ==
+            "{\"gw\":\"gw-01\",\"frames\":[{\"rssi\":-97,\"data\":\"AB\"}]}");
+  }
+
+  SECTION("returns IncompleteInput until the value is complete") {
+    REQUIRE(parser.feed("{\"temp\":") == DeserializationError::IncompleteInput);
+    REQUIRE(parser.feed("23.5") == DeserializationError::IncompleteInput);
+    REQUIRE(parser.feed("}") == DeserializationError::Ok);
+    REQUIRE(doc["temp"] == 23.5);
+  }
+
+  SECTION("needs finish() to complete a number at the root") {
+    REQUIRE(parser.feed("42") == DeserializationError::IncompleteInput);
+    REQUIRE(parser.feed("0") == DeserializationError::IncompleteInput);
+    REQUIRE(parser.finish() == DeserializationError::Ok);
+    REQUIRE(doc.as<int>() == 420);
+  }
+
+  SECTION("stops at the NUL terminator") {
+    REQUIRE(parser.feed("42", 3) == DeserializationError::Ok);
+    REQUIRE(doc.as<int>() == 42);
+  }
+
+  SECTION("ignores what follows the value") {
+    REQUIRE(parser.feed("[1]") == DeserializationError::Ok);
+    REQUIRE(parser.feed("[2]") == DeserializationError::Ok);
+    REQUIRE(parser.finish() == DeserializationError::Ok);
+    REQUIRE(toJson(doc) == "[1]");
+  }
+
+  SECTION("keeps the first error") {
+    REQUIRE(parser.feed("[1 2") == DeserializationError::InvalidInput);
+    REQUIRE(parser.feed("]") == DeserializationError::InvalidInput);
+    REQUIRE(parser.finish() == DeserializationError::InvalidInput);
+  }
+
+  SECTION("finish() reports missing input") {
+    SECTION("nothing") {
+      REQUIRE(parser.finish() == DeserializationError::EmptyInput);
+    }
+
+    SECTION("spaces") {
+      parser.feed("  ");
+      REQUIRE(parser.finish() == DeserializationError::EmptyInput);
+    }
+
+    SECTION("unfinished array") {
+      parser.feed("[1,");
+      REQUIRE(parser.finish() == DeserializationError::IncompleteInput);
+      REQUIRE(parser.feed("2]") == DeserializationError::IncompleteInput);
+    }
+  }
+
+  SECTION("clears the document") {
+    doc["hello"] = "world";
+    JsonIncrementalDeserializer other(doc);
+    REQUIRE(doc.isNull());
+  }
+}
+
+TEST_CASE("JsonIncrementalDeserializer nesting") {
+  JsonDocument doc;
+
+  SECTION("respects the nesting limit") {
+    JsonIncrementalDeserializer parser(doc,
+                                       DeserializationOption::NestingLimit(2));
+    REQUIRE(parser.feed("[[[]]]") == DeserializationError::TooDeep);
+  }
+
+  SECTION("accepts the nesting limit") {
+    JsonIncrementalDeserializer parser(doc,
+                                       DeserializationOption::NestingLimit(2));
+    REQUIRE(parser.feed("[[]]") == DeserializationError::Ok);
+  }
+
+  SECTION("can't go deeper than ARDUINOJSON_DEFAULT_NESTING_LIMIT") {
+    std::string input(ARDUINOJSON_DEFAULT_NESTING_LIMIT + 1, '[');
+    JsonIncrementalDeserializer parser(doc,
+                                       DeserializationOption::NestingLimit(50));
+    REQUIRE(parser.feed(input.c_str()) == DeserializationError::TooDeep);
+  }
+}
+
+TEST_CASE("JsonIncrementalDeserializer memory") {
+  SpyingAllocator spy;
+
+  SECTION("allocates like deserializeJson() when fed at once") {
+    std::string input =
+        "{\"gateway\":\"gw-01\",\"frames\":[{\"node\":\"n-1\",\"rssi\":-97},"
+        "{\"node\":\"n-2\",\"rssi\":-101,\"payload\":\"a long payload, "
+        "longer than the initial string buffer\"}]}";
+
+    SpyingAllocator expectedSpy;
+    JsonDocument expected(&expectedSpy);
+    REQUIRE(deserializeJson(expected, input.c_str()) ==
+            DeserializationError::Ok);
+
+    JsonDocument doc(&spy);
+    JsonIncrementalDeserializer parser(doc);
+
+    REQUIRE(parser.feed(input.c_str()) == DeserializationError::Ok);
+    REQUIRE(spy.log() == expectedSpy.log());
+  }
+
+  SECTION("reports allocation failures") {
+    JsonDocument doc(FailingAllocator::instance());
+    JsonIncrementalDeserializer parser(doc);
+
+    REQUIRE(parser.feed("[1]") == DeserializationError::NoMemory);
+  }
+}
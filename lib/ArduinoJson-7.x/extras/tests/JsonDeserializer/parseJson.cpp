@@ -0,0 +1,277 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2025, Benoit BLANCHON
+// MIT License
+
+#include <ArduinoJson.h>
+
+#include <catch.hpp>
+#include <sstream>
+#include <string>
+
+#include "Allocators.hpp"
+
+// Writes the events in a string, and stops after stopAfter of them
+class EventLog : public JsonHandler {
+ public:
+  std::string events;
+  int stopAfter = -1;
+
+  bool startObject() {
+    return add("{");
+  }
+
+  bool endObject() {
+    return add("}");
+  }
+
+  bool startArray() {
+    return add("[");
+  }
+
+  bool endArray() {
+    return add("]");
+  }
+
+  bool key(JsonString s) {
+    return add("key:" + std::string(s.c_str(), s.size()));
+  }
+
+  bool string(JsonString s) {
+    return add("str:" + std::string(s.c_str(), s.size()));
+  }
+
+  bool integer(JsonInteger i) {
+    return add("int:" + std::to_string(i));
+  }
+
+  bool unsignedInteger(JsonUInt i) {
+    return add("uint:" + std::to_string(i));
+  }
+
+  bool floatingPoint(JsonFloat f) {
+    std::ostringstream s;
+    s << "float:" << f;
+    return add(s.str());
+  }
+
+  bool boolean(bool b) {
+    return add(b ? "true" : "false");
+  }
+
+  bool null() {
+    return add("null");
+  }
+
+ private:
+  bool add(const std::string& event) {
+    if (!events.empty())
+      events += ' ';
+    events += event;
+    return --stopAfter != 0;
+  }
+};
+
+// Skips the values of the keys that start with an underscore
+class SkippingLog : public EventLog {
+ public:
+  bool key(JsonString s) {
+    skip_ = s.size() > 0 && s.c_str()[0] == '_';
+    return EventLog::key(s);
+  }
+
+  bool skipValue() {
+    bool skip = skip_;
+    skip_ = false;
+    return skip;
+  }
+
+ private:
+  bool skip_ = false;
+};
+
+// Only looks at the strings
+class StringSpy : public JsonHandler {
+ public:
+  const char* input;
+  size_t inputSize;
+  int views = 0;
+  int copies = 0;
+
+  bool string(JsonString s) {
+    if (s.c_str() >= input && s.c_str() < input + inputSize)
+      views++;
+    else
+      copies++;
+    return true;
+  }
+};
+
+static std::string makeArray(int count, const char* element) {
+  std::string json = "[";
+  for (int i = 0; i < count; i++) {
+    if (i)
+      json += ',';
+    json += element;
+  }
+  return json + "]";
+}
+
+TEST_CASE("parseJson()") {
+  EventLog log;
+
+  SECTION("calls the handler for each token") {
+    auto err = parseJson(
+        "{\"a\":[1,-2,1.5,\"x\",true,false,null],\"b\":{},\"c\":[]}", log);
+
+    REQUIRE(err == DeserializationError::Ok);
+    REQUIRE(log.events ==
+            "{ key:a [ uint:1 int:-2 float:1.5 str:x true false null ] "
+            "key:b { } key:c [ ] }");
+  }
+
+  SECTION("values at the root") {
+    REQUIRE(parseJson("42", log) == DeserializationError::Ok);
+    REQUIRE(parseJson(" 'hello' ", log) == DeserializationError::Ok);
+    REQUIRE(parseJson("null", log) == DeserializationError::Ok);
+    REQUIRE(log.events == "uint:42 str:hello null");
+  }
+
+  SECTION("passes floats at the precision of JsonFloat") {
+    struct : JsonHandler {
+      JsonFloat value = 0;
+      bool floatingPoint(JsonFloat f) {
+        value = f;
+        return true;
+      }
+    } handler;
+
+    // 1.7e12 fits in a float, but only to 2^17
+    REQUIRE(parseJson("1.7e12", handler) == DeserializationError::Ok);
+    REQUIRE(handler.value == 1.7e12);
+    REQUIRE(parseJson("0.1", handler) == DeserializationError::Ok);
+    REQUIRE(handler.value == 0.1);
+  }
+
+  SECTION("decodes escape sequences") {
+    auto err = parseJson("[\"a\\nb\",\"\\u00e9\",'it\\'s',\"x\\\"y\"]", log);
+
+    REQUIRE(err == DeserializationError::Ok);
+    REQUIRE(log.events == "[ str:a\nb str:\xC3\xA9 str:it's str:x\"y ]");
+  }
+
+  SECTION("keys without quotes") {
+    REQUIRE(parseJson("{key:1}", log) == DeserializationError::Ok);
+    REQUIRE(log.events == "{ key:key uint:1 }");
+  }
+
+  SECTION("reads streams") {
+    std::istringstream s("{\"data\":{\"serverTime\":\"1718000000123\"}}");
+
+    REQUIRE(parseJson(s, log) == DeserializationError::Ok);
+    REQUIRE(log.events == "{ key:data { key:serverTime str:1718000000123 } }");
+  }
+
+  SECTION("reads a buffer of a given size") {
+    char input[] = "[1,2]garbage";
+
+    REQUIRE(parseJson(input, 5, log) == DeserializationError::Ok);
+    REQUIRE(log.events == "[ uint:1 uint:2 ]");
+  }
+
+  SECTION("stops when the handler returns false") {
+    log.stopAfter = 3;
+
+    auto err = parseJson("{\"a\":1,\"b\":2} this isn't parsed", log);
+
+    REQUIRE(err == DeserializationError::Ok);
+    REQUIRE(log.events == "{ key:a uint:1");
+  }
+
+  SECTION("skips the values the handler doesn't want") {
+    SkippingLog skipping;
+
+    auto err = parseJson(
+        "{\"_a\":[1,{\"b\":2}],\"c\":3,\"_d\":\"x\\ny\",\"e\":[4]}",
+        skipping);
+
+    REQUIRE(err == DeserializationError::Ok);
+    REQUIRE(skipping.events ==
+            "{ key:_a key:c uint:3 key:_d key:e [ uint:4 ] }");
+  }
+
+  SECTION("reports errors after the events of the valid part") {
+    REQUIRE(parseJson("[1,", log) == DeserializationError::IncompleteInput);
+    REQUIRE(log.events == "[ uint:1");
+    REQUIRE(parseJson("", log) == DeserializationError::EmptyInput);
+    REQUIRE(parseJson("[1 2]", log) == DeserializationError::InvalidInput);
+    REQUIRE(parseJson("{\"a\" 1}", log) ==
+            DeserializationError::InvalidInput);
+    REQUIRE(parseJson("\"abc", log) == DeserializationError::IncompleteInput);
+    REQUIRE(parseJson("[tru]", log) == DeserializationError::InvalidInput);
+    REQUIRE(parseJson("1.5x", log) == DeserializationError::InvalidInput);
+  }
+
+  SECTION("respects the nesting limit") {
+    REQUIRE(parseJson("[[[]]]", log, DeserializationOption::NestingLimit(2)) ==
+            DeserializationError::TooDeep);
+    REQUIRE(parseJson("[[]]", log, DeserializationOption::NestingLimit(2)) ==
+            DeserializationError::Ok);
+  }
+}
+
+TEST_CASE("parseJson() memory") {
+  SpyingAllocator spy;
+  StringSpy handler;
+
+  SECTION("passes the strings without escapes as views of the input") {
+    std::string json = makeArray(100, "\"hello\"");
+    handler.input = json.c_str();
+    handler.inputSize = json.size();
+
+    REQUIRE(parseJson(json.c_str(), handler, {}, &spy) ==
+            DeserializationError::Ok);
+    REQUIRE(handler.views == 100);
+    REQUIRE(handler.copies == 0);
+    REQUIRE(spy.log() == AllocatorLog{});
+  }
+
+  SECTION("copies the strings with escapes in one buffer") {
+    std::string small = makeArray(10, "\"hello\\nworld\"");
+    std::string large = makeArray(1000, "\"hello\\nworld\"");
+    handler.input = large.c_str();
+    handler.inputSize = large.size();
+
+    REQUIRE(parseJson(large.c_str(), handler, {}, &spy) ==
+            DeserializationError::Ok);
+    REQUIRE(handler.copies == 1000);
+    AllocatorLog expected{
+        Allocate(sizeofStringBuffer()),
+        Deallocate(sizeofStringBuffer()),
+    };
+    REQUIRE(spy.log() == expected);
+
+    spy.clearLog();
+    REQUIRE(parseJson(small.c_str(), handler, {}, &spy) ==
+            DeserializationError::Ok);
+    REQUIRE(spy.log() == expected);
+  }
+
+  SECTION("copies the strings of streams") {
+    std::istringstream s(makeArray(1000, "\"hello\""));
+    handler.input = nullptr;
+    handler.inputSize = 0;
+
+    REQUIRE(parseJson(s, handler, {}, &spy) == DeserializationError::Ok);
+    REQUIRE(handler.copies == 1000);
+    REQUIRE(spy.log() == AllocatorLog{
+                             Allocate(sizeofStringBuffer()),
+                             Deallocate(sizeofStringBuffer()),
+                         });
+  }
+
+  SECTION("reports allocation failures") {
+    REQUIRE(parseJson("[\"a\\nb\"]", handler, {},
+                      FailingAllocator::instance()) ==
+            DeserializationError::NoMemory);
+  }
+}
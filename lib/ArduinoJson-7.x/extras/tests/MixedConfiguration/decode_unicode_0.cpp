@@ -5,8 +5,19 @@
 
 TEST_CASE("ARDUINOJSON_DECODE_UNICODE == 0") {
   JsonDocument doc;
-  DeserializationError err = deserializeJson(doc, "\"\\uD834\\uDD1E\"");
 
-  REQUIRE(err == DeserializationError::Ok);
-  REQUIRE(doc.as<std::string>() == "\\uD834\\uDD1E");
+  SECTION("deserializeJson()") {
+    DeserializationError err = deserializeJson(doc, "\"\\uD834\\uDD1E\"");
+
+    REQUIRE(err == DeserializationError::Ok);
+    REQUIRE(doc.as<std::string>() == "\\uD834\\uDD1E");
+  }
+
+  SECTION("deserializeJsonInSitu()") {
+    char input[] = "\"\\uD834\\uDD1E\"";
+    DeserializationError err = deserializeJsonInSitu(doc, input);
+
+    REQUIRE(err == DeserializationError::Ok);
+    REQUIRE(doc.as<std::string>() == "\\uD834\\uDD1E");
+  }
 }
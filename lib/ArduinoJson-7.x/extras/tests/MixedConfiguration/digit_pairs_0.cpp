@@ -0,0 +1,71 @@
+#define ARDUINOJSON_DIGIT_PAIRS 0
+#include <ArduinoJson.h>
+
+#include <catch.hpp>
+#include <stdint.h>
+#include <string>
+
+template <typename T>
+static std::string serialize(T value) {
+  JsonDocument doc;
+  doc.set(value);
+  std::string json;
+  serializeJson(doc, json);
+  return json;
+}
+
+TEST_CASE("ARDUINOJSON_DIGIT_PAIRS == 0") {
+  SECTION("writes every digit count") {
+    uint64_t power = 1;
+    for (int i = 0; i < 20; i++) {
+      REQUIRE(serialize(power) == std::to_string(power));
+      REQUIRE(serialize(power - 1) == std::to_string(power - 1));
+      REQUIRE(serialize(power + 1) == std::to_string(power + 1));
+      REQUIRE(serialize(power * 7 + 3) == std::to_string(power * 7 + 3));
+      power *= 10;
+    }
+  }
+
+  SECTION("writes small values") {
+    for (int i = -1000; i <= 1000; i++)
+      REQUIRE(serialize(i) == std::to_string(i));
+  }
+
+  SECTION("writes the limits") {
+    REQUIRE(serialize(UINT32_MAX) == "4294967295");
+    REQUIRE(serialize(uint64_t(UINT32_MAX) + 1) == "4294967296");
+    REQUIRE(serialize(INT32_MIN) == "-2147483648");
+    REQUIRE(serialize(UINT64_MAX) == "18446744073709551615");
+    REQUIRE(serialize(INT64_MAX) == "9223372036854775807");
+    REQUIRE(serialize(INT64_MIN) == "-9223372036854775808");
+  }
+
+  SECTION("writes groups of 8 digits with their zeros") {
+    REQUIRE(serialize(uint64_t(100000000000000000)) == "100000000000000000");
+    REQUIRE(serialize(uint64_t(4294967296000000001)) ==
+            "4294967296000000001");
+    REQUIRE(serialize(uint64_t(12300000004560000789U)) ==
+            "12300000004560000789");
+  }
+
+  SECTION("writes the decimals of floats with their zeros") {
+    REQUIRE(serialize(1.5) == "1.5");
+    REQUIRE(serialize(3.14159265) == "3.14159265");
+    REQUIRE(serialize(1.000000001) == "1.000000001");
+    REQUIRE(serialize(1.05f) == "1.05");
+    REQUIRE(serialize(1e-7) == "1e-7");
+    REQUIRE(serialize(1.25e15) == "1.25e15");
+  }
+
+  SECTION("writes timestamps and ids") {
+    JsonDocument doc;
+    doc["date"] = 1718000000123ULL;
+    doc["id"] = 3735928559U;
+    doc["rssi"] = -87;
+
+    std::string json;
+    serializeJson(doc, json);
+
+    REQUIRE(json == "{\"date\":1718000000123,\"id\":3735928559,\"rssi\":-87}");
+  }
+}
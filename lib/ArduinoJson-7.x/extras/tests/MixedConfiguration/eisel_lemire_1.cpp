@@ -0,0 +1,144 @@
+#define ARDUINOJSON_EISEL_LEMIRE 1
+#include <ArduinoJson.h>
+
+#include <catch.hpp>
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+using ArduinoJson::detail::Number;
+using ArduinoJson::detail::NumberType;
+using ArduinoJson::detail::parseNumber;
+
+template <typename T>
+static bool sameBits(T a, T b) {
+  return memcmp(&a, &b, sizeof(T)) == 0;
+}
+
+// Compares with the C library, which rounds correctly
+static bool matchesStrtod(const std::string& s) {
+  Number number = parseNumber(s.c_str());
+  switch (number.type()) {
+    case NumberType::Float:
+      return sameBits(number.asFloat(), strtof(s.c_str(), nullptr));
+    case NumberType::Double:
+      return sameBits(number.asDouble(), strtod(s.c_str(), nullptr));
+    default:
+      return false;
+  }
+}
+
+// A number with 1 to 19 digits, a decimal point somewhere, maybe an exponent
+static std::string randomDecimal(std::mt19937_64& rng) {
+  int digits = int(rng() % 19) + 1;
+  int point = int(rng() % unsigned(digits));
+  std::string s;
+  if (rng() % 2)
+    s += '-';
+  for (int i = 0; i < digits; i++) {
+    if (i == point)
+      s += '.';
+    s += char('0' + (i ? rng() % 10 : rng() % 9 + 1));
+  }
+  if (rng() % 2)
+    s += "e" + std::to_string(int(rng() % 61) - 30);
+  return s;
+}
+
+TEST_CASE("ARDUINOJSON_EISEL_LEMIRE == 1") {
+  SECTION("rounds random decimals like strtod()") {
+    std::mt19937_64 rng(42);
+    for (int i = 0; i < 100000; i++) {
+      std::string s = randomDecimal(rng);
+      if (!matchesStrtod(s)) {
+        CAPTURE(s);
+        REQUIRE(matchesStrtod(s));
+      }
+    }
+  }
+
+  SECTION("round-trips random doubles") {
+    std::mt19937_64 rng(7);
+    std::uniform_real_distribution<double> mantissa(1.0, 10.0);
+    for (int i = 0; i < 100000; i++) {
+      double value = ldexp(mantissa(rng), int(rng() % 300) - 150);
+      char s[32];
+      snprintf(s, sizeof(s), "%.16e", value);
+      CAPTURE(s);
+      Number number = parseNumber(s);
+      if (number.type() == NumberType::Double)
+        REQUIRE(sameBits(number.asDouble(), value));
+      else
+        REQUIRE(matchesStrtod(s));
+    }
+  }
+
+  SECTION("rounds halfway cases to even") {
+    // between 9007199254740992 and 9007199254740994
+    REQUIRE(parseNumber<double>("9007199254740993.0") == 9007199254740992.0);
+    REQUIRE(parseNumber<double>("9007199254740995.0") == 9007199254740996.0);
+    // between 33554448 and 33554452
+    REQUIRE(parseNumber("3355445e1").type() == NumberType::Float);
+    REQUIRE(parseNumber("3355445e1").asFloat() == 33554448.0f);
+    REQUIRE(matchesStrtod("3355445e1"));
+  }
+
+  SECTION("rounds common telemetry values") {
+    REQUIRE(matchesStrtod("0.1"));
+    REQUIRE(matchesStrtod("23.456"));
+    REQUIRE(matchesStrtod("-0.000123"));
+    REQUIRE(matchesStrtod("18.48612345"));
+    REQUIRE(matchesStrtod("-69.93123456789"));
+    REQUIRE(matchesStrtod("1013.25"));
+    REQUIRE(matchesStrtod("0.30000000000000004"));
+    REQUIRE(matchesStrtod("1.7976931348623157e10"));
+  }
+
+  SECTION("produces the same types as without") {
+    REQUIRE(parseNumber("42").type() == NumberType::UnsignedInteger);
+    REQUIRE(parseNumber("42").asUnsignedInteger() == 42);
+    REQUIRE(parseNumber("-42").asSignedInteger() == -42);
+    REQUIRE(parseNumber("-9223372036854775808").asSignedInteger() ==
+            INT64_MIN);
+    REQUIRE(parseNumber("18446744073709551615").asUnsignedInteger() ==
+            UINT64_MAX);
+    REQUIRE(parseNumber("-9223372036854775809").type() == NumberType::Double);
+    REQUIRE(parseNumber("1.5").type() == NumberType::Float);
+    REQUIRE(parseNumber("1e3").type() == NumberType::Float);
+    REQUIRE(parseNumber("3.14159265").type() == NumberType::Double);
+    REQUIRE(parseNumber("1e39").type() == NumberType::Double);
+    REQUIRE(parseNumber("-0.0").type() == NumberType::Float);
+    REQUIRE(sameBits(parseNumber("-0.0").asFloat(), -0.0f));
+  }
+
+  SECTION("falls back outside of the table") {
+    REQUIRE(parseNumber<double>("1e100") == Approx(1e100));
+    REQUIRE(parseNumber<double>("1.5e-200") == Approx(1.5e-200));
+    REQUIRE(parseNumber<double>("1e400") == INFINITY);
+    REQUIRE(parseNumber<double>("1e-400") == 0.0);
+    REQUIRE(parseNumber<double>("12345678901234567890123.5") ==
+            Approx(12345678901234567890123.5));
+    REQUIRE(parseNumber<double>("0.00000000000000000000001234") ==
+            Approx(1.234e-23));
+  }
+
+  SECTION("rejects invalid numbers") {
+    REQUIRE(parseNumber("1.5x").type() == NumberType::Invalid);
+    REQUIRE(parseNumber("-").type() == NumberType::Invalid);
+    REQUIRE(parseNumber("1e5.5").type() == NumberType::Invalid);
+    REQUIRE(parseNumber("1..5").type() == NumberType::Invalid);
+  }
+
+  SECTION("deserializeJson()") {
+    JsonDocument doc;
+    deserializeJson(doc, "[0.1,23.456,-1.25e-5,1234567.875,42]");
+
+    REQUIRE(doc[0].as<float>() == 0.1f);
+    REQUIRE(doc[1].as<float>() == 23.456f);
+    REQUIRE(doc[2].as<float>() == -1.25e-5f);
+    REQUIRE(doc[3].as<double>() == 1234567.875);
+    REQUIRE(doc[4].as<int>() == 42);
+  }
+}
@@ -0,0 +1,90 @@
+#define ARDUINOJSON_ENABLE_SIMD 1
+#include <ArduinoJson.h>
+
+#include <catch.hpp>
+#include <string>
+
+// Parses json as a NUL-terminated string and as a buffer of known size
+static std::string roundTrip(const std::string& json) {
+  JsonDocument doc1, doc2;
+  auto err1 = deserializeJson(doc1, json.c_str());
+  auto err2 = deserializeJson(doc2, json.data(), json.size());
+  REQUIRE(err1 == err2);
+  REQUIRE(doc1 == doc2);
+  if (err1)
+    return err1.c_str();
+  std::string result;
+  serializeJson(doc1, result);
+  return result;
+}
+
+TEST_CASE("ARDUINOJSON_ENABLE_SIMD == 1") {
+  SECTION("strings of every length around the block sizes") {
+    for (size_t n = 0; n < 70; n++) {
+      std::string s(n, 'x');
+      for (size_t i = 0; i < n; i++)
+        s[i] = char('a' + i % 26);
+      REQUIRE(roundTrip("\"" + s + "\"") == "\"" + s + "\"");
+    }
+  }
+
+  SECTION("escapes and quotes at every position") {
+    for (size_t i = 0; i < 40; i++) {
+      std::string before(i, 'a'), after(40 - i, 'b');
+      REQUIRE(roundTrip("\"" + before + "\\n" + after + "\"") ==
+              "\"" + before + "\\n" + after + "\"");
+      REQUIRE(roundTrip("\"" + before + "'" + after + "\"") ==
+              "\"" + before + "'" + after + "\"");
+      REQUIRE(roundTrip("'" + before + "\"" + after + "'") ==
+              "\"" + before + "\\\"" + after + "\"");
+    }
+  }
+
+  SECTION("keeps control characters and UTF-8") {
+    REQUIRE(roundTrip("[\"\x01\x1F\xC3\xA9\x7F\"]") ==
+            "[\"\x01\x1F\xC3\xA9\x7F\"]");
+  }
+
+  SECTION("whitespace runs of every length") {
+    for (size_t n = 0; n < 70; n++) {
+      std::string ws;
+      for (size_t i = 0; i < n; i++)
+        ws += " \t\r\n"[i % 4];
+      REQUIRE(roundTrip(ws + "{" + ws + "\"a\"" + ws + ":" + ws + "[" + ws +
+                        "1" + ws + "," + ws + "true" + ws + "]" + ws + "}" +
+                        ws) == "{\"a\":[1,true]}");
+    }
+  }
+
+  SECTION("stops at the end of the input") {
+    std::string longString(50, 'x');
+    REQUIRE(roundTrip("\"" + longString) == "IncompleteInput");
+    REQUIRE(roundTrip("\"" + longString + "\\") == "IncompleteInput");
+    REQUIRE(roundTrip(std::string(50, ' ')) == "EmptyInput");
+    REQUIRE(roundTrip("[" + std::string(50, ' ')) == "IncompleteInput");
+  }
+
+  SECTION("stops at NUL") {
+    std::string json = "\"" + std::string(20, 'x') + '\0' +
+                       std::string(20, 'y') + "\"";
+    JsonDocument doc;
+    REQUIRE(deserializeJson(doc, json.data(), json.size()) ==
+            DeserializationError::IncompleteInput);
+  }
+
+  SECTION("skips long strings filtered out") {
+    JsonDocument filter;
+    filter["b"] = true;
+    JsonDocument doc;
+    std::string json =
+        "{\"a\":\"" + std::string(100, 'x') + "\\\"\",\"b\":\"" +
+        std::string(100, 'y') + "\"}";
+
+    auto err = deserializeJson(doc, json.data(), json.size(),
+                               DeserializationOption::Filter(filter));
+
+    REQUIRE(err == DeserializationError::Ok);
+    REQUIRE(doc["a"].isNull());
+    REQUIRE(doc["b"] == std::string(100, 'y'));
+  }
+}
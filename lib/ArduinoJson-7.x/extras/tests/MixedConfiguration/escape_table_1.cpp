@@ -0,0 +1,51 @@
+#define ARDUINOJSON_ESCAPE_TABLE 1
+#include <ArduinoJson.h>
+
+#include <catch.hpp>
+#include <string>
+
+static std::string serialize(const std::string& value) {
+  JsonDocument doc;
+  doc.set(value);
+  std::string json;
+  serializeJson(doc, json);
+  return json;
+}
+
+TEST_CASE("ARDUINOJSON_ESCAPE_TABLE == 1") {
+  SECTION("writes clean strings as is") {
+    REQUIRE(serialize("hello world") == "\"hello world\"");
+    REQUIRE(serialize("") == "\"\"");
+  }
+
+  SECTION("escapes the special characters") {
+    REQUIRE(serialize("\"\\\b\f\n\r\t") == "\"\\\"\\\\\\b\\f\\n\\r\\t\"");
+  }
+
+  SECTION("escapes at both ends and between runs") {
+    REQUIRE(serialize("\nab\"cd\t") == "\"\\nab\\\"cd\\t\"");
+  }
+
+  SECTION("writes NUL as \\u0000") {
+    REQUIRE(serialize(std::string("a\0b", 3)) == "\"a\\u0000b\"");
+  }
+
+  SECTION("writes other characters as is") {
+    REQUIRE(serialize("\x01\x1F/'\x7F") == "\"\x01\x1F/'\x7F\"");
+    REQUIRE(serialize("caf\xC3\xA9") == "\"caf\xC3\xA9\"");
+  }
+
+  SECTION("writes keys like values") {
+    JsonDocument doc;
+    doc["a\tb"] = "c\nd";
+    std::string json;
+    serializeJson(doc, json);
+    REQUIRE(json == "{\"a\\tb\":\"c\\nd\"}");
+  }
+
+  SECTION("counts the escape sequences") {
+    JsonDocument doc;
+    doc.set("a\"b\\c");
+    REQUIRE(measureJson(doc) == 9);
+  }
+}
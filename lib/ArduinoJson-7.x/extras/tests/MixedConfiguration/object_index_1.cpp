@@ -0,0 +1,249 @@
+#define ARDUINOJSON_OBJECT_INDEX 1
+#include <ArduinoJson.h>
+
+#include <catch.hpp>
+#include <string>
+
+#include "Allocators.hpp"
+
+using ArduinoJson::detail::ObjectIndex;
+
+static std::string makeObject(int count) {
+  std::string json = "{";
+  for (int i = 0; i < count; i++) {
+    if (i)
+      json += ',';
+    json += "\"key" + std::to_string(i) + "\":" + std::to_string(i);
+  }
+  return json + "}";
+}
+
+static std::string key(int i) {
+  return "key" + std::to_string(i);
+}
+
+// Refuses blocks of one size, to make the index fail to grow
+class IndexLimitAllocator : public ArduinoJson::Allocator {
+ public:
+  IndexLimitAllocator(size_t refused) : refused_(refused) {}
+  virtual ~IndexLimitAllocator() {}
+
+  void* allocate(size_t n) override {
+    return n == refused_ ? nullptr : malloc(n);
+  }
+
+  void deallocate(void* p) override {
+    free(p);
+  }
+
+  void* reallocate(void* p, size_t n) override {
+    return realloc(p, n);
+  }
+
+ private:
+  size_t refused_;
+};
+
+TEST_CASE("ARDUINOJSON_OBJECT_INDEX == 1") {
+  SpyingAllocator spy;
+  JsonDocument doc(&spy);
+
+  SECTION("finds every member of a large object") {
+    auto error = deserializeJson(doc, makeObject(1000));
+
+    REQUIRE(error == DeserializationError::Ok);
+    REQUIRE(doc.size() == 1000);
+    for (int i = 0; i < 1000; i++)
+      REQUIRE(doc[key(i)] == i);
+    REQUIRE(doc["key1000"].isNull());
+  }
+
+  SECTION("keeps the last of duplicate keys") {
+    std::string json = makeObject(100);
+    json.back() = ',';
+    json += "\"key42\":-1,\"key99\":-2}";
+
+    deserializeJson(doc, json);
+
+    REQUIRE(doc.size() == 100);
+    REQUIRE(doc["key42"] == -1);
+    REQUIRE(doc["key99"] == -2);
+    REQUIRE(doc["key41"] == 41);
+  }
+
+  SECTION("doesn't index small objects") {
+    for (int i = 0; i < ARDUINOJSON_OBJECT_INDEX_THRESHOLD - 1; i++)
+      doc[key(i)] = i;
+    spy.clearLog();
+
+    REQUIRE(doc["missing"].isNull());
+    REQUIRE(spy.log() == AllocatorLog{});
+  }
+
+  SECTION("indexes the object once a lookup compares enough keys") {
+    for (int i = 0; i < ARDUINOJSON_OBJECT_INDEX_THRESHOLD; i++)
+      doc[key(i)] = i;
+    spy.clearLog();
+
+    REQUIRE(doc["missing"].isNull());
+    REQUIRE(spy.log() ==
+            AllocatorLog{
+                Allocate(4 * sizeof(ObjectIndex)),
+                Allocate(32 * sizeof(ObjectIndex::Entry)),
+            });
+
+    spy.clearLog();
+    REQUIRE(doc["key3"] == 3);
+    REQUIRE(spy.log() == AllocatorLog{});
+  }
+
+  SECTION("indexes the members added after the index") {
+    for (int i = 0; i < 20; i++)
+      doc[key(i)] = i;
+    REQUIRE(doc["missing"].isNull());
+
+    for (int i = 20; i < 100; i++)
+      doc[key(i)] = i;
+
+    REQUIRE(doc.size() == 100);
+    for (int i = 0; i < 100; i++)
+      REQUIRE(doc[key(i)] == i);
+  }
+
+  SECTION("forgets removed members") {
+    for (int i = 0; i < 100; i++)
+      doc[key(i)] = i;
+    for (int i = 0; i < 100; i += 2)
+      doc.remove(key(i));
+
+    REQUIRE(doc.size() == 50);
+    for (int i = 0; i < 100; i++)
+      REQUIRE(doc[key(i)].isNull() == (i % 2 == 0));
+
+    // the removed keys can be added again
+    for (int i = 0; i < 100; i += 2)
+      doc[key(i)] = -i;
+    REQUIRE(doc.size() == 100);
+    REQUIRE(doc["key42"] == -42);
+    REQUIRE(doc["key43"] == 43);
+  }
+
+  SECTION("removes the members from the end") {
+    deserializeJson(doc, makeObject(50));
+    REQUIRE(doc["missing"].isNull());
+
+    for (int i = 49; i >= 10; i--)
+      doc.remove(key(i));
+    for (int i = 50; i < 60; i++)
+      doc[key(i)] = i;
+
+    REQUIRE(doc.size() == 20);
+    REQUIRE(doc["key9"] == 9);
+    REQUIRE(doc["key10"].isNull());
+    REQUIRE(doc["key55"] == 55);
+  }
+
+  SECTION("removes members through iterators") {
+    JsonObject obj = doc.to<JsonObject>();
+    for (int i = 0; i < 50; i++)
+      obj[key(i)] = i;
+    REQUIRE(obj["missing"].isNull());
+
+    for (auto it = obj.begin(); it != obj.end(); ++it) {
+      if (it->value().as<int>() % 3 == 0)
+        obj.remove(it);
+    }
+
+    REQUIRE(obj.size() == 33);
+    for (int i = 0; i < 50; i++)
+      REQUIRE(obj[key(i)].isNull() == (i % 3 == 0));
+  }
+
+  SECTION("indexes nested objects separately") {
+    JsonArray array = doc.to<JsonArray>();
+    for (int i = 0; i < 10; i++) {
+      JsonObject obj = array.add<JsonObject>();
+      for (int j = 0; j < 30; j++)
+        obj[key(j)] = i * 100 + j;
+    }
+
+    for (int i = 0; i < 10; i++)
+      for (int j = 0; j < 30; j++)
+        REQUIRE(array[i][key(j)] == i * 100 + j);
+
+    // replaced objects lose their index
+    array.remove(3);
+    array[4] = 42;
+    array[5].to<JsonObject>()["hello"] = "world";
+
+    REQUIRE(array.size() == 9);
+    REQUIRE(array[3]["key7"] == 407);
+    REQUIRE(array[4] == 42);
+    REQUIRE(array[5]["key7"].isNull());
+    REQUIRE(array[5]["hello"] == "world");
+    REQUIRE(array[8]["key29"] == 929);
+  }
+
+  SECTION("finds members through JsonObjectConst") {
+    deserializeJson(doc, makeObject(100));
+    JsonObjectConst obj = doc.as<JsonObjectConst>();
+
+    for (int i = 0; i < 100; i++)
+      REQUIRE(obj[key(i)] == i);
+  }
+
+  SECTION("rebuilds the index after shrinkToFit()") {
+    for (int i = 0; i < 100; i++)
+      doc[key(i)] = i;
+    REQUIRE(doc["key50"] == 50);
+
+    doc.shrinkToFit();
+
+    for (int i = 0; i < 100; i++)
+      REQUIRE(doc[key(i)] == i);
+  }
+
+  SECTION("works after the document is moved") {
+    deserializeJson(doc, makeObject(100));
+    REQUIRE(doc["key50"] == 50);
+
+    JsonDocument doc2(std::move(doc));
+    doc.set(doc2);
+
+    for (int i = 0; i < 100; i++) {
+      REQUIRE(doc[key(i)] == i);
+      REQUIRE(doc2[key(i)] == i);
+    }
+  }
+
+  SECTION("releases the indexes on clear()") {
+    deserializeJson(doc, makeObject(100));
+    REQUIRE(doc["key50"] == 50);
+
+    doc.clear();
+
+    REQUIRE(spy.allocatedBytes() == 0);
+  }
+
+  SECTION("falls back to a scan when the index can't be allocated") {
+    IndexLimitAllocator limit(32 * sizeof(ObjectIndex::Entry));
+    JsonDocument doc2(&limit);
+
+    deserializeJson(doc2, makeObject(100));
+
+    REQUIRE(doc2.size() == 100);
+    for (int i = 0; i < 100; i++)
+      REQUIRE(doc2[key(i)] == i);
+  }
+
+  SECTION("falls back to a scan when the index can't grow") {
+    IndexLimitAllocator limit(64 * sizeof(ObjectIndex::Entry));
+    JsonDocument doc2(&limit);
+
+    deserializeJson(doc2, makeObject(100));
+
+    REQUIRE(doc2.size() == 100);
+    for (int i = 0; i < 100; i++)
+      REQUIRE(doc2[key(i)] == i);
+  }
+}
@@ -0,0 +1,175 @@
+#define ARDUINOJSON_SHORTEST_FLOAT 1
+#define ARDUINOJSON_ENABLE_NAN 1
+#define ARDUINOJSON_ENABLE_INFINITY 1
+#include <ArduinoJson.h>
+
+#include <catch.hpp>
+#include <limits>
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+using ArduinoJson::detail::TextFormatter;
+using ArduinoJson::detail::Writer;
+
+template <typename T>
+static std::string format(T value) {
+  std::string output;
+  Writer<std::string> sb(output);
+  TextFormatter<Writer<std::string>> writer(sb);
+  writer.writeFloat(value);
+  return output;
+}
+
+static double parse(const std::string& s, double) {
+  return strtod(s.c_str(), nullptr);
+}
+
+static float parse(const std::string& s, float) {
+  return strtof(s.c_str(), nullptr);
+}
+
+template <typename T>
+static bool sameBits(T a, T b) {
+  return memcmp(&a, &b, sizeof(T)) == 0;
+}
+
+// Number of digits of the shortest correctly rounded decimal that parses back
+// to value, found by trial with the C library. At a power of two, the gap to
+// the value below is half the gap above, so a decimal that isn't the closest
+// can be shorter.
+template <typename T>
+static int shortestDigits(T value) {
+  for (int precision = 0;; precision++) {
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), "%.*e", precision, double(value));
+    if (sameBits(parse(buffer, value), value))
+      return precision + 1;
+  }
+}
+
+static int countDigits(const std::string& s) {
+  std::string digits;
+  for (char c : s) {
+    if (c == 'e')
+      break;
+    if (c >= '0' && c <= '9')
+      digits += c;
+  }
+  size_t first = digits.find_first_not_of('0');
+  size_t last = digits.find_last_not_of('0');
+  if (first == std::string::npos)
+    return 1;
+  return int(last - first + 1);
+}
+
+template <typename T>
+static void checkShortest(T value) {
+  std::string s = format(value);
+  CAPTURE(s);
+  REQUIRE(sameBits(parse(s, value), value));
+  REQUIRE(countDigits(s) <= shortestDigits(value));
+}
+
+TEST_CASE("ARDUINOJSON_SHORTEST_FLOAT == 1") {
+  SECTION("writes the fewest digits") {
+    REQUIRE(format(0.1) == "0.1");
+    REQUIRE(format(0.1f) == "0.1");
+    REQUIRE(format(0.3) == "0.3");
+    REQUIRE(format(0.1 + 0.2) == "0.30000000000000004");
+    REQUIRE(format(23.45f) == "23.45");
+    REQUIRE(format(1013.25) == "1013.25");
+    REQUIRE(format(-69.93123456789) == "-69.93123456789");
+    REQUIRE(format(3.1415927f) == "3.1415927");
+    REQUIRE(format(1.0 / 3) == "0.3333333333333333");
+    REQUIRE(format(16777216.0f) == "1.6777216e7");
+    REQUIRE(format(std::numeric_limits<double>::max()) ==
+            "1.7976931348623157e308");
+    REQUIRE(format(std::numeric_limits<double>::denorm_min()) == "5e-324");
+    REQUIRE(format(std::numeric_limits<float>::max()) == "3.4028235e38");
+    REQUIRE(format(std::numeric_limits<float>::denorm_min()) == "1e-45");
+  }
+
+  SECTION("uses the same notation as without") {
+    REQUIRE(format(0.0) == "0");
+    REQUIRE(format(-0.0) == "0");
+    REQUIRE(format(42.0) == "42");
+    REQUIRE(format(-42.0f) == "-42");
+    REQUIRE(format(1200.0) == "1200");
+    REQUIRE(format(9999999.0) == "9999999");
+    REQUIRE(format(1e7) == "1e7");
+    REQUIRE(format(1.5e7) == "1.5e7");
+    REQUIRE(format(0.00012) == "0.00012");
+    REQUIRE(format(0.000012) == "0.000012");
+    REQUIRE(format(1e-5) == "1e-5");
+    REQUIRE(format(1.5e-6) == "1.5e-6");
+    REQUIRE(format(1e300) == "1e300");
+  }
+
+  SECTION("NaN and Infinity") {
+    REQUIRE(format(std::numeric_limits<double>::quiet_NaN()) == "NaN");
+    REQUIRE(format(std::numeric_limits<double>::infinity()) == "Infinity");
+    REQUIRE(format(-std::numeric_limits<float>::infinity()) == "-Infinity");
+  }
+
+  SECTION("powers of ten") {
+    for (int i = -307; i <= 308; i++)
+      checkShortest(strtod(("1e" + std::to_string(i)).c_str(), nullptr));
+    for (int i = -45; i <= 38; i++)
+      checkShortest(strtof(("1e" + std::to_string(i)).c_str(), nullptr));
+  }
+
+  SECTION("powers of two") {
+    for (int i = -1074; i <= 1023; i++)
+      checkShortest(ldexp(1.0, i));
+    for (int i = -149; i <= 127; i++)
+      checkShortest(ldexpf(1.0f, i));
+  }
+
+  SECTION("random doubles") {
+    std::mt19937_64 rng(42);
+    for (int i = 0; i < 100000; i++) {
+      uint64_t bits = rng() & 0x7FFFFFFFFFFFFFFF;
+      double value;
+      memcpy(&value, &bits, sizeof(value));
+      if (value != value || value == std::numeric_limits<double>::infinity())
+        continue;
+      checkShortest(value);
+    }
+  }
+
+  SECTION("random floats") {
+    std::mt19937 rng(42);
+    for (int i = 0; i < 100000; i++) {
+      uint32_t bits = rng() & 0x7FFFFFFF;
+      float value;
+      memcpy(&value, &bits, sizeof(value));
+      if (value != value || value == std::numeric_limits<float>::infinity())
+        continue;
+      checkShortest(value);
+    }
+  }
+
+  SECTION("readings with few decimals") {
+    for (int i = -10000; i <= 10000; i++) {
+      checkShortest(i / 100.0);
+      checkShortest(float(i) / 100.0f);
+      checkShortest(i / 1000.0);
+    }
+  }
+
+  SECTION("serializeJson()") {
+    JsonDocument doc;
+    doc.add(0.1);
+    doc.add(23.45f);
+    doc.add(1e-7);
+    doc.add(42);
+
+    std::string json;
+    serializeJson(doc, json);
+
+    REQUIRE(json == "[0.1,23.45,1e-7,42]");
+  }
+}
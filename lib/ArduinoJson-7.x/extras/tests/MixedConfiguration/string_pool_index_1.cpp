@@ -0,0 +1,144 @@
+#define ARDUINOJSON_STRING_POOL_INDEX 1
+#include <ArduinoJson.h>
+
+#include <catch.hpp>
+#include <string>
+
+#include "Allocators.hpp"
+
+static std::string makeObject(int count) {
+  std::string json = "{";
+  for (int i = 0; i < count; i++) {
+    if (i)
+      json += ',';
+    json += "\"key" + std::to_string(i) + "\":\"value" + std::to_string(i) +
+            "\"";
+  }
+  return json + "}";
+}
+
+// Refuses blocks of one size, to make the index fail to grow
+class IndexLimitAllocator : public ArduinoJson::Allocator {
+ public:
+  IndexLimitAllocator(size_t refused) : refused_(refused) {}
+  virtual ~IndexLimitAllocator() {}
+
+  void* allocate(size_t n) override {
+    return n == refused_ ? nullptr : malloc(n);
+  }
+
+  void deallocate(void* p) override {
+    free(p);
+  }
+
+  void* reallocate(void* p, size_t n) override {
+    return realloc(p, n);
+  }
+
+ private:
+  size_t refused_;
+};
+
+TEST_CASE("ARDUINOJSON_STRING_POOL_INDEX == 1") {
+  SpyingAllocator spy;
+  JsonDocument doc(&spy);
+
+  SECTION("finds every string of a large document") {
+    auto error = deserializeJson(doc, makeObject(1000));
+
+    REQUIRE(error == DeserializationError::Ok);
+    REQUIRE(doc.size() == 1000);
+    for (int i = 0; i < 1000; i++) {
+      std::string key = "key" + std::to_string(i);
+      REQUIRE(doc[key] == "value" + std::to_string(i));
+    }
+  }
+
+  SECTION("stores duplicates once") {
+    deserializeJson(doc, "[\"hello world\",\"hello world\",\"hello world\"]");
+
+    REQUIRE(doc[0].as<const char*>() == doc[1].as<const char*>());
+    REQUIRE(doc[0].as<const char*>() == doc[2].as<const char*>());
+  }
+
+  SECTION("stores duplicates once when set from the API") {
+    for (int i = 0; i < 100; i++) {
+      doc[std::string("key") + std::to_string(i % 10)] =
+          std::string("value") + std::to_string(i % 7);
+    }
+
+    REQUIRE(doc.size() == 10);
+    REQUIRE(doc["key3"] == "value2");
+    doc[std::string("extra")] = std::string("value2");
+    REQUIRE(doc["key3"].as<const char*>() == doc["extra"].as<const char*>());
+  }
+
+  SECTION("forgets released strings") {
+    for (int i = 0; i < 100; i++)
+      doc[std::string("key") + std::to_string(i)] = std::string("v") + "x";
+    for (int i = 0; i < 100; i += 2)
+      doc.remove(std::string("key") + std::to_string(i));
+
+    REQUIRE(doc.size() == 50);
+    for (int i = 0; i < 100; i++) {
+      std::string key = "key" + std::to_string(i);
+      REQUIRE(doc[key].isNull() == (i % 2 == 0));
+    }
+
+    // the removed keys can be stored again
+    for (int i = 0; i < 100; i += 2)
+      doc[std::string("key") + std::to_string(i)] = i;
+    REQUIRE(doc.size() == 100);
+    REQUIRE(doc["key42"] == 42);
+  }
+
+  SECTION("grows the index as strings are added") {
+    for (int i = 0; i < 6; i++) {
+      doc[std::string("key") + std::to_string(i)] =
+          std::string("value") + std::to_string(i);
+    }
+    spy.clearLog();
+
+    // 16 entries hold 12 strings, the 13th grows the index
+    doc[std::string("key6")] = std::string("value6");
+
+    REQUIRE(spy.log() ==
+            AllocatorLog{
+                Allocate(sizeofString("key6")),
+                Allocate(32 * sizeof(void*) * 2),
+                Deallocate(16 * sizeof(void*) * 2),
+                Allocate(sizeofString("value6")),
+            });
+  }
+
+  SECTION("releases the index on clear()") {
+    deserializeJson(doc, makeObject(100));
+    doc.clear();
+
+    REQUIRE(spy.allocatedBytes() == 0);
+  }
+
+  SECTION("allocates the index with the first string") {
+    doc[std::string("hello")] = std::string("world");
+
+    REQUIRE(spy.allocatedBytes() >= sizeofString("hello") +
+                                        sizeofString("world") +
+                                        16 * sizeof(void*) * 2);
+  }
+
+  SECTION("falls back to the list when the index can't grow") {
+    IndexLimitAllocator limit(32 * sizeof(void*) * 2);
+    JsonDocument doc2(&limit);
+
+    deserializeJson(doc2, makeObject(20));
+
+    REQUIRE(doc2.size() == 20);
+    for (int i = 0; i < 20; i++) {
+      std::string key = "key" + std::to_string(i);
+      REQUIRE(doc2[key] == "value" + std::to_string(i));
+    }
+
+    doc2[std::string("key3")] = std::string("value5");
+    REQUIRE(doc2["key3"].as<const char*>() == doc2["key5"].as<const char*>());
+  }
+}
@@ -17,6 +17,7 @@ class ResourceManager;
 
 class CollectionIterator {
   friend class CollectionData;
+  friend class ObjectData;
 
  public:
   CollectionIterator() : slot_(nullptr), currentId_(NULL_SLOT) {}
@@ -58,6 +58,9 @@ inline void CollectionData::appendPair(Slot<VariantData> key,
 }
 
 inline void CollectionData::clear(ResourceManager* resources) {
+#if ARDUINOJSON_OBJECT_INDEX
+  resources->removeObjectIndex(this);
+#endif
   auto next = head_;
   while (next != NULL_SLOT) {
     auto currId = next;
@@ -145,6 +145,79 @@
 #  endif
 #endif
 
+// Index the string pool with a hash table, so that storing a string doesn't
+// compare it with every distinct string already in the document
+// Worth it for documents with many distinct keys and values, costs one
+// pointer and one hash per string; must be 0 or 1
+#ifndef ARDUINOJSON_STRING_POOL_INDEX
+#  define ARDUINOJSON_STRING_POOL_INDEX 0
+#endif
+
+// Index the keys of large objects with a hash table, so that looking up a
+// member doesn't compare the key with every other member
+// Built by the first lookup (even a const one) that compares
+// ARDUINOJSON_OBJECT_INDEX_THRESHOLD keys, costs about 16 bytes per member;
+// must be 0 or 1
+#ifndef ARDUINOJSON_OBJECT_INDEX
+#  define ARDUINOJSON_OBJECT_INDEX 0
+#endif
+
+// Number of keys a lookup compares before indexing the object
+#ifndef ARDUINOJSON_OBJECT_INDEX_THRESHOLD
+#  define ARDUINOJSON_OBJECT_INDEX_THRESHOLD 16
+#endif
+
+// Scan whitespace and string characters 16 or 32 at a time with SSE2, AVX2 or
+// NEON when parsing a buffer of known size; the other targets test one
+// character at a time
+#ifndef ARDUINOJSON_ENABLE_SIMD
+#  if defined(__SSE2__) || \
+      (defined(__aarch64__) && defined(__ARM_NEON) && !defined(__AARCH64EB__))
+#    define ARDUINOJSON_ENABLE_SIMD 1
+#  else
+#    define ARDUINOJSON_ENABLE_SIMD 0
+#  endif
+#endif
+
+// Escape strings with a 256-byte lookup table and write the runs of
+// characters that need no escaping at once (1), or look up each character in
+// a short list and write it alone (0), which is smaller but slower
+#ifndef ARDUINOJSON_ESCAPE_TABLE
+#  if ARDUINOJSON_SIZEOF_POINTER >= 4  // 32 & 64 bits systems
+#    define ARDUINOJSON_ESCAPE_TABLE 1
+#  else
+#    define ARDUINOJSON_ESCAPE_TABLE 0
+#  endif
+#endif
+
+// Parse floating point values with the Eisel-Lemire algorithm (1), which is
+// faster and correctly rounded, or by multiplying the mantissa by powers of ten
+// (0); values that are out of the 1e-64..1e63 range, have more than 19
+// significant digits, or are subnormal always use the latter. Costs a 2 KB
+// table; must be 0 or 1
+#ifndef ARDUINOJSON_EISEL_LEMIRE
+#  define ARDUINOJSON_EISEL_LEMIRE 0
+#endif
+
+// Serialize floating point values with the fewest digits that parse back to
+// the same value (1), or with up to 9 digits for doubles and 6 for floats (0)
+// Uses the Schubfach algorithm, costs a table of 616 bytes for floats and
+// 9.6 KB for doubles; must be 0 or 1
+#ifndef ARDUINOJSON_SHORTEST_FLOAT
+#  define ARDUINOJSON_SHORTEST_FLOAT 0
+#endif
+
+// Write integers two digits at a time from a 200-byte table, with one 64-bit
+// division per 8 digits (1), or one digit at a time (0), which is smaller but
+// slower
+#ifndef ARDUINOJSON_DIGIT_PAIRS
+#  if ARDUINOJSON_SIZEOF_POINTER >= 4  // 32 & 64 bits systems
+#    define ARDUINOJSON_DIGIT_PAIRS 1
+#  else
+#    define ARDUINOJSON_DIGIT_PAIRS 0
+#  endif
+#endif
+
 #ifdef ARDUINO
 
 // Enable support for Arduino's String class
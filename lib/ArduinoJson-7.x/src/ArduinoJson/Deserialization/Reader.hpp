@@ -5,6 +5,8 @@
 #pragma once
 
 #include <ArduinoJson/Namespace.hpp>
+#include <ArduinoJson/Polyfills/type_traits.hpp>
+#include <ArduinoJson/Polyfills/type_traits/declval.hpp>
 #include <ArduinoJson/Polyfills/utility.hpp>
 
 #include <stdlib.h>  // for size_t
@@ -37,8 +39,30 @@ struct BoundedReader {
   // constructor
 };
 
+// Readers of memory expose it, so the deserializer can scan several
+// characters at once: cursor() is the next character, end() the end of the
+// input (nullptr if it's NUL-terminated), and skip(n) consumes n characters
+template <typename TReader, typename Enable = void>
+struct IsContiguousReader : false_type {};
+
+template <typename TReader>
+struct IsContiguousReader<
+    TReader, enable_if_t<is_same<decltype(declval<TReader&>().cursor()),
+                                 const char*>::value>> : true_type {};
+
+// Readers of a mutable buffer also expose mutableCursor(), so the deserializer
+// can unescape the strings in place
+template <typename TReader, typename Enable = void>
+struct IsInSituReader : false_type {};
+
+template <typename TReader>
+struct IsInSituReader<
+    TReader, enable_if_t<is_same<decltype(declval<TReader&>().mutableCursor()),
+                                 char*>::value>> : true_type {};
+
 ARDUINOJSON_END_PRIVATE_NAMESPACE
 
+#include <ArduinoJson/Deserialization/Readers/InSituReader.hpp>
 #include <ArduinoJson/Deserialization/Readers/IteratorReader.hpp>
 #include <ArduinoJson/Deserialization/Readers/RamReader.hpp>
 #include <ArduinoJson/Deserialization/Readers/VariantReader.hpp>
@@ -0,0 +1,49 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2025, Benoit BLANCHON
+// MIT License
+
+#pragma once
+
+ARDUINOJSON_BEGIN_PRIVATE_NAMESPACE
+
+// A contiguous reader of a mutable buffer, for deserializeJsonInSitu(): the
+// deserializer writes the unescaped strings at mutableCursor()
+class InSituReader {
+  char* ptr_;
+  const char* end_;  // nullptr if NUL-terminated
+
+ public:
+  explicit InSituReader(char* ptr, const char* end = nullptr)
+      : ptr_(ptr), end_(end) {}
+
+  int read() {
+    if (ptr_ == end_)
+      return -1;
+    return static_cast<unsigned char>(*ptr_++);
+  }
+
+  size_t readBytes(char* buffer, size_t length) {
+    size_t i = 0;
+    while (i < length && ptr_ != end_)
+      buffer[i++] = *ptr_++;
+    return i;
+  }
+
+  const char* cursor() const {
+    return ptr_;
+  }
+
+  char* mutableCursor() const {
+    return ptr_;
+  }
+
+  const char* end() const {
+    return end_;
+  }
+
+  void skip(size_t n) {
+    ptr_ += n;
+  }
+};
+
+ARDUINOJSON_END_PRIVATE_NAMESPACE
@@ -35,6 +35,18 @@ struct Reader<TSource*, enable_if_t<IsCharOrVoid<TSource>::value>> {
       buffer[i] = *ptr_++;
     return length;
   }
+
+  const char* cursor() const {
+    return ptr_;
+  }
+
+  const char* end() const {
+    return nullptr;  // NUL-terminated
+  }
+
+  void skip(size_t n) {
+    ptr_ += n;
+  }
 };
 
 template <typename TSource>
@@ -6,6 +6,8 @@
 
 #include <ArduinoJson/Namespace.hpp>
 
+#include <stdint.h>  // uint8_t
+
 ARDUINOJSON_BEGIN_PRIVATE_NAMESPACE
 
 class EscapeSequence {
@@ -19,6 +21,23 @@ class EscapeSequence {
     return p[0];
   }
 
+#if ARDUINOJSON_ESCAPE_TABLE
+  // Optimized for speed: the character that follows the backslash, 'u' for
+  // '\0' (written as \u0000), or 0 if c is written as is
+  static char escapeCharFast(char c) {
+    static const char table[256] = {
+        'u', 0,   0, 0, 0, 0, 0, 0, 'b', 't', 'n', 0, 'f', 'r', 0, 0,  // 0x00
+        0,   0,   0, 0, 0, 0, 0, 0, 0,   0,   0,   0, 0,   0,   0, 0,  // 0x10
+        0,   0, '"', 0, 0, 0, 0, 0, 0,   0,   0,   0, 0,   0,   0, 0,  // 0x20
+        0,   0,   0, 0, 0, 0, 0, 0, 0,   0,   0,   0, 0,   0,   0, 0,  // 0x30
+        0,   0,   0, 0, 0, 0, 0, 0, 0,   0,   0,   0, 0,   0,   0, 0,  // 0x40
+        0,   0,   0, 0, 0, 0, 0, 0, 0,   0,   0,   0, '\\', 0, 0, 0,  // 0x50
+        // the others are written as is
+    };
+    return table[static_cast<uint8_t>(c)];
+  }
+#endif
+
   // Optimized for code size on a 8-bit AVR
   static char unescapeChar(char c) {
     const char* p = escapeTable(false);
@@ -7,6 +7,7 @@
 #include <ArduinoJson/Deserialization/deserialize.hpp>
 #include <ArduinoJson/Json/EscapeSequence.hpp>
 #include <ArduinoJson/Json/Latch.hpp>
+#include <ArduinoJson/Json/Scanner.hpp>
 #include <ArduinoJson/Json/Utf16.hpp>
 #include <ArduinoJson/Json/Utf8.hpp>
 #include <ArduinoJson/Memory/ResourceManager.hpp>
@@ -16,8 +17,83 @@
 #include <ArduinoJson/Polyfills/utility.hpp>
 #include <ArduinoJson/Variant/VariantData.hpp>
 
+#include <string.h>  // memmove
+
 ARDUINOJSON_BEGIN_PRIVATE_NAMESPACE
 
+inline bool isBetween(char c, char min, char max) {
+  return min <= c && c <= max;
+}
+
+inline bool canBeInNumber(char c) {
+  return isBetween(c, '0', '9') || c == '+' || c == '-' || c == '.' ||
+#if ARDUINOJSON_ENABLE_NAN || ARDUINOJSON_ENABLE_INFINITY
+         isBetween(c, 'A', 'Z') || isBetween(c, 'a', 'z');
+#else
+         c == 'e' || c == 'E';
+#endif
+}
+
+inline bool canBeInNonQuotedString(char c) {
+  return isBetween(c, '0', '9') || isBetween(c, '_', 'z') ||
+         isBetween(c, 'A', 'Z');
+}
+
+inline bool isQuote(char c) {
+  return c == '\'' || c == '\"';
+}
+
+inline uint8_t decodeHex(char c) {
+  if (c < 'A')
+    return uint8_t(c - '0');
+  c = char(c & ~0x20);  // uppercase
+  return uint8_t(c - 'A' + 10);
+}
+
+// Writes the unescaped characters of a string over its escaped form
+struct InSituWriter {
+  char* ptr;
+
+  void append(char c) {
+    *ptr++ = c;
+  }
+};
+
+inline DeserializationError::Code setNumber(VariantData& result,
+                                           const Number& number,
+                                           ResourceManager* resources) {
+  switch (number.type()) {
+    case NumberType::UnsignedInteger:
+      if (result.setInteger(number.asUnsignedInteger(), resources))
+        return DeserializationError::Ok;
+      else
+        return DeserializationError::NoMemory;
+
+    case NumberType::SignedInteger:
+      if (result.setInteger(number.asSignedInteger(), resources))
+        return DeserializationError::Ok;
+      else
+        return DeserializationError::NoMemory;
+
+    case NumberType::Float:
+      if (result.setFloat(number.asFloat(), resources))
+        return DeserializationError::Ok;
+      else
+        return DeserializationError::NoMemory;
+
+#if ARDUINOJSON_USE_DOUBLE
+    case NumberType::Double:
+      if (result.setFloat(number.asDouble(), resources))
+        return DeserializationError::Ok;
+      else
+        return DeserializationError::NoMemory;
+#endif
+
+    default:
+      return DeserializationError::InvalidInput;
+  }
+}
+
 template <typename TReader>
 class JsonDeserializer {
  public:
@@ -42,7 +118,7 @@ class JsonDeserializer {
     return err;
   }
 
- private:
+ protected:
   char current() {
     return latch_.current();
   }
@@ -58,6 +134,43 @@ class JsonDeserializer {
     return true;
   }
 
+  // Fast paths for contiguous readers: consume the run of whitespace, resp.
+  // of string characters, that starts at the current character
+  template <typename TR = TReader>
+  enable_if_t<IsContiguousReader<TR>::value> skipSpaceRun() {
+    if (latch_.loaded())
+      return;
+    auto& reader = latch_.reader();
+    reader.skip(scanSpaces(reader.cursor(), reader.end()));
+  }
+
+  template <typename TR = TReader>
+  enable_if_t<IsContiguousReader<TR>::value> appendStringRun() {
+    if (latch_.loaded())
+      return;
+    auto& reader = latch_.reader();
+    size_t n = scanStringChars(reader.cursor(), reader.end());
+    stringBuilder_.append(reader.cursor(), n);
+    reader.skip(n);
+  }
+
+  template <typename TR = TReader>
+  enable_if_t<IsContiguousReader<TR>::value> skipStringRun() {
+    if (latch_.loaded())
+      return;
+    auto& reader = latch_.reader();
+    reader.skip(scanStringChars(reader.cursor(), reader.end()));
+  }
+
+  template <typename TR = TReader>
+  enable_if_t<!IsContiguousReader<TR>::value> skipSpaceRun() {}
+
+  template <typename TR = TReader>
+  enable_if_t<!IsContiguousReader<TR>::value> appendStringRun() {}
+
+  template <typename TR = TReader>
+  enable_if_t<!IsContiguousReader<TR>::value> skipStringRun() {}
+
   template <typename TFilter>
   DeserializationError::Code parseVariant(
       VariantData& variant, TFilter filter,
@@ -255,7 +368,8 @@ class JsonDeserializer {
     // Read each key value pair
     for (;;) {
       // Parse key
-      err = parseKey();
+      JsonString key;
+      err = parseKey(key);
       if (err)
         return err;
 
@@ -268,8 +382,6 @@ class JsonDeserializer {
       if (!eat(':'))
         return DeserializationError::InvalidInput;
 
-      JsonString key = stringBuilder_.str();
-
       TFilter memberFilter = filter[key];
 
       if (memberFilter.allow()) {
@@ -279,7 +391,7 @@ class JsonDeserializer {
           if (!keyVariant)
             return DeserializationError::NoMemory;
 
-          stringBuilder_.save(keyVariant);
+          saveString(key, keyVariant);
         } else {
           member->clear(resources_);
         }
@@ -370,38 +482,148 @@ class JsonDeserializer {
     }
   }
 
-  DeserializationError::Code parseKey() {
+  DeserializationError::Code parseKey(JsonString& key) {
+    if (isQuote(current()))
+      return readQuotedString(key);
+
     stringBuilder_.startString();
-    if (isQuote(current())) {
-      return parseQuotedString();
-    } else {
-      return parseNonQuotedString();
-    }
+    auto err = parseNonQuotedString();
+    if (err)
+      return err;
+    key = stringBuilder_.str();
+    return DeserializationError::Ok;
   }
 
   DeserializationError::Code parseStringValue(VariantData& variant) {
     DeserializationError::Code err;
 
-    stringBuilder_.startString();
+    JsonString str;
+    err = readQuotedString(str);
+    if (err)
+      return err;
+
+    saveString(str, &variant);
+
+    return DeserializationError::Ok;
+  }
 
-    err = parseQuotedString();
+  // Links the strings that stay in the input, copies the others
+  void saveString(JsonString str, VariantData* variant) {
+    if (str.isStatic())
+      variant->setLinkedString(str.c_str());
+    else
+      stringBuilder_.save(variant);
+  }
+
+  template <typename TR = TReader>
+  enable_if_t<!IsInSituReader<TR>::value, DeserializationError::Code>
+  readQuotedString(JsonString& result) {
+    stringBuilder_.startString();
+    auto err = parseQuotedString();
     if (err)
       return err;
+    result = stringBuilder_.str();
+    return DeserializationError::Ok;
+  }
+
+  // Unescapes the string where it is in the input and terminates it there.
+  // Only a string with a NUL (\u0000) is copied, as a linked string ends at
+  // the first one.
+  template <typename TR = TReader>
+  enable_if_t<IsInSituReader<TR>::value, DeserializationError::Code>
+  readQuotedString(JsonString& result) {
+    const char stopChar = current();
+    move();
+
+    auto& reader = latch_.reader();
+    const char* end = reader.end();
+    char* begin = reader.mutableCursor();
+    const char* src = begin;
+    InSituWriter dst = {begin};
+    bool hasNul = false;
+#if ARDUINOJSON_DECODE_UNICODE
+    Utf16::Codepoint codepoint;
+#endif
 
-    stringBuilder_.save(&variant);
+    for (;;) {
+      // the unescaped string is never longer, so dst doesn't overtake src
+      size_t n = scanStringChars(src, end);
+      if (dst.ptr != src)
+        memmove(dst.ptr, src, n);
+      dst.ptr += n;
+      src += n;
+
+      if (src == end || *src == '\0')
+        return DeserializationError::IncompleteInput;
+      char c = *src++;
+      if (c == stopChar)
+        break;
 
+      if (c == '\\') {
+        if (src == end || *src == '\0')
+          return DeserializationError::IncompleteInput;
+        c = *src++;
+
+        if (c == 'u') {
+#if ARDUINOJSON_DECODE_UNICODE
+          uint16_t codeunit = 0;
+          for (uint8_t i = 0; i < 4; ++i) {
+            if (src == end || *src == '\0')
+              return DeserializationError::IncompleteInput;
+            uint8_t value = decodeHex(*src++);
+            if (value > 0x0F)
+              return DeserializationError::InvalidInput;
+            codeunit = uint16_t((codeunit << 4) | value);
+          }
+          if (codepoint.append(codeunit)) {
+            hasNul |= codepoint.value() == 0;
+            Utf8::encodeCodepoint(codepoint.value(), dst);
+          }
+#else
+          dst.append('\\');
+          dst.append('u');
+#endif
+          continue;
+        }
+
+        c = EscapeSequence::unescapeChar(c);
+        if (c == '\0')
+          return DeserializationError::InvalidInput;
+      }
+
+      dst.append(c);
+    }
+
+    reader.skip(size_t(src - begin));
+    *dst.ptr = '\0';  // at most where the closing quote was
+    size_t length = size_t(dst.ptr - begin);
+
+    if (hasNul) {
+      stringBuilder_.startString();
+      stringBuilder_.append(begin, length);
+      if (!stringBuilder_.isValid())
+        return DeserializationError::NoMemory;
+      result = stringBuilder_.str();
+    } else {
+      result = JsonString(begin, length, true);
+    }
     return DeserializationError::Ok;
   }
 
   DeserializationError::Code parseQuotedString() {
+    const char stopChar = current();
+    move();
+    return parseQuotedStringTail(stopChar);
+  }
+
+  // Parses the rest of a quoted string, after the opening quote
+  DeserializationError::Code parseQuotedStringTail(char stopChar) {
 #if ARDUINOJSON_DECODE_UNICODE
     Utf16::Codepoint codepoint;
     DeserializationError::Code err;
 #endif
-    const char stopChar = current();
-
-    move();
     for (;;) {
+      appendStringRun();
       char c = current();
       move();
       if (c == stopChar)
@@ -480,6 +702,7 @@ class JsonDeserializer {
 
     move();
     for (;;) {
+      skipStringRun();
       char c = current();
       move();
       if (c == stopChar)
@@ -504,7 +727,7 @@ class JsonDeserializer {
     return DeserializationError::Ok;
   }
 
-  DeserializationError::Code parseNumericValue(VariantData& result) {
+  Number readNumber(bool allowFloat = true) {
     uint8_t n = 0;
 
     char c = current();
@@ -515,37 +738,11 @@ class JsonDeserializer {
     }
     buffer_[n] = 0;
 
-    auto number = parseNumber(buffer_);
-    switch (number.type()) {
-      case NumberType::UnsignedInteger:
-        if (result.setInteger(number.asUnsignedInteger(), resources_))
-          return DeserializationError::Ok;
-        else
-          return DeserializationError::NoMemory;
-
-      case NumberType::SignedInteger:
-        if (result.setInteger(number.asSignedInteger(), resources_))
-          return DeserializationError::Ok;
-        else
-          return DeserializationError::NoMemory;
-
-      case NumberType::Float:
-        if (result.setFloat(number.asFloat(), resources_))
-          return DeserializationError::Ok;
-        else
-          return DeserializationError::NoMemory;
-
-#if ARDUINOJSON_USE_DOUBLE
-      case NumberType::Double:
-        if (result.setFloat(number.asDouble(), resources_))
-          return DeserializationError::Ok;
-        else
-          return DeserializationError::NoMemory;
-#endif
+    return parseNumber(buffer_, buffer_ + n, allowFloat);
+  }
 
-      default:
-        return DeserializationError::InvalidInput;
-    }
+  DeserializationError::Code parseNumericValue(VariantData& result) {
+    return setNumber(result, readNumber(), resources_);
   }
 
   DeserializationError::Code skipNumericValue() {
@@ -572,35 +769,6 @@ class JsonDeserializer {
     return DeserializationError::Ok;
   }
 
-  static inline bool isBetween(char c, char min, char max) {
-    return min <= c && c <= max;
-  }
-
-  static inline bool canBeInNumber(char c) {
-    return isBetween(c, '0', '9') || c == '+' || c == '-' || c == '.' ||
-#if ARDUINOJSON_ENABLE_NAN || ARDUINOJSON_ENABLE_INFINITY
-           isBetween(c, 'A', 'Z') || isBetween(c, 'a', 'z');
-#else
-           c == 'e' || c == 'E';
-#endif
-  }
-
-  static inline bool canBeInNonQuotedString(char c) {
-    return isBetween(c, '0', '9') || isBetween(c, '_', 'z') ||
-           isBetween(c, 'A', 'Z');
-  }
-
-  static inline bool isQuote(char c) {
-    return c == '\'' || c == '\"';
-  }
-
-  static inline uint8_t decodeHex(char c) {
-    if (c < 'A')
-      return uint8_t(c - '0');
-    c = char(c & ~0x20);  // uppercase
-    return uint8_t(c - 'A' + 10);
-  }
-
   DeserializationError::Code skipSpacesAndComments() {
     for (;;) {
       switch (current()) {
@@ -615,6 +783,7 @@ class JsonDeserializer {
         case '\r':
         case '\n':
           move();
+          skipSpaceRun();
           continue;
 
 #if ARDUINOJSON_ENABLE_COMMENTS
@@ -717,4 +886,39 @@ inline DeserializationError deserializeJson(TDestination&& dst, TChar* input,
                                        input, detail::forward<Args>(args)...);
 }
 
+// Parses a JSON input in place, and puts the result in a JsonDocument.
+// The strings are unescaped in the input buffer and the document refers to
+// them instead of copying them, so the buffer must outlive the document.
+// The buffer is modified even if the parsing fails.
+template <typename TDestination, typename... Args,
+          detail::enable_if_t<
+              detail::is_deserialize_destination<TDestination>::value &&
+                  !detail::is_integral<
+                      typename detail::first_or_void<Args...>::type>::value,
+              int> = 0>
+inline DeserializationError deserializeJsonInSitu(TDestination&& dst,
+                                                  char* input, Args... args) {
+  using namespace detail;
+  return doDeserialize<JsonDeserializer>(dst, InSituReader(input),
+                                         makeDeserializationOptions(args...));
+}
+
+// Parses a JSON input in place, and puts the result in a JsonDocument.
+// The strings are unescaped in the input buffer and the document refers to
+// them instead of copying them, so the buffer must outlive the document.
+// The buffer is modified even if the parsing fails.
+template <typename TDestination, typename Size, typename... Args,
+          detail::enable_if_t<
+              detail::is_deserialize_destination<TDestination>::value &&
+                  detail::is_integral<Size>::value,
+              int> = 0>
+inline DeserializationError deserializeJsonInSitu(TDestination&& dst,
+                                                  char* input, Size inputSize,
+                                                  Args... args) {
+  using namespace detail;
+  return doDeserialize<JsonDeserializer>(
+      dst, InSituReader(input, input + size_t(inputSize)),
+      makeDeserializationOptions(args...));
+}
+
 ARDUINOJSON_END_PUBLIC_NAMESPACE
@@ -0,0 +1,468 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2025, Benoit BLANCHON
+// MIT License
+
+#pragma once
+
+#include <ArduinoJson/Deserialization/deserialize.hpp>
+#include <ArduinoJson/Document/JsonDocument.hpp>
+#include <ArduinoJson/Json/JsonDeserializer.hpp>
+
+#include <string.h>  // strlen
+
+ARDUINOJSON_BEGIN_PUBLIC_NAMESPACE
+
+// Deserializes a JSON input that arrives in pieces, like reassembled radio
+// fragments or the chunks of an HTTP body, without buffering it. feed() parses
+// each piece as it comes and returns IncompleteInput until the value is
+// complete, then Ok. finish() tells that the input ended, which is only
+// needed to complete a number at the root. Characters after the value are
+// ignored, like deserializeJson() does.
+//
+// Between two pieces, the state is a stack of containers, which limits the
+// nesting to ARDUINOJSON_DEFAULT_NESTING_LIMIT, and the number being read;
+// the string being read is already in the memory of the document.
+class JsonIncrementalDeserializer {
+ public:
+  explicit JsonIncrementalDeserializer(
+      JsonDocument& doc, DeserializationOption::NestingLimit nestingLimit = {})
+      : doc_(doc),
+        resources_(detail::VariantAttorney::getResourceManager(doc)),
+        stringBuilder_(resources_),
+        nestingLimit_(nestingLimit) {
+    doc.clear();
+    target_ = detail::VariantAttorney::getOrCreateData(doc);
+  }
+
+  JsonIncrementalDeserializer(const JsonIncrementalDeserializer&) = delete;
+  JsonIncrementalDeserializer& operator=(const JsonIncrementalDeserializer&) =
+      delete;
+
+  // Parses the next piece of the input
+  DeserializationError feed(const char* data, size_t length) {
+    const char* end = data + length;
+    while (data < end && result_ == DeserializationError::IncompleteInput) {
+      // consume the runs that don't change the state at once
+      if (state_ == State::String && !escape_) {
+        size_t n = detail::scanStringChars(data, end);
+        stringBuilder_.append(data, n);
+        data += n;
+      } else if (state_ <= State::AfterValue) {
+        data += detail::scanSpaces(data, end);
+      }
+      if (data < end && step(*data))
+        data++;
+    }
+    return result_;
+  }
+
+  DeserializationError feed(const char* s) {
+    return feed(s, strlen(s));
+  }
+
+  // Tells that the input ended
+  DeserializationError finish() {
+    if (result_ != DeserializationError::IncompleteInput)
+      return result_;
+    if (state_ == State::Number)
+      endNumber();
+    else if (state_ == State::Value && depth_ == 0)
+      complete(DeserializationError::EmptyInput);
+    if (result_ == DeserializationError::IncompleteInput)
+      complete(DeserializationError::IncompleteInput);
+    return result_;
+  }
+
+ private:
+  enum class State : uint8_t {
+    // between the tokens, where spaces and comments are skipped
+    Value,        // before a value
+    ArrayStart,   // after '[': a value or ']'
+    ObjectStart,  // after '{': a key or '}'
+    Key,          // before a key
+    Colon,        // after a key
+    AfterValue,   // after a value in a container: ',' or the closing bracket
+
+    // in a token
+    String,
+    NonQuotedKey,
+    Number,
+    Keyword,
+#if ARDUINOJSON_ENABLE_COMMENTS
+    Slash,
+    BlockComment,
+    BlockCommentStar,
+    LineComment,
+#endif
+    Done,
+  };
+
+  struct Frame {
+    detail::VariantData* container;
+    DeserializationOption::NestingLimit nestingLimit;  // to restore on close
+    bool isObject;
+  };
+
+  // Processes c and returns true, or returns false to process it again in the
+  // new state
+  bool step(char c) {
+    if (c == '\0') {  // like the end of a NUL-terminated input
+      finish();
+      return true;
+    }
+
+    switch (state_) {
+      case State::Value:
+        if (skipSpaceOrComment(c))
+          return true;
+        switch (c) {
+          case '[':
+            openContainer(false);
+            return true;
+          case '{':
+            openContainer(true);
+            return true;
+          case '\"':
+          case '\'':
+            startString(c, false);
+            return true;
+          case 't':
+            startKeyword("true");
+            return true;
+          case 'f':
+            startKeyword("false");
+            return true;
+          case 'n':
+            startKeyword("null");
+            return true;
+          default:
+            // like JsonDeserializer, anything else goes to parseNumber()
+            numberLength_ = 0;
+            state_ = State::Number;
+            return false;
+        }
+
+      case State::ArrayStart:
+        if (skipSpaceOrComment(c))
+          return true;
+        if (c == ']')
+          return closeContainer();
+        addElement();
+        return false;
+
+      case State::ObjectStart:
+        if (skipSpaceOrComment(c))
+          return true;
+        if (c == '}')
+          return closeContainer();
+        state_ = State::Key;
+        return false;
+
+      case State::Key:
+        if (skipSpaceOrComment(c))
+          return true;
+        if (detail::isQuote(c)) {
+          startString(c, true);
+          return true;
+        }
+        if (!detail::canBeInNonQuotedString(c)) {
+          complete(DeserializationError::InvalidInput);
+          return true;
+        }
+        stringBuilder_.startString();
+        state_ = State::NonQuotedKey;
+        return false;
+
+      case State::Colon:
+        if (skipSpaceOrComment(c))
+          return true;
+        if (c == ':')
+          addMember();
+        else
+          complete(DeserializationError::InvalidInput);
+        return true;
+
+      case State::AfterValue:
+        if (skipSpaceOrComment(c))
+          return true;
+        if (c == ',') {
+          if (top().isObject)
+            state_ = State::Key;
+          else
+            addElement();
+          return true;
+        }
+        if (c == (top().isObject ? '}' : ']'))
+          return closeContainer();
+        complete(DeserializationError::InvalidInput);
+        return true;
+
+      case State::String:
+        appendStringChar(c);
+        return true;
+
+      case State::NonQuotedKey:
+        if (detail::canBeInNonQuotedString(c)) {
+          stringBuilder_.append(c);
+          return true;
+        }
+        if (stringBuilder_.isValid())
+          state_ = State::Colon;
+        else
+          complete(DeserializationError::NoMemory);
+        return false;
+
+      case State::Number:
+        if (detail::canBeInNumber(c) && numberLength_ < 63) {
+          buffer_[numberLength_++] = c;
+          return true;
+        }
+        endNumber();
+        // We don't detect trailing characters earlier, so we need to check now
+        if (result_ == DeserializationError::Ok && target_->isFloat())
+          complete(DeserializationError::InvalidInput);
+        return false;
+
+      case State::Keyword:
+        if (c != keyword_[keywordLength_]) {
+          complete(DeserializationError::InvalidInput);
+          return true;
+        }
+        if (keyword_[++keywordLength_] == '\0') {
+          if (keyword_[0] != 'n')
+            target_->setBoolean(keyword_[0] == 't');
+          endValue();
+        }
+        return true;
+
+#if ARDUINOJSON_ENABLE_COMMENTS
+      case State::Slash:
+        if (c == '*')
+          state_ = State::BlockComment;
+        else if (c == '/')
+          state_ = State::LineComment;
+        else
+          complete(DeserializationError::InvalidInput);
+        return true;
+
+      case State::BlockComment:
+        if (c == '*')
+          state_ = State::BlockCommentStar;
+        return true;
+
+      case State::BlockCommentStar:
+        if (c == '/')
+          state_ = commentReturn_;
+        else if (c != '*')
+          state_ = State::BlockComment;
+        return true;
+
+      case State::LineComment:
+        if (c == '\n')
+          state_ = commentReturn_;
+        return true;
+#endif
+
+      default:
+        return true;
+    }
+  }
+
+  bool skipSpaceOrComment(char c) {
+    if (detail::isJsonSpace(c))
+      return true;
+#if ARDUINOJSON_ENABLE_COMMENTS
+    if (c == '/') {
+      commentReturn_ = state_;
+      state_ = State::Slash;
+      return true;
+    }
+#endif
+    return false;
+  }
+
+  Frame& top() {
+    ARDUINOJSON_ASSERT(depth_ > 0);
+    return stack_[depth_ - 1];
+  }
+
+  void openContainer(bool isObject) {
+    if (depth_ == maxDepth || nestingLimit_.reached()) {
+      complete(DeserializationError::TooDeep);
+      return;
+    }
+    stack_[depth_++] = {target_, nestingLimit_, isObject};
+    nestingLimit_ = nestingLimit_.decrement();
+    if (isObject) {
+      target_->toObject();
+      state_ = State::ObjectStart;
+    } else {
+      target_->toArray();
+      state_ = State::ArrayStart;
+    }
+  }
+
+  bool closeContainer() {
+    nestingLimit_ = top().nestingLimit;
+    target_ = top().container;
+    depth_--;
+    endValue();
+    return true;
+  }
+
+  void addElement() {
+    target_ = top().container->asArray()->addElement(resources_);
+    if (target_)
+      state_ = State::Value;
+    else
+      complete(DeserializationError::NoMemory);
+  }
+
+  void addMember() {
+    auto object = top().container->asObject();
+    JsonString key = stringBuilder_.str();
+    auto member = object->getMember(detail::adaptString(key), resources_);
+    if (!member) {
+      auto keyVariant = object->addPair(&member, resources_);
+      if (!keyVariant) {
+        complete(DeserializationError::NoMemory);
+        return;
+      }
+      stringBuilder_.save(keyVariant);
+    } else {
+      member->clear(resources_);
+    }
+    target_ = member;
+    state_ = State::Value;
+  }
+
+  void startString(char quote, bool isKey) {
+    stringBuilder_.startString();
+    stringStop_ = quote;
+    isKey_ = isKey;
+    escape_ = 0;
+#if ARDUINOJSON_DECODE_UNICODE
+    codepoint_ = detail::Utf16::Codepoint();
+#endif
+    state_ = State::String;
+  }
+
+  // escape_ is 0 outside of escape sequences, 1 after the backslash, and 2 to
+  // 5 before each digit of \uXXXX
+  void appendStringChar(char c) {
+    if (escape_ == 0) {
+      if (c == stringStop_)
+        endString();
+      else if (c == '\\')
+        escape_ = 1;
+      else
+        stringBuilder_.append(c);
+      return;
+    }
+
+    if (escape_ == 1) {
+      if (c == 'u') {
+#if ARDUINOJSON_DECODE_UNICODE
+        escape_ = 2;
+        codeunit_ = 0;
+#else
+        stringBuilder_.append('\\');
+        stringBuilder_.append(c);
+        escape_ = 0;
+#endif
+        return;
+      }
+      escape_ = 0;
+      c = detail::EscapeSequence::unescapeChar(c);
+      if (c == '\0')
+        complete(DeserializationError::InvalidInput);
+      else
+        stringBuilder_.append(c);
+      return;
+    }
+
+#if ARDUINOJSON_DECODE_UNICODE
+    uint8_t value = detail::decodeHex(c);
+    if (value > 0x0F) {
+      complete(DeserializationError::InvalidInput);
+      return;
+    }
+    codeunit_ = uint16_t((codeunit_ << 4) | value);
+    if (++escape_ == 6) {
+      escape_ = 0;
+      if (codepoint_.append(codeunit_))
+        detail::Utf8::encodeCodepoint(codepoint_.value(), stringBuilder_);
+    }
+#endif
+  }
+
+  void endString() {
+    if (!stringBuilder_.isValid()) {
+      complete(DeserializationError::NoMemory);
+    } else if (isKey_) {
+      state_ = State::Colon;
+    } else {
+      stringBuilder_.save(target_);
+      endValue();
+    }
+  }
+
+  void startKeyword(const char* keyword) {
+    keyword_ = keyword;
+    keywordLength_ = 1;
+    state_ = State::Keyword;
+  }
+
+  void endNumber() {
+    buffer_[numberLength_] = 0;
+    auto number = detail::parseNumber(buffer_, buffer_ + numberLength_);
+    auto err = detail::setNumber(*target_, number, resources_);
+    if (err)
+      complete(err);
+    else
+      endValue();
+  }
+
+  void endValue() {
+    if (depth_ == 0)
+      complete(DeserializationError::Ok);
+    else
+      state_ = State::AfterValue;
+  }
+
+  void complete(DeserializationError::Code result) {
+    result_ = result;
+    state_ = State::Done;
+    detail::shrinkJsonDocument(doc_);
+  }
+
+  static const uint8_t maxDepth = ARDUINOJSON_DEFAULT_NESTING_LIMIT;
+
+  JsonDocument& doc_;
+  detail::ResourceManager* resources_;
+  detail::StringBuilder stringBuilder_;
+  detail::VariantData* target_;  // the value being read
+  DeserializationOption::NestingLimit nestingLimit_;
+  DeserializationError::Code result_ = DeserializationError::IncompleteInput;
+  State state_ = State::Value;
+#if ARDUINOJSON_ENABLE_COMMENTS
+  State commentReturn_ = State::Value;
+#endif
+  uint8_t depth_ = 0;
+  Frame stack_[maxDepth];
+
+  // the token being read
+  char stringStop_ = 0;
+  bool isKey_ = false;
+  uint8_t escape_ = 0;
+#if ARDUINOJSON_DECODE_UNICODE
+  uint16_t codeunit_ = 0;
+  detail::Utf16::Codepoint codepoint_;
+#endif
+  const char* keyword_ = nullptr;
+  uint8_t keywordLength_ = 0;
+  uint8_t numberLength_ = 0;
+  char buffer_[64];
+};
+
+ARDUINOJSON_END_PUBLIC_NAMESPACE
@@ -0,0 +1,410 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2025, Benoit BLANCHON
+// MIT License
+
+#pragma once
+
+#include <ArduinoJson/Json/JsonDeserializer.hpp>
+#include <ArduinoJson/Numbers/JsonFloat.hpp>
+#include <ArduinoJson/Numbers/JsonInteger.hpp>
+#include <ArduinoJson/Strings/JsonString.hpp>
+
+ARDUINOJSON_BEGIN_PUBLIC_NAMESPACE
+
+// Receives the events of parseJson(). Derive from it and redefine the
+// functions you need; each one returns false to stop the parsing.
+// The strings are valid until the function returns and are not always
+// NUL-terminated, so use their size().
+class JsonHandler {
+ public:
+  // Called before each value in an array or an object; return true to skip
+  // the value without events, like a Filter does
+  bool skipValue() {
+    return false;
+  }
+
+  bool startObject() {
+    return true;
+  }
+
+  bool endObject() {
+    return true;
+  }
+
+  bool startArray() {
+    return true;
+  }
+
+  bool endArray() {
+    return true;
+  }
+
+  bool key(JsonString) {
+    return true;
+  }
+
+  bool string(JsonString) {
+    return true;
+  }
+
+  bool integer(JsonInteger) {
+    return true;
+  }
+
+  bool unsignedInteger(JsonUInt) {
+    return true;
+  }
+
+  bool floatingPoint(JsonFloat) {
+    return true;
+  }
+
+  bool boolean(bool) {
+    return true;
+  }
+
+  bool null() {
+    return true;
+  }
+};
+
+ARDUINOJSON_END_PUBLIC_NAMESPACE
+
+ARDUINOJSON_BEGIN_PRIVATE_NAMESPACE
+
+// Walks the input with the tokenizer of JsonDeserializer and calls the handler
+// instead of building a document. The memory use only depends on the nesting
+// depth (the recursion) and on the longest string that must be copied: with a
+// contiguous reader, strings without escape sequences are passed as views of
+// the input, the others go through the StringBuilder.
+template <typename TReader, typename THandler>
+class JsonParser : public JsonDeserializer<TReader> {
+  using base = JsonDeserializer<TReader>;
+
+ public:
+  JsonParser(ResourceManager* resources, TReader reader, THandler& handler)
+      : base(resources, reader), handler_(handler) {}
+
+  DeserializationError parse(DeserializationOption::NestingLimit nestingLimit) {
+    DeserializationError::Code err;
+
+    err = parseValue(nestingLimit);
+
+    // stopping isn't an error
+    if (stopped_)
+      return DeserializationError::Ok;
+
+    if (!err && this->latch_.last() != 0 && endsWithFloat_) {
+      // We don't detect trailing characters earlier, so we need to check now
+      return DeserializationError::InvalidInput;
+    }
+
+    return err;
+  }
+
+ private:
+  // Unwinds the recursion; parse() knows it's not an error
+  DeserializationError::Code stop() {
+    stopped_ = true;
+    return DeserializationError::InvalidInput;
+  }
+
+  DeserializationError::Code parseValue(
+      DeserializationOption::NestingLimit nestingLimit) {
+    DeserializationError::Code err;
+
+    err = this->skipSpacesAndComments();
+    if (err)
+      return err;
+
+    switch (this->current()) {
+      case '[':
+        return parseArray(nestingLimit);
+
+      case '{':
+        return parseObject(nestingLimit);
+
+      case '\"':
+      case '\'': {
+        JsonString str;
+        err = parseString(str);
+        if (err)
+          return err;
+        return handler_.string(str) ? DeserializationError::Ok : stop();
+      }
+
+      case 't':
+        err = this->skipKeyword("true");
+        if (err)
+          return err;
+        return handler_.boolean(true) ? DeserializationError::Ok : stop();
+
+      case 'f':
+        err = this->skipKeyword("false");
+        if (err)
+          return err;
+        return handler_.boolean(false) ? DeserializationError::Ok : stop();
+
+      case 'n':
+        err = this->skipKeyword("null");
+        if (err)
+          return err;
+        return handler_.null() ? DeserializationError::Ok : stop();
+
+      default:
+        return parseNumericValue();
+    }
+  }
+
+  DeserializationError::Code parseOrSkipValue(
+      DeserializationOption::NestingLimit nestingLimit) {
+    if (handler_.skipValue())
+      return this->skipVariant(nestingLimit);
+    return parseValue(nestingLimit);
+  }
+
+  DeserializationError::Code parseArray(
+      DeserializationOption::NestingLimit nestingLimit) {
+    DeserializationError::Code err;
+
+    if (nestingLimit.reached())
+      return DeserializationError::TooDeep;
+
+    // Skip opening braket
+    ARDUINOJSON_ASSERT(this->current() == '[');
+    this->move();
+
+    if (!handler_.startArray())
+      return stop();
+
+    // Skip spaces
+    err = this->skipSpacesAndComments();
+    if (err)
+      return err;
+
+    // Empty array?
+    if (!this->eat(']')) {
+      // Read each value
+      for (;;) {
+        // 1 - Parse value
+        err = parseOrSkipValue(nestingLimit.decrement());
+        if (err)
+          return err;
+
+        // 2 - Skip spaces
+        err = this->skipSpacesAndComments();
+        if (err)
+          return err;
+
+        // 3 - More values?
+        if (this->eat(']'))
+          break;
+        if (!this->eat(','))
+          return DeserializationError::InvalidInput;
+      }
+    }
+
+    endsWithFloat_ = false;
+    return handler_.endArray() ? DeserializationError::Ok : stop();
+  }
+
+  DeserializationError::Code parseObject(
+      DeserializationOption::NestingLimit nestingLimit) {
+    DeserializationError::Code err;
+
+    if (nestingLimit.reached())
+      return DeserializationError::TooDeep;
+
+    // Skip opening brace
+    ARDUINOJSON_ASSERT(this->current() == '{');
+    this->move();
+
+    if (!handler_.startObject())
+      return stop();
+
+    // Skip spaces
+    err = this->skipSpacesAndComments();
+    if (err)
+      return err;
+
+    // Empty object?
+    if (!this->eat('}')) {
+      // Read each key value pair
+      for (;;) {
+        // Parse key
+        JsonString key;
+        if (isQuote(this->current())) {
+          err = parseString(key);
+        } else {
+          this->stringBuilder_.startString();
+          err = this->parseNonQuotedString();
+          if (!err)
+            key = this->stringBuilder_.str();
+        }
+        if (err)
+          return err;
+
+        // Skip spaces
+        err = this->skipSpacesAndComments();
+        if (err)
+          return err;
+
+        // Colon
+        if (!this->eat(':'))
+          return DeserializationError::InvalidInput;
+
+        if (!handler_.key(key))
+          return stop();
+
+        // Parse value
+        err = parseOrSkipValue(nestingLimit.decrement());
+        if (err)
+          return err;
+
+        // Skip spaces
+        err = this->skipSpacesAndComments();
+        if (err)
+          return err;
+
+        // More keys/values?
+        if (this->eat('}'))
+          break;
+        if (!this->eat(','))
+          return DeserializationError::InvalidInput;
+
+        // Skip spaces
+        err = this->skipSpacesAndComments();
+        if (err)
+          return err;
+      }
+    }
+
+    endsWithFloat_ = false;
+    return handler_.endObject() ? DeserializationError::Ok : stop();
+  }
+
+  DeserializationError::Code parseString(JsonString& result) {
+    const char stopChar = this->current();
+    this->move();
+
+    if (parseStringView(stopChar, result))
+      return DeserializationError::Ok;
+
+    this->stringBuilder_.startString();
+    auto err = this->parseQuotedStringTail(stopChar);
+    if (err)
+      return err;
+    result = this->stringBuilder_.str();
+    return DeserializationError::Ok;
+  }
+
+  // Returns the string as a view of the input if it has no escape sequence
+  template <typename TR = TReader>
+  enable_if_t<IsContiguousReader<TR>::value, bool> parseStringView(
+      char stopChar, JsonString& result) {
+    auto& reader = this->latch_.reader();
+    const char* s = reader.cursor();
+    size_t n = scanStringChars(s, reader.end());
+    if (s + n == reader.end() || s[n] != stopChar)
+      return false;
+    result = JsonString(s, n);
+    reader.skip(n + 1);
+    return true;
+  }
+
+  template <typename TR = TReader>
+  enable_if_t<!IsContiguousReader<TR>::value, bool> parseStringView(
+      char, JsonString&) {
+    return false;
+  }
+
+  DeserializationError::Code parseNumericValue() {
+    // nothing is stored, so a float doesn't save any room: the handler gets
+    // every number at the precision of JsonFloat
+    auto number = this->readNumber(false);
+    endsWithFloat_ = false;
+    bool ok;
+    switch (number.type()) {
+      case NumberType::UnsignedInteger:
+        ok = handler_.unsignedInteger(number.asUnsignedInteger());
+        break;
+
+      case NumberType::SignedInteger:
+        ok = handler_.integer(number.asSignedInteger());
+        break;
+
+      case NumberType::Float:
+        endsWithFloat_ = true;
+        ok = handler_.floatingPoint(JsonFloat(number.asFloat()));
+        break;
+
+#if ARDUINOJSON_USE_DOUBLE
+      case NumberType::Double:
+        endsWithFloat_ = true;
+        ok = handler_.floatingPoint(JsonFloat(number.asDouble()));
+        break;
+#endif
+
+      default:
+        return DeserializationError::InvalidInput;
+    }
+    return ok ? DeserializationError::Ok : stop();
+  }
+
+  THandler& handler_;
+  bool stopped_ = false;
+  bool endsWithFloat_ = false;  // for the check of trailing characters
+};
+
+template <typename THandler, typename TReader>
+DeserializationError doParseJson(
+    TReader reader, THandler& handler,
+    DeserializationOption::NestingLimit nestingLimit, Allocator* allocator) {
+  ResourceManager resources(allocator);
+  return JsonParser<TReader, THandler>(&resources, reader, handler)
+      .parse(nestingLimit);
+}
+
+ARDUINOJSON_END_PRIVATE_NAMESPACE
+
+ARDUINOJSON_BEGIN_PUBLIC_NAMESPACE
+
+// Parses a JSON input and calls the handler for each token, without building
+// a document. The allocator is only used to copy the strings that can't be
+// passed as views of the input.
+template <typename TInput, typename THandler>
+inline DeserializationError parseJson(
+    TInput&& input, THandler& handler,
+    DeserializationOption::NestingLimit nestingLimit = {},
+    Allocator* allocator = detail::DefaultAllocator::instance()) {
+  using namespace detail;
+  return doParseJson(makeReader(detail::forward<TInput>(input)), handler,
+                     nestingLimit, allocator);
+}
+
+// Parses a JSON input and calls the handler for each token, without building
+// a document. The allocator is only used to copy the strings that can't be
+// passed as views of the input.
+template <typename TChar, typename THandler>
+inline DeserializationError parseJson(
+    TChar* input, THandler& handler,
+    DeserializationOption::NestingLimit nestingLimit = {},
+    Allocator* allocator = detail::DefaultAllocator::instance()) {
+  using namespace detail;
+  return doParseJson(makeReader(input), handler, nestingLimit, allocator);
+}
+
+// Parses a JSON input and calls the handler for each token, without building
+// a document. The allocator is only used to copy the strings that can't be
+// passed as views of the input.
+template <typename TChar, typename THandler>
+inline DeserializationError parseJson(
+    TChar* input, size_t inputSize, THandler& handler,
+    DeserializationOption::NestingLimit nestingLimit = {},
+    Allocator* allocator = detail::DefaultAllocator::instance()) {
+  using namespace detail;
+  return doParseJson(makeReader(input, inputSize), handler, nestingLimit,
+                     allocator);
+}
+
+ARDUINOJSON_END_PUBLIC_NAMESPACE
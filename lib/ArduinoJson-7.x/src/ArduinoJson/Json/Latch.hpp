@@ -25,6 +25,17 @@ class Latch {
     return current_;
   }
 
+  bool loaded() const {
+    return loaded_;
+  }
+
+  // Gives access to the position of the reader, which is the current
+  // character only if it isn't loaded yet
+  TReader& reader() {
+    ARDUINOJSON_ASSERT(!loaded_);
+    return reader_;
+  }
+
   FORCE_INLINE char current() {
     if (!loaded_) {
       load();
@@ -0,0 +1,180 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2025, Benoit BLANCHON
+// MIT License
+
+#pragma once
+
+#include <ArduinoJson/Namespace.hpp>
+
+#include <stddef.h>  // size_t
+#include <stdint.h>  // uint32_t
+
+#if ARDUINOJSON_ENABLE_SIMD
+#  if defined(__AVX2__)
+#    include <immintrin.h>
+#  elif defined(__SSE2__)
+#    include <emmintrin.h>
+#  else
+#    include <arm_neon.h>
+#  endif
+#endif
+
+ARDUINOJSON_BEGIN_PRIVATE_NAMESPACE
+
+// Measures the runs of characters that JsonDeserializer can skip or copy
+// without looking at them one by one. Only for contiguous readers: the input
+// is [p, end), or the NUL-terminated string p if end is null. Blocks of 16 or
+// 32 characters are tested at once with ARDUINOJSON_ENABLE_SIMD, but only if
+// end is known, as the last block would read past the terminator otherwise.
+
+inline bool isJsonSpace(char c) {
+  return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+// Characters that end a run in a quoted string: either quote (only one of
+// them ends the string), the backslash, and NUL, which ends the input
+inline bool isStringStop(char c) {
+  return c == '"' || c == '\'' || c == '\\' || c == '\0';
+}
+
+#if ARDUINOJSON_ENABLE_SIMD
+#  if defined(__AVX2__)
+const size_t simdBlockSize = 32;
+
+// Bit i is set if character i of the block is whitespace, resp. a stop
+inline uint32_t simdSpaceMask(const char* p) {
+  __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+  __m256i m = _mm256_or_si256(
+      _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')),
+                      _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\t'))),
+      _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\r')),
+                      _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n'))));
+  return static_cast<uint32_t>(_mm256_movemask_epi8(m));
+}
+
+inline uint32_t simdStopMask(const char* p) {
+  __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+  __m256i m = _mm256_or_si256(
+      _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('"')),
+                      _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\''))),
+      _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\\')),
+                      _mm256_cmpeq_epi8(v, _mm256_setzero_si256())));
+  return static_cast<uint32_t>(_mm256_movemask_epi8(m));
+}
+
+inline size_t simdFirstBit(uint32_t mask) {
+  return static_cast<size_t>(__builtin_ctz(mask));
+}
+
+inline uint32_t simdInvert(uint32_t mask) {
+  return ~mask;
+}
+#  elif defined(__SSE2__)
+const size_t simdBlockSize = 16;
+
+// Bit i is set if character i of the block is whitespace, resp. a stop
+inline uint32_t simdSpaceMask(const char* p) {
+  __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+  __m128i m = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')),
+                                        _mm_cmpeq_epi8(v, _mm_set1_epi8('\t'))),
+                           _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\r')),
+                                        _mm_cmpeq_epi8(v, _mm_set1_epi8('\n'))));
+  return static_cast<uint32_t>(_mm_movemask_epi8(m));
+}
+
+inline uint32_t simdStopMask(const char* p) {
+  __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+  __m128i m = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('"')),
+                                        _mm_cmpeq_epi8(v, _mm_set1_epi8('\''))),
+                           _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\\')),
+                                        _mm_cmpeq_epi8(v, _mm_setzero_si128())));
+  return static_cast<uint32_t>(_mm_movemask_epi8(m));
+}
+
+inline size_t simdFirstBit(uint32_t mask) {
+  return static_cast<size_t>(__builtin_ctz(mask));
+}
+
+inline uint32_t simdInvert(uint32_t mask) {
+  return ~mask & 0xFFFF;
+}
+#  else  // NEON
+const size_t simdBlockSize = 16;
+
+// NEON has no movemask: narrowing the comparison gives 4 bits per character
+inline uint64_t simdMask(uint8x16_t m) {
+  return vget_lane_u64(
+      vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(m), 4)), 0);
+}
+
+// Nibble i is set if character i of the block is whitespace, resp. a stop
+inline uint64_t simdSpaceMask(const char* p) {
+  uint8x16_t v = vld1q_u8(reinterpret_cast<const uint8_t*>(p));
+  return simdMask(vorrq_u8(vorrq_u8(vceqq_u8(v, vdupq_n_u8(' ')),
+                                    vceqq_u8(v, vdupq_n_u8('\t'))),
+                           vorrq_u8(vceqq_u8(v, vdupq_n_u8('\r')),
+                                    vceqq_u8(v, vdupq_n_u8('\n')))));
+}
+
+inline uint64_t simdStopMask(const char* p) {
+  uint8x16_t v = vld1q_u8(reinterpret_cast<const uint8_t*>(p));
+  return simdMask(vorrq_u8(vorrq_u8(vceqq_u8(v, vdupq_n_u8('"')),
+                                    vceqq_u8(v, vdupq_n_u8('\''))),
+                           vorrq_u8(vceqq_u8(v, vdupq_n_u8('\\')),
+                                    vceqq_u8(v, vdupq_n_u8(0)))));
+}
+
+inline size_t simdFirstBit(uint64_t mask) {
+  return static_cast<size_t>(__builtin_ctzll(mask)) / 4;
+}
+
+inline uint64_t simdInvert(uint64_t mask) {
+  return ~mask;
+}
+#  endif
+#endif
+
+// Length of the whitespace at the beginning of the input
+inline size_t scanSpaces(const char* p, const char* end) {
+  const char* s = p;
+  if (end) {
+#if ARDUINOJSON_ENABLE_SIMD
+    while (static_cast<size_t>(end - s) >= simdBlockSize) {
+      auto others = simdInvert(simdSpaceMask(s));
+      if (others)
+        return static_cast<size_t>(s - p) + simdFirstBit(others);
+      s += simdBlockSize;
+    }
+#endif
+    while (s < end && isJsonSpace(*s))
+      s++;
+  } else {
+    while (isJsonSpace(*s))
+      s++;
+  }
+  return static_cast<size_t>(s - p);
+}
+
+// Length of the characters at the beginning of the input that a quoted
+// string copies as is
+inline size_t scanStringChars(const char* p, const char* end) {
+  const char* s = p;
+  if (end) {
+#if ARDUINOJSON_ENABLE_SIMD
+    while (static_cast<size_t>(end - s) >= simdBlockSize) {
+      auto stops = simdStopMask(s);
+      if (stops)
+        return static_cast<size_t>(s - p) + simdFirstBit(stops);
+      s += simdBlockSize;
+    }
+#endif
+    while (s < end && !isStringStop(*s))
+      s++;
+  } else {
+    while (!isStringStop(*s))
+      s++;
+  }
+  return static_cast<size_t>(s - p);
+}
+
+ARDUINOJSON_END_PRIVATE_NAMESPACE
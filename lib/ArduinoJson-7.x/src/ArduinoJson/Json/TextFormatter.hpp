@@ -10,6 +10,13 @@
 #include <ArduinoJson/Json/EscapeSequence.hpp>
 #include <ArduinoJson/Numbers/FloatParts.hpp>
 #include <ArduinoJson/Numbers/JsonInteger.hpp>
+#if ARDUINOJSON_DIGIT_PAIRS
+#  include <ArduinoJson/Numbers/formatInteger.hpp>
+#endif
+#if ARDUINOJSON_SHORTEST_FLOAT
+#  include <ArduinoJson/Numbers/FloatTraits.hpp>
+#  include <ArduinoJson/Numbers/floatToDecimal.hpp>
+#endif
 #include <ArduinoJson/Polyfills/assert.hpp>
 #include <ArduinoJson/Polyfills/attributes.hpp>
 #include <ArduinoJson/Polyfills/type_traits.hpp>
@@ -38,21 +45,45 @@ class TextFormatter {
 
   void writeString(const char* value) {
     ARDUINOJSON_ASSERT(value != NULL);
+#if ARDUINOJSON_ESCAPE_TABLE
+    writeString(value, strlen(value));
+#else
     writeRaw('\"');
     while (*value)
       writeChar(*value++);
     writeRaw('\"');
+#endif
   }
 
   void writeString(const char* value, size_t n) {
     ARDUINOJSON_ASSERT(value != NULL);
     writeRaw('\"');
+#if ARDUINOJSON_ESCAPE_TABLE
+    const char* run = value;  // characters that need no escaping
+    for (const char* end = value + n; value < end; value++) {
+      char specialChar = EscapeSequence::escapeCharFast(*value);
+      if (specialChar) {
+        writeRun(run, value);
+        writeEscaped(specialChar);
+        run = value + 1;
+      }
+    }
+    writeRun(run, value);
+#else
     while (n--)
       writeChar(*value++);
+#endif
     writeRaw('\"');
   }
 
   void writeChar(char c) {
+#if ARDUINOJSON_ESCAPE_TABLE
+    char specialChar = EscapeSequence::escapeCharFast(c);
+    if (specialChar)
+      writeEscaped(specialChar);
+    else
+      writeRaw(c);
+#else
     char specialChar = EscapeSequence::escapeChar(c);
     if (specialChar) {
       writeRaw('\\');
@@ -62,11 +93,16 @@ class TextFormatter {
     } else {
       writeRaw("\\u0000");
     }
+#endif
   }
 
   template <typename T>
   void writeFloat(T value) {
+#if ARDUINOJSON_SHORTEST_FLOAT
+    writeShortestFloat(value);
+#else
     writeFloat(JsonFloat(value), sizeof(T) >= 8 ? 9 : 6);
+#endif
   }
 
   void writeFloat(JsonFloat value, int8_t decimalPlaces) {
@@ -118,6 +154,14 @@ class TextFormatter {
 
   template <typename T>
   enable_if_t<is_unsigned<T>::value> writeInteger(T value) {
+#if ARDUINOJSON_DIGIT_PAIRS
+    if (value < 10)
+      return writeRaw(char('0' + value));
+
+    char buffer[20];
+    char* end = buffer + sizeof(buffer);
+    writeRaw(formatInteger(value, end), end);
+#else
     char buffer[22];
     char* end = buffer + sizeof(buffer);
     char* begin = end;
@@ -130,12 +174,16 @@ class TextFormatter {
 
     // and dump it in the right order
     writeRaw(begin, end);
+#endif
   }
 
   void writeDecimals(uint32_t value, int8_t width) {
     // buffer should be big enough for all digits and the dot
     char buffer[16];
     char* end = buffer + sizeof(buffer);
+#if ARDUINOJSON_DIGIT_PAIRS
+    char* begin = formatDigits(value, width, end);
+#else
     char* begin = end;
 
     // write the string in reverse order
@@ -143,6 +191,7 @@ class TextFormatter {
       *--begin = char(value % 10 + '0');
       value /= 10;
     }
+#endif
     *--begin = '.';
 
     // and dump it in the right order
@@ -172,6 +221,106 @@ class TextFormatter {
 
  protected:
   CountingDecorator<TWriter> writer_;
+
+ private:
+#if ARDUINOJSON_SHORTEST_FLOAT
+  // Writes the fewest digits that parse back to value, in the same notation
+  // as writeFloat(JsonFloat, int8_t)
+  template <typename T>
+  void writeShortestFloat(T value) {
+    if (isnan(value))
+      return writeRaw(ARDUINOJSON_ENABLE_NAN ? "NaN" : "null");
+
+    if (isinf(value)) {
+#  if ARDUINOJSON_ENABLE_INFINITY
+      return writeRaw(value < 0 ? "-Infinity" : "Infinity");
+#  else
+      return writeRaw("null");
+#  endif
+    }
+
+    if (value < 0) {
+      writeRaw('-');
+      value = -value;
+    }
+
+    if (value == 0)
+      return writeRaw('0');
+
+    auto decimal = floatToDecimal(
+        alias_cast<typename FloatTraits<T>::mantissa_type>(value));
+    bool scientific =
+        value >= ARDUINOJSON_POSITIVE_EXPONENTIATION_THRESHOLD ||
+        value <= ARDUINOJSON_NEGATIVE_EXPONENTIATION_THRESHOLD;
+    writeDecimal(decimal.digits, decimal.exponent, scientific);
+  }
+
+  // Writes digits * 10^exponent
+  template <typename TUInt>
+  void writeDecimal(TUInt digits, int32_t exponent, bool scientific) {
+    while (digits % 10 == 0) {
+      digits = TUInt(digits / 10);
+      exponent++;
+    }
+
+    char buffer[24];
+    char* end = buffer + sizeof(buffer);
+#  if ARDUINOJSON_DIGIT_PAIRS
+    char* begin = formatInteger(digits, end);
+#  else
+    char* begin = end;
+    do {
+      *--begin = char(digits % 10 + '0');
+      digits = TUInt(digits / 10);
+    } while (digits);
+#  endif
+    int32_t count = int32_t(end - begin);
+
+    // position of the first digit: 10^point
+    int32_t point = exponent + count - 1;
+
+    if (scientific) {
+      writeRaw(begin[0]);
+      if (count > 1) {
+        writeRaw('.');
+        writeRaw(begin + 1, end);
+      }
+      writeRaw('e');
+      writeInteger(point);
+    } else if (point < 0) {
+      writeRaw('0');
+      writeRaw('.');
+      for (int32_t i = point + 1; i < 0; i++)
+        writeRaw('0');
+      writeRaw(begin, end);
+    } else if (point + 1 >= count) {
+      writeRaw(begin, end);
+      for (int32_t i = count; i <= point; i++)
+        writeRaw('0');
+    } else {
+      writeRaw(begin, begin + point + 1);
+      writeRaw('.');
+      writeRaw(begin + point + 1, end);
+    }
+  }
+#endif
+
+#if ARDUINOJSON_ESCAPE_TABLE
+  void writeRun(const char* begin, const char* end) {
+    if (begin != end)
+      writeRaw(begin, end);
+  }
+
+  // specialChar comes from EscapeSequence::escapeCharFast()
+  void writeEscaped(char specialChar) {
+    if (specialChar == 'u') {
+      writeRaw("\\u0000");
+    } else {
+      const char sequence[] = {'\\', specialChar};
+      writeRaw(sequence, 2);
+    }
+  }
+#endif
 };
 
 ARDUINOJSON_END_PRIVATE_NAMESPACE
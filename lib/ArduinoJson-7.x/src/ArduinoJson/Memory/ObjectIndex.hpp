@@ -0,0 +1,224 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2025, Benoit BLANCHON
+// MIT License
+
+#pragma once
+
+#include <ArduinoJson/Memory/Allocator.hpp>
+#include <ArduinoJson/Memory/MemoryPool.hpp>
+#include <ArduinoJson/Polyfills/assert.hpp>
+#include <ArduinoJson/Polyfills/utility.hpp>
+
+#include <stdint.h>  // uintptr_t
+#include <string.h>  // memmove
+
+ARDUINOJSON_BEGIN_PRIVATE_NAMESPACE
+
+class CollectionData;
+
+// Open-addressed table from the key hashes of one object to the slots of the
+// keys, with linear probing. Members are indexed lazily: lastKey is the
+// newest key in the table, the members after it are added by the next lookup
+// (the deserializers append a member before saving its key).
+struct ObjectIndex {
+  struct Entry {
+    SlotId key;  // NULL_SLOT for an empty entry
+    uint32_t hash;
+  };
+
+  static const size_t initialCapacity = 32;  // power of two
+
+  const CollectionData* object;
+  SlotId lastKey;  // NULL_SLOT when nothing is indexed yet
+  Entry* entries;
+  size_t capacity;
+  size_t count;
+
+  // Returns the first key with this hash for which match(key) is true
+  template <typename TMatch>
+  SlotId find(uint32_t hash, const TMatch& match) const {
+    if (!entries)
+      return NULL_SLOT;
+    size_t mask = capacity - 1;
+    for (size_t i = hash & mask; entries[i].key != NULL_SLOT;
+         i = (i + 1) & mask) {
+      if (entries[i].hash == hash && match(entries[i].key))
+        return entries[i].key;
+    }
+    return NULL_SLOT;
+  }
+
+  bool insert(SlotId key, uint32_t hash, Allocator* allocator) {
+    // keep the load factor under 3/4
+    if ((count + 1) * 4 > capacity * 3 && !grow(allocator))
+      return false;
+    place(entries, capacity, key, hash);
+    count++;
+    return true;
+  }
+
+  // Does nothing if the key isn't indexed yet
+  void erase(SlotId key, uint32_t hash) {
+    if (!entries)
+      return;
+    size_t mask = capacity - 1;
+    size_t i = hash & mask;
+    while (entries[i].key != key) {
+      if (entries[i].key == NULL_SLOT)
+        return;
+      i = (i + 1) & mask;
+    }
+    // backward-shift deletion: move up the entries that probed past i
+    for (size_t j = (i + 1) & mask; entries[j].key != NULL_SLOT;
+         j = (j + 1) & mask) {
+      size_t home = entries[j].hash & mask;
+      if (((j - home) & mask) >= ((j - i) & mask)) {
+        entries[i] = entries[j];
+        i = j;
+      }
+    }
+    entries[i].key = NULL_SLOT;
+    count--;
+  }
+
+  void release(Allocator* allocator) {
+    if (entries)
+      allocator->deallocate(entries);
+    entries = nullptr;
+    capacity = 0;
+    count = 0;
+  }
+
+  size_t size() const {
+    return capacity * sizeof(Entry);
+  }
+
+  bool grow(Allocator* allocator) {
+    size_t newCapacity = capacity ? capacity * 2 : initialCapacity;
+    if (newCapacity > size_t(-1) / sizeof(Entry))
+      return false;
+    auto newEntries = reinterpret_cast<Entry*>(
+        allocator->allocate(newCapacity * sizeof(Entry)));
+    if (!newEntries)
+      return false;
+    for (size_t i = 0; i < newCapacity; i++)
+      newEntries[i].key = NULL_SLOT;
+    for (size_t i = 0; i < capacity; i++) {
+      if (entries[i].key != NULL_SLOT)
+        place(newEntries, newCapacity, entries[i].key, entries[i].hash);
+    }
+    if (entries)
+      allocator->deallocate(entries);
+    entries = newEntries;
+    capacity = newCapacity;
+    return true;
+  }
+
+  static void place(Entry* table, size_t size, SlotId key, uint32_t hash) {
+    size_t mask = size - 1;
+    size_t i = hash & mask;
+    while (table[i].key != NULL_SLOT)
+      i = (i + 1) & mask;
+    table[i].key = key;
+    table[i].hash = hash;
+  }
+};
+
+// The indexes of the large objects of a document, sorted by the address of
+// the object. They're dropped when the object is cleared and when the pools
+// may move (shrinkToFit(), swap()); lookups rebuild them.
+class ObjectIndexList {
+ public:
+  ObjectIndexList() = default;
+  ObjectIndexList(const ObjectIndexList&) = delete;
+  ObjectIndexList& operator=(const ObjectIndexList&) = delete;
+
+  ~ObjectIndexList() {
+    ARDUINOJSON_ASSERT(items_ == nullptr);
+  }
+
+  ObjectIndex* get(const CollectionData* object) const {
+    if (!count_)
+      return nullptr;
+    size_t i = lowerBound(object);
+    if (i < count_ && items_[i].object == object)
+      return &items_[i];
+    return nullptr;
+  }
+
+  // Adds an empty index; object must not have one yet.
+  // Invalidates the pointers returned by get().
+  ObjectIndex* add(const CollectionData* object, Allocator* allocator) {
+    ARDUINOJSON_ASSERT(get(object) == nullptr);
+    if (count_ == capacity_ && !grow(allocator))
+      return nullptr;
+    size_t i = lowerBound(object);
+    memmove(items_ + i + 1, items_ + i, (count_ - i) * sizeof(ObjectIndex));
+    count_++;
+    items_[i] = ObjectIndex{object, NULL_SLOT, nullptr, 0, 0};
+    return &items_[i];
+  }
+
+  void remove(const CollectionData* object, Allocator* allocator) {
+    auto index = get(object);
+    if (!index)
+      return;
+    index->release(allocator);
+    size_t i = size_t(index - items_);
+    memmove(items_ + i, items_ + i + 1,
+            (count_ - i - 1) * sizeof(ObjectIndex));
+    count_--;
+  }
+
+  void clear(Allocator* allocator) {
+    for (size_t i = 0; i < count_; i++)
+      items_[i].release(allocator);
+    if (items_)
+      allocator->deallocate(items_);
+    items_ = nullptr;
+    count_ = 0;
+    capacity_ = 0;
+  }
+
+  size_t size() const {
+    size_t total = capacity_ * sizeof(ObjectIndex);
+    for (size_t i = 0; i < count_; i++)
+      total += items_[i].size();
+    return total;
+  }
+
+ private:
+  size_t lowerBound(const CollectionData* object) const {
+    auto address = reinterpret_cast<uintptr_t>(object);
+    size_t first = 0, last = count_;
+    while (first < last) {
+      size_t middle = first + (last - first) / 2;
+      if (reinterpret_cast<uintptr_t>(items_[middle].object) < address)
+        first = middle + 1;
+      else
+        last = middle;
+    }
+    return first;
+  }
+
+  bool grow(Allocator* allocator) {
+    size_t newCapacity = capacity_ ? capacity_ * 2 : 4;
+    if (newCapacity > size_t(-1) / sizeof(ObjectIndex))
+      return false;
+    size_t bytes = newCapacity * sizeof(ObjectIndex);
+    auto newItems = reinterpret_cast<ObjectIndex*>(
+        items_ ? allocator->reallocate(items_, bytes)
+               : allocator->allocate(bytes));
+    if (!newItems)
+      return false;
+    items_ = newItems;
+    capacity_ = newCapacity;
+    return true;
+  }
+
+  ObjectIndex* items_ = nullptr;
+  size_t count_ = 0;
+  size_t capacity_ = 0;
+};
+
+ARDUINOJSON_END_PRIVATE_NAMESPACE
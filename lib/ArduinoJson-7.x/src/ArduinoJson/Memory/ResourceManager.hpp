@@ -6,6 +6,7 @@
 
 #include <ArduinoJson/Memory/Allocator.hpp>
 #include <ArduinoJson/Memory/MemoryPoolList.hpp>
+#include <ArduinoJson/Memory/ObjectIndex.hpp>
 #include <ArduinoJson/Memory/StringPool.hpp>
 #include <ArduinoJson/Polyfills/assert.hpp>
 #include <ArduinoJson/Polyfills/utility.hpp>
@@ -32,6 +33,9 @@ class ResourceManager {
       : allocator_(allocator), overflowed_(false) {}
 
   ~ResourceManager() {
+#if ARDUINOJSON_OBJECT_INDEX
+    objectIndexes_.clear(allocator_);
+#endif
     stringPool_.clear(allocator_);
     variantPools_.clear(allocator_);
   }
@@ -40,6 +44,11 @@ class ResourceManager {
   ResourceManager& operator=(const ResourceManager& src) = delete;
 
   friend void swap(ResourceManager& a, ResourceManager& b) {
+#if ARDUINOJSON_OBJECT_INDEX
+    // the indexes refer to the objects by address
+    a.objectIndexes_.clear(a.allocator_);
+    b.objectIndexes_.clear(b.allocator_);
+#endif
     swap(a.stringPool_, b.stringPool_);
     swap(a.variantPools_, b.variantPools_);
     swap_(a.allocator_, b.allocator_);
@@ -51,7 +60,11 @@ class ResourceManager {
   }
 
   size_t size() const {
+#if ARDUINOJSON_OBJECT_INDEX
+    return variantPools_.size() + stringPool_.size() + objectIndexes_.size();
+#else
     return variantPools_.size() + stringPool_.size();
+#endif
   }
 
   bool overflowed() const {
@@ -81,7 +94,7 @@ class ResourceManager {
   }
 
   void saveString(StringNode* node) {
-    stringPool_.add(node);
+    stringPool_.add(node, allocator_);
   }
 
   template <typename TAdaptedString>
@@ -111,13 +124,35 @@ class ResourceManager {
     stringPool_.dereference(s, allocator_);
   }
 
+#if ARDUINOJSON_OBJECT_INDEX
+  // Lookups build the indexes, hence the const
+  ObjectIndex* getObjectIndex(const CollectionData* object) const {
+    return objectIndexes_.get(object);
+  }
+
+  ObjectIndex* addObjectIndex(const CollectionData* object) const {
+    return objectIndexes_.add(object, allocator_);
+  }
+
+  void removeObjectIndex(const CollectionData* object) const {
+    objectIndexes_.remove(object, allocator_);
+  }
+#endif
+
   void clear() {
+#if ARDUINOJSON_OBJECT_INDEX
+    objectIndexes_.clear(allocator_);
+#endif
     variantPools_.clear(allocator_);
     overflowed_ = false;
     stringPool_.clear(allocator_);
   }
 
   void shrinkToFit() {
+#if ARDUINOJSON_OBJECT_INDEX
+    // the last pool may move, and the objects in it
+    objectIndexes_.clear(allocator_);
+#endif
     variantPools_.shrinkToFit(allocator_);
   }
 
@@ -126,6 +161,9 @@ class ResourceManager {
   bool overflowed_;
   StringPool stringPool_;
   MemoryPoolList<SlotData> variantPools_;
+#if ARDUINOJSON_OBJECT_INDEX
+  mutable ObjectIndexList objectIndexes_;
+#endif
 };
 
 ARDUINOJSON_END_PRIVATE_NAMESPACE
@@ -20,10 +20,19 @@ class StringPool {
 
   ~StringPool() {
     ARDUINOJSON_ASSERT(strings_ == nullptr);
+#if ARDUINOJSON_STRING_POOL_INDEX
+    ARDUINOJSON_ASSERT(index_ == nullptr);
+#endif
   }
 
   friend void swap(StringPool& a, StringPool& b) {
     swap_(a.strings_, b.strings_);
+#if ARDUINOJSON_STRING_POOL_INDEX
+    swap_(a.index_, b.index_);
+    swap_(a.indexCapacity_, b.indexCapacity_);
+    swap_(a.indexCount_, b.indexCount_);
+    swap_(a.indexFailed_, b.indexFailed_);
+#endif
   }
 
   void clear(Allocator* allocator) {
@@ -32,12 +41,23 @@ class StringPool {
       strings_ = node->next;
       StringNode::destroy(node, allocator);
     }
+#if ARDUINOJSON_STRING_POOL_INDEX
+    if (index_)
+      allocator->deallocate(index_);
+    index_ = nullptr;
+    indexCapacity_ = 0;
+    indexCount_ = 0;
+    indexFailed_ = false;
+#endif
   }
 
   size_t size() const {
     size_t total = 0;
     for (auto node = strings_; node; node = node->next)
       total += sizeofString(node->length);
+#if ARDUINOJSON_STRING_POOL_INDEX
+    total += indexCapacity_ * sizeof(IndexEntry);
+#endif
     return total;
   }
 
@@ -45,7 +65,12 @@ class StringPool {
   StringNode* add(TAdaptedString str, Allocator* allocator) {
     ARDUINOJSON_ASSERT(str.isNull() == false);
 
+#if ARDUINOJSON_STRING_POOL_INDEX
+    uint32_t hash = stringHash(str);
+    auto node = find(str, hash);
+#else
     auto node = get(str);
+#endif
     if (node) {
       node->references++;
       return node;
@@ -59,23 +84,31 @@ class StringPool {
 
     stringGetChars(str, node->data, n);
     node->data[n] = 0;  // force NUL terminator
-    add(node);
+    link(node);
+#if ARDUINOJSON_STRING_POOL_INDEX
+    addToIndex(node, hash, allocator);
+#endif
     return node;
   }
 
-  void add(StringNode* node) {
+  void add(StringNode* node, Allocator* allocator) {
     ARDUINOJSON_ASSERT(node != nullptr);
-    node->next = strings_;
-    strings_ = node;
+    link(node);
+#if ARDUINOJSON_STRING_POOL_INDEX
+    addToIndex(node, stringHash(adaptString(node->data, node->length)),
+               allocator);
+#else
+    (void)allocator;
+#endif
   }
 
   template <typename TAdaptedString>
   StringNode* get(const TAdaptedString& str) const {
-    for (auto node = strings_; node; node = node->next) {
-      if (stringEquals(str, adaptString(node->data, node->length)))
-        return node;
-    }
-    return nullptr;
+#if ARDUINOJSON_STRING_POOL_INDEX
+    return find(str, stringHash(str));
+#else
+    return findInList(str);
+#endif
   }
 
   void dereference(const char* s, Allocator* allocator) {
@@ -87,6 +120,9 @@ class StringPool {
             prev->next = node->next;
           else
             strings_ = node->next;
+#if ARDUINOJSON_STRING_POOL_INDEX
+          removeFromIndex(node);
+#endif
           StringNode::destroy(node, allocator);
         }
         return;
@@ -96,6 +132,124 @@ class StringPool {
   }
 
  private:
+  void link(StringNode* node) {
+    node->next = strings_;
+    strings_ = node;
+  }
+
+  template <typename TAdaptedString>
+  StringNode* findInList(const TAdaptedString& str) const {
+    for (auto node = strings_; node; node = node->next) {
+      if (stringEquals(str, adaptString(node->data, node->length)))
+        return node;
+    }
+    return nullptr;
+  }
+
+#if ARDUINOJSON_STRING_POOL_INDEX
+  // Open-addressed table with linear probing over the nodes of the list.
+  // Entries cache the hash, so a probe compares the hash and the length
+  // before touching any character. If the table can't grow, it's dropped
+  // and lookups fall back to the list until the pool is cleared.
+  struct IndexEntry {
+    StringNode* node;  // nullptr for an empty entry
+    uint32_t hash;
+  };
+
+  static const size_t initialIndexCapacity = 16;  // power of two
+
+  template <typename TAdaptedString>
+  StringNode* find(const TAdaptedString& str, uint32_t hash) const {
+    if (!index_)
+      return findInList(str);
+    size_t mask = indexCapacity_ - 1;
+    size_t n = str.size();
+    for (size_t i = hash & mask; index_[i].node; i = (i + 1) & mask) {
+      const IndexEntry& entry = index_[i];
+      if (entry.hash == hash && entry.node->length == n &&
+          stringEquals(str, adaptString(entry.node->data, n)))
+        return entry.node;
+    }
+    return nullptr;
+  }
+
+  void addToIndex(StringNode* node, uint32_t hash, Allocator* allocator) {
+    if (indexFailed_)
+      return;
+    // keep the load factor under 3/4
+    if ((indexCount_ + 1) * 4 > indexCapacity_ * 3 && !growIndex(allocator)) {
+      if (index_)
+        allocator->deallocate(index_);
+      index_ = nullptr;
+      indexCapacity_ = 0;
+      indexCount_ = 0;
+      indexFailed_ = true;
+      return;
+    }
+    insert(index_, indexCapacity_, node, hash);
+    indexCount_++;
+  }
+
+  bool growIndex(Allocator* allocator) {
+    size_t capacity =
+        indexCapacity_ ? indexCapacity_ * 2 : initialIndexCapacity;
+    if (capacity > size_t(-1) / sizeof(IndexEntry))
+      return false;
+    auto index = reinterpret_cast<IndexEntry*>(
+        allocator->allocate(capacity * sizeof(IndexEntry)));
+    if (!index)
+      return false;
+    for (size_t i = 0; i < capacity; i++)
+      index[i].node = nullptr;
+    for (size_t i = 0; i < indexCapacity_; i++) {
+      if (index_[i].node)
+        insert(index, capacity, index_[i].node, index_[i].hash);
+    }
+    if (index_)
+      allocator->deallocate(index_);
+    index_ = index;
+    indexCapacity_ = capacity;
+    return true;
+  }
+
+  static void insert(IndexEntry* index, size_t capacity, StringNode* node,
+                     uint32_t hash) {
+    size_t mask = capacity - 1;
+    size_t i = hash & mask;
+    while (index[i].node)
+      i = (i + 1) & mask;
+    index[i].node = node;
+    index[i].hash = hash;
+  }
+
+  void removeFromIndex(StringNode* node) {
+    if (!index_)
+      return;
+    size_t mask = indexCapacity_ - 1;
+    uint32_t hash = stringHash(adaptString(node->data, node->length));
+    size_t i = hash & mask;
+    while (index_[i].node != node) {
+      ARDUINOJSON_ASSERT(index_[i].node != nullptr);
+      i = (i + 1) & mask;
+    }
+    // backward-shift deletion: move up the entries that probed past i
+    for (size_t j = (i + 1) & mask; index_[j].node; j = (j + 1) & mask) {
+      size_t home = index_[j].hash & mask;
+      if (((j - home) & mask) >= ((j - i) & mask)) {
+        index_[i] = index_[j];
+        i = j;
+      }
+    }
+    index_[i].node = nullptr;
+    indexCount_--;
+  }
+
+  IndexEntry* index_ = nullptr;
+  size_t indexCapacity_ = 0;
+  size_t indexCount_ = 0;
+  bool indexFailed_ = false;
+#endif
+
   StringNode* strings_ = nullptr;
 };
 
@@ -11,7 +11,7 @@
 #ifndef ARDUINOJSON_VERSION_NAMESPACE
 
 #  define ARDUINOJSON_VERSION_NAMESPACE                               \
-    ARDUINOJSON_CONCAT5(                                              \
+    ARDUINOJSON_CONCAT7(                                              \
         ARDUINOJSON_VERSION_MACRO,                                    \
         ARDUINOJSON_BIN2ALPHA(ARDUINOJSON_ENABLE_PROGMEM,             \
                               ARDUINOJSON_USE_LONG_LONG,              \
@@ -19,6 +19,13 @@
         ARDUINOJSON_BIN2ALPHA(                                        \
             ARDUINOJSON_ENABLE_NAN, ARDUINOJSON_ENABLE_INFINITY,      \
             ARDUINOJSON_ENABLE_COMMENTS, ARDUINOJSON_DECODE_UNICODE), \
+        ARDUINOJSON_BIN2ALPHA(ARDUINOJSON_OBJECT_INDEX,               \
+                              ARDUINOJSON_ESCAPE_TABLE,               \
+                              ARDUINOJSON_ENABLE_SIMD,                \
+                              ARDUINOJSON_EISEL_LEMIRE),              \
+        ARDUINOJSON_BIN2ALPHA(ARDUINOJSON_SHORTEST_FLOAT,             \
+                              ARDUINOJSON_DIGIT_PAIRS,                \
+                              ARDUINOJSON_STRING_POOL_INDEX, 0),      \
         ARDUINOJSON_SLOT_ID_SIZE, ARDUINOJSON_STRING_LENGTH_SIZE)
 
 #endif
@@ -0,0 +1,285 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2025, Benoit BLANCHON
+// MIT License
+
+#pragma once
+
+#include <ArduinoJson/Numbers/FloatTraits.hpp>
+#include <ArduinoJson/Polyfills/assert.hpp>
+#include <ArduinoJson/Polyfills/math.hpp>
+#include <ArduinoJson/Polyfills/pgmspace_generic.hpp>
+
+#include <stdint.h>
+
+ARDUINOJSON_BEGIN_PRIVATE_NAMESPACE
+
+// Eisel-Lemire algorithm: converts w * 10^q to the nearest float or double
+// with one or two 64x64-bit multiplications by a truncated power of five.
+// See Daniel Lemire, "Number Parsing at a Gigabyte per Second" (2021).
+// The table only covers the exponents of everyday values; decimalToFloat()
+// returns false for the others, for subnormals and for overflows.
+
+const int decimalMinExponent = -64;
+const int decimalMaxExponent = 63;
+
+// 5^q normalized to 128 bits, truncated if q >= 0, rounded up otherwise;
+// four 32-bit words per power, most significant first
+inline pgm_ptr<uint32_t> powersOfFive() {
+  ARDUINOJSON_DEFINE_PROGMEM_ARRAY(  //
+      uint32_t, factors,
+      {
+            0xA87FEA27, 0xA539E9A5, 0x3F2398D7, 0x47B36224,  // 5^-64
+            0xD29FE4B1, 0x8E88640E, 0x8EEC7F0D, 0x19A03AAD,  // 5^-63
+            0x83A3EEEE, 0xF9153E89, 0x1953CF68, 0x300424AC,  // 5^-62
+            0xA48CEAAA, 0xB75A8E2B, 0x5FA8C342, 0x3C052DD7,  // 5^-61
+            0xCDB02555, 0x653131B6, 0x3792F412, 0xCB06794D,  // 5^-60
+            0x808E1755, 0x5F3EBF11, 0xE2BBD88B, 0xBEE40BD0,  // 5^-59
+            0xA0B19D2A, 0xB70E6ED6, 0x5B6ACEAE, 0xAE9D0EC4,  // 5^-58
+            0xC8DE0475, 0x64D20A8B, 0xF245825A, 0x5A445275,  // 5^-57
+            0xFB158592, 0xBE068D2E, 0xEED6E2F0, 0xF0D56712,  // 5^-56
+            0x9CED737B, 0xB6C4183D, 0x55464DD6, 0x9685606B,  // 5^-55
+            0xC428D05A, 0xA4751E4C, 0xAA97E14C, 0x3C26B886,  // 5^-54
+            0xF5330471, 0x4D9265DF, 0xD53DD99F, 0x4B3066A8,  // 5^-53
+            0x993FE2C6, 0xD07B7FAB, 0xE546A803, 0x8EFE4029,  // 5^-52
+            0xBF8FDB78, 0x849A5F96, 0xDE985204, 0x72BDD033,  // 5^-51
+            0xEF73D256, 0xA5C0F77C, 0x963E6685, 0x8F6D4440,  // 5^-50
+            0x95A86376, 0x27989AAD, 0xDDE70013, 0x79A44AA8,  // 5^-49
+            0xBB127C53, 0xB17EC159, 0x5560C018, 0x580D5D52,  // 5^-48
+            0xE9D71B68, 0x9DDE71AF, 0xAAB8F01E, 0x6E10B4A6,  // 5^-47
+            0x92267121, 0x62AB070D, 0xCAB39613, 0x04CA70E8,  // 5^-46
+            0xB6B00D69, 0xBB55C8D1, 0x3D607B97, 0xC5FD0D22,  // 5^-45
+            0xE45C10C4, 0x2A2B3B05, 0x8CB89A7D, 0xB77C506A,  // 5^-44
+            0x8EB98A7A, 0x9A5B04E3, 0x77F3608E, 0x92ADB242,  // 5^-43
+            0xB267ED19, 0x40F1C61C, 0x55F038B2, 0x37591ED3,  // 5^-42
+            0xDF01E85F, 0x912E37A3, 0x6B6C46DE, 0xC52F6688,  // 5^-41
+            0x8B61313B, 0xBABCE2C6, 0x2323AC4B, 0x3B3DA015,  // 5^-40
+            0xAE397D8A, 0xA96C1B77, 0xABEC975E, 0x0A0D081A,  // 5^-39
+            0xD9C7DCED, 0x53C72255, 0x96E7BD35, 0x8C904A21,  // 5^-38
+            0x881CEA14, 0x545C7575, 0x7E50D641, 0x77DA2E54,  // 5^-37
+            0xAA242499, 0x697392D2, 0xDDE50BD1, 0xD5D0B9E9,  // 5^-36
+            0xD4AD2DBF, 0xC3D07787, 0x955E4EC6, 0x4B44E864,  // 5^-35
+            0x84EC3C97, 0xDA624AB4, 0xBD5AF13B, 0xEF0B113E,  // 5^-34
+            0xA6274BBD, 0xD0FADD61, 0xECB1AD8A, 0xEACDD58E,  // 5^-33
+            0xCFB11EAD, 0x453994BA, 0x67DE18ED, 0xA5814AF2,  // 5^-32
+            0x81CEB32C, 0x4B43FCF4, 0x80EACF94, 0x8770CED7,  // 5^-31
+            0xA2425FF7, 0x5E14FC31, 0xA1258379, 0xA94D028D,  // 5^-30
+            0xCAD2F7F5, 0x359A3B3E, 0x096EE458, 0x13A04330,  // 5^-29
+            0xFD87B5F2, 0x8300CA0D, 0x8BCA9D6E, 0x188853FC,  // 5^-28
+            0x9E74D1B7, 0x91E07E48, 0x775EA264, 0xCF55347E,  // 5^-27
+            0xC6120625, 0x76589DDA, 0x95364AFE, 0x032A819E,  // 5^-26
+            0xF79687AE, 0xD3EEC551, 0x3A83DDBD, 0x83F52205,  // 5^-25
+            0x9ABE14CD, 0x44753B52, 0xC4926A96, 0x72793543,  // 5^-24
+            0xC16D9A00, 0x95928A27, 0x75B7053C, 0x0F178294,  // 5^-23
+            0xF1C90080, 0xBAF72CB1, 0x5324C68B, 0x12DD6339,  // 5^-22
+            0x971DA050, 0x74DA7BEE, 0xD3F6FC16, 0xEBCA5E04,  // 5^-21
+            0xBCE50864, 0x92111AEA, 0x88F4BB1C, 0xA6BCF585,  // 5^-20
+            0xEC1E4A7D, 0xB69561A5, 0x2B31E9E3, 0xD06C32E6,  // 5^-19
+            0x9392EE8E, 0x921D5D07, 0x3AFF322E, 0x62439FD0,  // 5^-18
+            0xB877AA32, 0x36A4B449, 0x09BEFEB9, 0xFAD487C3,  // 5^-17
+            0xE69594BE, 0xC44DE15B, 0x4C2EBE68, 0x7989A9B4,  // 5^-16
+            0x901D7CF7, 0x3AB0ACD9, 0x0F9D3701, 0x4BF60A11,  // 5^-15
+            0xB424DC35, 0x095CD80F, 0x538484C1, 0x9EF38C95,  // 5^-14
+            0xE12E1342, 0x4BB40E13, 0x2865A5F2, 0x06B06FBA,  // 5^-13
+            0x8CBCCC09, 0x6F5088CB, 0xF93F87B7, 0x442E45D4,  // 5^-12
+            0xAFEBFF0B, 0xCB24AAFE, 0xF78F69A5, 0x1539D749,  // 5^-11
+            0xDBE6FECE, 0xBDEDD5BE, 0xB573440E, 0x5A884D1C,  // 5^-10
+            0x89705F41, 0x36B4A597, 0x31680A88, 0xF8953031,  // 5^-9
+            0xABCC7711, 0x8461CEFC, 0xFDC20D2B, 0x36BA7C3E,  // 5^-8
+            0xD6BF94D5, 0xE57A42BC, 0x3D329076, 0x04691B4D,  // 5^-7
+            0x8637BD05, 0xAF6C69B5, 0xA63F9A49, 0xC2C1B110,  // 5^-6
+            0xA7C5AC47, 0x1B478423, 0x0FCF80DC, 0x33721D54,  // 5^-5
+            0xD1B71758, 0xE219652B, 0xD3C36113, 0x404EA4A9,  // 5^-4
+            0x83126E97, 0x8D4FDF3B, 0x645A1CAC, 0x083126EA,  // 5^-3
+            0xA3D70A3D, 0x70A3D70A, 0x3D70A3D7, 0x0A3D70A4,  // 5^-2
+            0xCCCCCCCC, 0xCCCCCCCC, 0xCCCCCCCC, 0xCCCCCCCD,  // 5^-1
+            0x80000000, 0x00000000, 0x00000000, 0x00000000,  // 5^0
+            0xA0000000, 0x00000000, 0x00000000, 0x00000000,  // 5^1
+            0xC8000000, 0x00000000, 0x00000000, 0x00000000,  // 5^2
+            0xFA000000, 0x00000000, 0x00000000, 0x00000000,  // 5^3
+            0x9C400000, 0x00000000, 0x00000000, 0x00000000,  // 5^4
+            0xC3500000, 0x00000000, 0x00000000, 0x00000000,  // 5^5
+            0xF4240000, 0x00000000, 0x00000000, 0x00000000,  // 5^6
+            0x98968000, 0x00000000, 0x00000000, 0x00000000,  // 5^7
+            0xBEBC2000, 0x00000000, 0x00000000, 0x00000000,  // 5^8
+            0xEE6B2800, 0x00000000, 0x00000000, 0x00000000,  // 5^9
+            0x9502F900, 0x00000000, 0x00000000, 0x00000000,  // 5^10
+            0xBA43B740, 0x00000000, 0x00000000, 0x00000000,  // 5^11
+            0xE8D4A510, 0x00000000, 0x00000000, 0x00000000,  // 5^12
+            0x9184E72A, 0x00000000, 0x00000000, 0x00000000,  // 5^13
+            0xB5E620F4, 0x80000000, 0x00000000, 0x00000000,  // 5^14
+            0xE35FA931, 0xA0000000, 0x00000000, 0x00000000,  // 5^15
+            0x8E1BC9BF, 0x04000000, 0x00000000, 0x00000000,  // 5^16
+            0xB1A2BC2E, 0xC5000000, 0x00000000, 0x00000000,  // 5^17
+            0xDE0B6B3A, 0x76400000, 0x00000000, 0x00000000,  // 5^18
+            0x8AC72304, 0x89E80000, 0x00000000, 0x00000000,  // 5^19
+            0xAD78EBC5, 0xAC620000, 0x00000000, 0x00000000,  // 5^20
+            0xD8D726B7, 0x177A8000, 0x00000000, 0x00000000,  // 5^21
+            0x87867832, 0x6EAC9000, 0x00000000, 0x00000000,  // 5^22
+            0xA968163F, 0x0A57B400, 0x00000000, 0x00000000,  // 5^23
+            0xD3C21BCE, 0xCCEDA100, 0x00000000, 0x00000000,  // 5^24
+            0x84595161, 0x401484A0, 0x00000000, 0x00000000,  // 5^25
+            0xA56FA5B9, 0x9019A5C8, 0x00000000, 0x00000000,  // 5^26
+            0xCECB8F27, 0xF4200F3A, 0x00000000, 0x00000000,  // 5^27
+            0x813F3978, 0xF8940984, 0x40000000, 0x00000000,  // 5^28
+            0xA18F07D7, 0x36B90BE5, 0x50000000, 0x00000000,  // 5^29
+            0xC9F2C9CD, 0x04674EDE, 0xA4000000, 0x00000000,  // 5^30
+            0xFC6F7C40, 0x45812296, 0x4D000000, 0x00000000,  // 5^31
+            0x9DC5ADA8, 0x2B70B59D, 0xF0200000, 0x00000000,  // 5^32
+            0xC5371912, 0x364CE305, 0x6C280000, 0x00000000,  // 5^33
+            0xF684DF56, 0xC3E01BC6, 0xC7320000, 0x00000000,  // 5^34
+            0x9A130B96, 0x3A6C115C, 0x3C7F4000, 0x00000000,  // 5^35
+            0xC097CE7B, 0xC90715B3, 0x4B9F1000, 0x00000000,  // 5^36
+            0xF0BDC21A, 0xBB48DB20, 0x1E86D400, 0x00000000,  // 5^37
+            0x96769950, 0xB50D88F4, 0x13144480, 0x00000000,  // 5^38
+            0xBC143FA4, 0xE250EB31, 0x17D955A0, 0x00000000,  // 5^39
+            0xEB194F8E, 0x1AE525FD, 0x5DCFAB08, 0x00000000,  // 5^40
+            0x92EFD1B8, 0xD0CF37BE, 0x5AA1CAE5, 0x00000000,  // 5^41
+            0xB7ABC627, 0x050305AD, 0xF14A3D9E, 0x40000000,  // 5^42
+            0xE596B7B0, 0xC643C719, 0x6D9CCD05, 0xD0000000,  // 5^43
+            0x8F7E32CE, 0x7BEA5C6F, 0xE4820023, 0xA2000000,  // 5^44
+            0xB35DBF82, 0x1AE4F38B, 0xDDA2802C, 0x8A800000,  // 5^45
+            0xE0352F62, 0xA19E306E, 0xD50B2037, 0xAD200000,  // 5^46
+            0x8C213D9D, 0xA502DE45, 0x4526F422, 0xCC340000,  // 5^47
+            0xAF298D05, 0x0E4395D6, 0x9670B12B, 0x7F410000,  // 5^48
+            0xDAF3F046, 0x51D47B4C, 0x3C0CDD76, 0x5F114000,  // 5^49
+            0x88D8762B, 0xF324CD0F, 0xA5880A69, 0xFB6AC800,  // 5^50
+            0xAB0E93B6, 0xEFEE0053, 0x8EEA0D04, 0x7A457A00,  // 5^51
+            0xD5D238A4, 0xABE98068, 0x72A49045, 0x98D6D880,  // 5^52
+            0x85A36366, 0xEB71F041, 0x47A6DA2B, 0x7F864750,  // 5^53
+            0xA70C3C40, 0xA64E6C51, 0x999090B6, 0x5F67D924,  // 5^54
+            0xD0CF4B50, 0xCFE20765, 0xFFF4B4E3, 0xF741CF6D,  // 5^55
+            0x82818F12, 0x81ED449F, 0xBFF8F10E, 0x7A8921A4,  // 5^56
+            0xA321F2D7, 0x226895C7, 0xAFF72D52, 0x192B6A0D,  // 5^57
+            0xCBEA6F8C, 0xEB02BB39, 0x9BF4F8A6, 0x9F764490,  // 5^58
+            0xFEE50B70, 0x25C36A08, 0x02F236D0, 0x4753D5B4,  // 5^59
+            0x9F4F2726, 0x179A2245, 0x01D76242, 0x2C946590,  // 5^60
+            0xC722F0EF, 0x9D80AAD6, 0x424D3AD2, 0xB7B97EF5,  // 5^61
+            0xF8EBAD2B, 0x84E0D58B, 0xD2E08987, 0x65A7DEB2,  // 5^62
+            0x9B934C3B, 0x330C8577, 0x63CC55F4, 0x9F88EB2F,  // 5^63
+      });
+  return pgm_ptr<uint32_t>(factors);
+}
+
+// 10^0 to 10^9, which every float type represents exactly
+inline pgm_ptr<uint32_t> exactPowersOfTen() {
+  ARDUINOJSON_DEFINE_PROGMEM_ARRAY(  //
+      uint32_t, factors,
+      {
+          1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000,
+          1000000000,
+      });
+  return pgm_ptr<uint32_t>(factors);
+}
+
+template <typename T, size_t = sizeof(T)>
+struct DecimalTraits {};
+
+template <typename T>
+struct DecimalTraits<T, 8 /*64bits*/> {
+  static const int32_t exponent_bias = 1023;
+  static const int32_t infinite_power = 0x7FF;
+  // range of q where w * 10^q can fall halfway between two doubles
+  static const int min_round_to_even = -4;
+  static const int max_round_to_even = 23;
+};
+
+template <typename T>
+struct DecimalTraits<T, 4 /*32bits*/> {
+  static const int32_t exponent_bias = 127;
+  static const int32_t infinite_power = 0xFF;
+  static const int min_round_to_even = -17;
+  static const int max_round_to_even = 10;
+};
+
+inline int countLeadingZeros(uint64_t x) {
+#if defined(__GNUC__)
+  return __builtin_clzll(x);
+#else
+  int n = 0;
+  while (!(x & 0x8000000000000000)) {
+    x <<= 1;
+    n++;
+  }
+  return n;
+#endif
+}
+
+// w must be non-zero and have at most 19 digits
+template <typename T>
+inline bool decimalToFloat(uint64_t w, int q, T& result) {
+  using traits = FloatTraits<T>;
+  using decimal = DecimalTraits<T>;
+  const int mantissaBits = traits::mantissa_bits;
+
+  ARDUINOJSON_ASSERT(w != 0);
+
+#if defined(__FLT_EVAL_METHOD__)
+#  if __FLT_EVAL_METHOD__ == 0
+  // Clinger's fast path: if w and 10^q are exact, so is one multiplication
+  // or division
+  if (w <= (uint64_t(2) << mantissaBits) && q >= -9 && q <= 9) {
+    T factor = T(exactPowersOfTen()[q < 0 ? -q : q]);
+    result = q < 0 ? T(w) / factor : T(w) * factor;
+    return true;
+  }
+#  endif
+#endif
+
+  if (q < decimalMinExponent || q > decimalMaxExponent)
+    return false;
+
+  auto factor = powersOfFive();
+  intptr_t i = 4 * (q - decimalMinExponent);
+  uint64_t factorHigh = uint64_t(factor[i]) << 32 | factor[i + 1];
+
+  int zeros = countLeadingZeros(w);
+  w <<= zeros;
+
+  uint64_t low;
+  uint64_t high = multiply128(w, factorHigh, low);
+
+  // the low half of the power only matters if the bits below the rounding
+  // position are all ones
+  const uint64_t precisionMask = uint64_t(-1) >> (mantissaBits + 3);
+  if ((high & precisionMask) == precisionMask) {
+    uint64_t factorLow = uint64_t(factor[i + 2]) << 32 | factor[i + 3];
+    uint64_t ignored;
+    uint64_t carry = multiply128(w, factorLow, ignored);
+    low += carry;
+    if (carry > low)
+      high++;
+  }
+
+  int upperBit = int(high >> 63);
+  int shift = upperBit + 64 - mantissaBits - 3;
+  uint64_t mantissa = high >> shift;
+
+  // floor(q * log2(10)) + 63, with the binary exponent bias
+  int32_t power = ((int32_t(152170 + 65536) * q) >> 16) + 63 + upperBit -
+                  zeros + decimal::exponent_bias;
+  if (power <= 0)  // subnormal
+    return false;
+
+  // exactly halfway between two values: round to even
+  if (low <= 1 && q >= decimal::min_round_to_even &&
+      q <= decimal::max_round_to_even && (mantissa & 3) == 1 &&
+      (mantissa << shift) == high)
+    mantissa &= ~uint64_t(1);
+
+  mantissa += mantissa & 1;
+  mantissa >>= 1;
+  if (mantissa >= (uint64_t(2) << mantissaBits)) {
+    mantissa = uint64_t(1) << mantissaBits;
+    power++;
+  }
+  mantissa &= ~(uint64_t(1) << mantissaBits);
+
+  if (power >= decimal::infinite_power)
+    return false;
+
+  uint64_t bits = mantissa | uint64_t(power) << mantissaBits;
+  result = traits::forge(typename traits::mantissa_type(bits));
+  return true;
+}
+
+ARDUINOJSON_END_PRIVATE_NAMESPACE
@@ -0,0 +1,71 @@
+// ArduinoJson - https://arduinojson.org
+// Copyright © 2014-2025, Benoit BLANCHON
+// MIT License
+
+#pragma once
+
+#include <ArduinoJson/Namespace.hpp>
+#include <ArduinoJson/Polyfills/type_traits.hpp>
+
+#include <stdint.h>
+
+ARDUINOJSON_BEGIN_PRIVATE_NAMESPACE
+
+// Writes the decimal digits of an integer backwards, two at a time from a
+// table of the pairs 00 to 99. Each function takes the end of the buffer and
+// returns the first digit.
+
+// The digits of i, for i in [0, 100), are at [2 * i, 2 * i + 2)
+inline const char* digitPairs() {
+  static const char pairs[201] =
+      "0001020304050607080910111213141516171819"
+      "2021222324252627282930313233343536373839"
+      "4041424344454647484950515253545556575859"
+      "6061626364656667686970717273747576777879"
+      "8081828384858687888990919293949596979899";
+  return pairs;
+}
+
+inline char* formatPair(uint32_t value, char* end) {
+  const char* pair = digitPairs() + 2 * value;
+  *--end = pair[1];
+  *--end = pair[0];
+  return end;
+}
+
+// Writes exactly width digits, with leading zeros
+inline char* formatDigits(uint32_t value, int width, char* end) {
+  for (; width >= 2; width -= 2) {
+    end = formatPair(value % 100, end);
+    value /= 100;
+  }
+  if (width)
+    *--end = char('0' + value);
+  return end;
+}
+
+// Writes the digits without leading zeros
+inline char* formatInteger(uint32_t value, char* end) {
+  while (value >= 100) {
+    end = formatPair(value % 100, end);
+    value /= 100;
+  }
+  if (value >= 10)
+    return formatPair(value, end);
+  *--end = char('0' + value);
+  return end;
+}
+
+// On a 32-bit processor, a 64-bit division is a library call: only divide by
+// 10^8 with it, and format each group of 8 digits with 32-bit operations
+template <typename T>
+enable_if_t<(sizeof(T) > 4), char*> formatInteger(T value, char* end) {
+  while (value > 0xFFFFFFFF) {
+    T high = T(value / 100000000);
+    end = formatDigits(uint32_t(value - high * 100000000), 8, end);
+    value = high;
+  }
+  return formatInteger(uint32_t(value), end);
+}
+
+ARDUINOJSON_END_PRIVATE_NAMESPACE
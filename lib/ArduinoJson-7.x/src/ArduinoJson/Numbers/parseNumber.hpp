@@ -12,6 +12,12 @@
 #include <ArduinoJson/Polyfills/math.hpp>
 #include <ArduinoJson/Polyfills/type_traits.hpp>
 
+#if ARDUINOJSON_EISEL_LEMIRE
+#  include <ArduinoJson/Numbers/decimalToFloat.hpp>
+
+#  include <string.h>  // memcpy, strlen
+#endif
+
 ARDUINOJSON_BEGIN_PRIVATE_NAMESPACE
 
 template <typename A, typename B>
@@ -102,7 +108,151 @@ class Number {
 #endif
 };
 
-inline Number parseNumber(const char* s) {
+#if ARDUINOJSON_EISEL_LEMIRE
+#  if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+// Tests and converts eight ASCII digits at once (SWAR); the first digit is in
+// the lowest byte
+inline bool isEightDigits(uint64_t chunk) {
+  return !(((chunk + 0x4646464646464646) | (chunk - 0x3030303030303030)) &
+           0x8080808080808080);
+}
+
+inline uint32_t parseEightDigits(uint64_t chunk) {
+  const uint64_t mask = 0x000000FF000000FF;
+  const uint64_t mul1 = 0x000F424000000064;  // 100 + (1000000 << 32)
+  const uint64_t mul2 = 0x0000271000000001;  // 1 + (10000 << 32)
+  chunk -= 0x3030303030303030;
+  chunk = (chunk * 10) + (chunk >> 8);  // pairs of digits
+  return uint32_t(
+      (((chunk & mask) * mul1) + (((chunk >> 16) & mask) * mul2)) >> 32);
+}
+#  endif
+
+// Appends the digits at p to w, returns the position after the last digit.
+// w wraps around after 19 digits.
+inline const char* parseDigits(const char* p, const char* end, uint64_t& w) {
+#  if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  while (end - p >= 8) {
+    uint64_t chunk;
+    memcpy(&chunk, p, 8);
+    if (!isEightDigits(chunk))
+      break;
+    w = w * 100000000 + parseEightDigits(chunk);
+    p += 8;
+  }
+#  endif
+  while (p < end && isdigit(*p)) {
+    w = w * 10 + uint8_t(*p - '0');
+    p++;
+  }
+  return p;
+}
+
+// Fast path of parseNumber(): reads the number as w * 10^q with up to 19
+// significant digits, then converts it with decimalToFloat(). Returns false
+// when the number doesn't fit, isn't valid JSON, or is too close to the
+// limits of the floating point types, so parseNumber() takes the slow path.
+// Produces the same types as the slow path.
+inline bool parseDecimal(const char* s, const char* end, bool is_negative,
+                         bool allowFloat, Number& result) {
+  if (!end)
+    end = s + strlen(s);
+  uint64_t w = 0;
+
+  const char* p = parseDigits(s, end, w);
+  const char* fraction = p;
+  bool is_integer = true;
+  if (*p == '.') {
+    is_integer = false;
+    fraction = p + 1;
+    p = parseDigits(fraction, end, w);
+  }
+  int q = -int(p - fraction);
+
+  size_t digits = size_t(p - s) - (is_integer ? 0 : 1);
+  if (digits == 0)
+    return false;
+  if (digits > 19) {
+    // leading zeros aren't significant
+    for (const char* z = s; *z == '0' || *z == '.'; z++) {
+      if (*z == '0')
+        digits--;
+    }
+    if (digits > 19)
+      return false;
+  }
+
+  if (*p == 'e' || *p == 'E') {
+    is_integer = false;
+    p++;
+    bool negative_exponent = false;
+    if (*p == '-') {
+      negative_exponent = true;
+      p++;
+    } else if (*p == '+') {
+      p++;
+    }
+    if (!isdigit(*p))
+      return false;
+    int exponent = 0;
+    while (isdigit(*p)) {
+      if (exponent < 1000)
+        exponent = exponent * 10 + (*p - '0');
+      p++;
+    }
+    q += negative_exponent ? -exponent : exponent;
+  }
+
+  if (p != end)
+    return false;
+
+  if (is_integer) {
+    const uint64_t maxUint = JsonUInt(-1);
+    if (w > maxUint)
+      return false;
+    if (!is_negative) {
+      result = Number(JsonUInt(w));
+      return true;
+    }
+    if (w > JsonUInt(1) << (sizeof(JsonInteger) * 8 - 1))
+      return false;
+    result = Number(JsonInteger(~JsonUInt(w) + 1));
+    return true;
+  }
+
+  if (w == 0) {
+    result = Number(is_negative ? -0.0f : 0.0f);
+    return true;
+  }
+
+#  if ARDUINOJSON_USE_DOUBLE
+  bool isDouble = !allowFloat || q < -FloatTraits<float>::exponent_max ||
+                  q > FloatTraits<float>::exponent_max ||
+                  w > FloatTraits<float>::mantissa_max;
+  if (isDouble) {
+    double value;
+    if (!decimalToFloat(w, q, value))
+      return false;
+    result = Number(is_negative ? -value : value);
+    return true;
+  }
+#  else
+  (void)allowFloat;
+#  endif
+  float value;
+  if (!decimalToFloat(w, q, value))
+    return false;
+  result = Number(is_negative ? -value : value);
+  return true;
+}
+#endif
+
+// s must be NUL-terminated; end points to the terminator, or is null if the
+// caller doesn't know where it is. With allowFloat false, a number that would
+// fit in a float is returned as a double anyway, for callers that don't store
+// it and want the full precision.
+inline Number parseNumber(const char* s, const char* end = nullptr,
+                          bool allowFloat = true) {
   using traits = FloatTraits<JsonFloat>;
   using mantissa_t = largest_type<traits::mantissa_type, JsonUInt>;
   using exponent_t = traits::exponent_type;
@@ -132,6 +282,17 @@ inline Number parseNumber(const char* s) {
   }
 #endif
 
+#if ARDUINOJSON_EISEL_LEMIRE
+  Number result;
+  if (parseDecimal(s, end, is_negative, allowFloat, result))
+    return result;
+#else
+  (void)end;
+#endif
+#if !ARDUINOJSON_USE_DOUBLE
+  (void)allowFloat;
+#endif
+
   if (!isdigit(*s) && *s != '.')
     return Number();
 
@@ -216,7 +377,8 @@ inline Number parseNumber(const char* s) {
     return Number();
 
 #if ARDUINOJSON_USE_DOUBLE
-  bool isDouble = exponent < -FloatTraits<float>::exponent_max ||
+  bool isDouble = !allowFloat ||
+                  exponent < -FloatTraits<float>::exponent_max ||
                   exponent > FloatTraits<float>::exponent_max ||
                   mantissa > FloatTraits<float>::mantissa_max;
   if (isDouble) {
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <ArduinoJson/Collection/CollectionData.hpp>
+#include <ArduinoJson/Memory/ObjectIndex.hpp>
 
 ARDUINOJSON_BEGIN_PRIVATE_NAMESPACE
 
@@ -42,6 +43,9 @@ class ObjectData : public CollectionData {
   }
 
   void remove(iterator it, ResourceManager* resources) {
+#if ARDUINOJSON_OBJECT_INDEX
+    unindexKey(it, resources);
+#endif
     CollectionData::removePair(it, resources);
   }
 
@@ -65,6 +69,12 @@ class ObjectData : public CollectionData {
  private:
   template <typename TAdaptedString>
   iterator findKey(TAdaptedString key, const ResourceManager* resources) const;
+
+#if ARDUINOJSON_OBJECT_INDEX
+  ObjectIndex* updateIndex(ObjectIndex* index,
+                           const ResourceManager* resources) const;
+  void unindexKey(iterator it, const ResourceManager* resources) const;
+#endif
 };
 
 ARDUINOJSON_END_PRIVATE_NAMESPACE
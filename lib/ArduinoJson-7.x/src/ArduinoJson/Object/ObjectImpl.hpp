@@ -10,6 +10,24 @@
 
 ARDUINOJSON_BEGIN_PRIVATE_NAMESPACE
 
+#if ARDUINOJSON_OBJECT_INDEX
+template <typename TAdaptedString>
+class KeyMatcher {
+ public:
+  KeyMatcher(TAdaptedString key, const ResourceManager* resources)
+      : key_(key), resources_(resources) {}
+
+  bool operator()(SlotId id) const {
+    auto key = resources_->getVariant(id)->asString();
+    return stringEquals(key_, adaptString(key));
+  }
+
+ private:
+  TAdaptedString key_;
+  const ResourceManager* resources_;
+};
+#endif
+
 template <typename TAdaptedString>
 inline VariantData* ObjectData::getMember(
     TAdaptedString key, const ResourceManager* resources) const {
@@ -34,14 +52,86 @@ inline ObjectData::iterator ObjectData::findKey(
     TAdaptedString key, const ResourceManager* resources) const {
   if (key.isNull())
     return iterator();
+#if ARDUINOJSON_OBJECT_INDEX
+  auto index = resources->getObjectIndex(this);
+  if (index)
+    index = updateIndex(index, resources);
+  if (index) {
+    auto id = index->find(stringHash(key),
+                          KeyMatcher<TAdaptedString>(key, resources));
+    if (id == NULL_SLOT)
+      return iterator();
+    return iterator(resources->getVariant(id), id);
+  }
+  size_t keys = 0;
+#endif
   bool isKey = true;
-  for (auto it = createIterator(resources); !it.done(); it.next(resources)) {
-    if (isKey && stringEquals(key, adaptString(it->asString())))
-      return it;
+  auto it = createIterator(resources);
+  for (; !it.done(); it.next(resources)) {
+    if (isKey) {
+      if (stringEquals(key, adaptString(it->asString())))
+        break;
+#if ARDUINOJSON_OBJECT_INDEX
+      keys++;
+#endif
+    }
     isKey = !isKey;
   }
-  return iterator();
+#if ARDUINOJSON_OBJECT_INDEX
+  if (keys >= ARDUINOJSON_OBJECT_INDEX_THRESHOLD) {
+    index = resources->addObjectIndex(this);
+    if (index)
+      updateIndex(index, resources);
+  }
+#endif
+  return it;
+}
+
+#if ARDUINOJSON_OBJECT_INDEX
+// Indexes the members appended since the last lookup. If the index can't
+// grow, it's dropped and lookups scan the members until the next attempt.
+inline ObjectIndex* ObjectData::updateIndex(
+    ObjectIndex* index, const ResourceManager* resources) const {
+  auto id = head();
+  if (index->lastKey != NULL_SLOT) {
+    auto value = resources->getVariant(index->lastKey)->next();
+    id = resources->getVariant(value)->next();
+  }
+  while (id != NULL_SLOT) {
+    auto key = resources->getVariant(id);
+    auto str = key->asString();
+    if (str.isNull())  // the deserializer hasn't saved the key yet
+      break;
+    if (!index->insert(id, stringHash(adaptString(str)),
+                       resources->allocator())) {
+      resources->removeObjectIndex(this);
+      return nullptr;
+    }
+    index->lastKey = id;
+    id = resources->getVariant(key->next())->next();
+  }
+  return index;
+}
+
+inline void ObjectData::unindexKey(iterator it,
+                                   const ResourceManager* resources) const {
+  if (it.done())
+    return;
+  auto index = resources->getObjectIndex(this);
+  if (!index)
+    return;
+  index->erase(it.currentId_, stringHash(adaptString(it->asString())));
+  if (it.currentId_ != index->lastKey)
+    return;
+  // the previous key becomes the last one
+  SlotId prev = NULL_SLOT;
+  for (auto id = head(); id != it.currentId_;) {
+    prev = id;
+    id = resources->getVariant(resources->getVariant(id)->next())->next();
+  }
+  index->lastKey = prev;
 }
+#endif
 
 template <typename TAdaptedString>
 inline void ObjectData::removeMember(TAdaptedString key,
@@ -6,6 +6,8 @@
 
 #include <ArduinoJson/Namespace.hpp>
 
+#include <stdint.h>
+
 ARDUINOJSON_BEGIN_PRIVATE_NAMESPACE
 
 // Some libraries #define isnan() and isinf() so we need to check before
@@ -24,4 +26,23 @@ bool isinf(T x) {
   return x != 0.0 && x * 2 == x;
 }
 #endif
+
+// Returns the high half of a * b, stores the low half in low
+inline uint64_t multiply128(uint64_t a, uint64_t b, uint64_t& low) {
+#if defined(__SIZEOF_INT128__)
+  __extension__ typedef unsigned __int128 uint128_t;
+  uint128_t product = uint128_t(a) * b;
+  low = uint64_t(product);
+  return uint64_t(product >> 64);
+#else
+  uint64_t aLow = a & 0xFFFFFFFF, aHigh = a >> 32;
+  uint64_t bLow = b & 0xFFFFFFFF, bHigh = b >> 32;
+  uint64_t ll = aLow * bLow, lh = aLow * bHigh;
+  uint64_t hl = aHigh * bLow, hh = aHigh * bHigh;
+  uint64_t middle = (ll >> 32) + (lh & 0xFFFFFFFF) + (hl & 0xFFFFFFFF);
+  low = (middle << 32) | (ll & 0xFFFFFFFF);
+  return hh + (lh >> 32) + (hl >> 32) + (middle >> 32);
+#endif
+}
+
 ARDUINOJSON_END_PRIVATE_NAMESPACE
@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <stdint.h>  // uint32_t
+
 #include <ArduinoJson/Polyfills/type_traits.hpp>
 #include <ArduinoJson/Strings/Adapters/RamString.hpp>
 #include <ArduinoJson/Strings/Adapters/StringObject.hpp>
@@ -61,6 +63,16 @@ stringEquals(TAdaptedString1 s1, TAdaptedString2 s2) {
   return stringEquals(s2, s1);
 }
 
+// FNV-1a, used by the indexes of the string pool and of the objects
+template <typename TAdaptedString>
+uint32_t stringHash(const TAdaptedString& str) {
+  uint32_t hash = 2166136261u;
+  size_t n = str.size();
+  for (size_t i = 0; i < n; i++)
+    hash = (hash ^ static_cast<uint8_t>(str[i])) * 16777619u;
+  return hash;
+}
+
 template <typename TAdaptedString>
 static void stringGetChars(TAdaptedString s, char* p, size_t n) {
   ARDUINOJSON_ASSERT(s.size() <= n);
@@ -78,6 +78,7 @@ LoRaClass::LoRaClass() :
   _frequency(0),
   _packetIndex(0),
   _implicitHeaderMode(0),
+  _crcErrors(0),
   _onReceive(NULL),
   _onCadDone(NULL),
   _onTxDone(NULL)
@@ -154,6 +155,34 @@ int LoRaClass::begin(long frequency)
   return 1;
 }
 
+int LoRaClass::resume(long frequency)
+{
+  // setup pins, leaving the reset line alone
+  pinMode(_ss, OUTPUT);
+  digitalWrite(_ss, HIGH);
+
+  if (_reset != -1) {
+    pinMode(_reset, OUTPUT);
+    digitalWrite(_reset, HIGH);
+  }
+
+  // start SPI
+  _spi->begin();
+
+  // check version
+  uint8_t version = readRegister(REG_VERSION);
+  if (version != 0x12) {
+    return 0;
+  }
+
+  // restore the state kept on this side from the radio's registers
+  _frequency = frequency;
+  _implicitHeaderMode = readRegister(REG_MODEM_CONFIG_1) & 0x01;
+  _packetIndex = 0;
+
+  return 1;
+}
+
 void LoRaClass::end()
 {
   // put in sleep mode
@@ -252,6 +281,12 @@ int LoRaClass::parsePacket(int size)
 
     // put in standby mode
     idle();
+  } else if ((irqFlags & IRQ_RX_DONE_MASK) && (irqFlags & IRQ_PAYLOAD_CRC_ERROR_MASK)) {
+    // received a corrupted packet, count it and listen again
+    _crcErrors++;
+
+    writeRegister(REG_FIFO_ADDR_PTR, 0);
+    writeRegister(REG_OP_MODE, MODE_LONG_RANGE_MODE | MODE_RX_SINGLE);
   } else if (readRegister(REG_OP_MODE) != (MODE_LONG_RANGE_MODE | MODE_RX_SINGLE)) {
     // not currently in RX mode
 
@@ -294,6 +329,11 @@ long LoRaClass::packetFrequencyError()
   return static_cast<long>(fError);
 }
 
+uint32_t LoRaClass::crcErrorCount()
+{
+  return _crcErrors;
+}
+
 int LoRaClass::rssi()
 {
   return (readRegister(REG_RSSI_VALUE) - (_frequency < RF_MID_BAND_THRESHOLD ? RSSI_OFFSET_LF_PORT : RSSI_OFFSET_HF_PORT));
@@ -362,6 +402,25 @@ void LoRaClass::flush()
 {
 }
 
+size_t LoRaClass::readPacket(uint8_t *buffer, size_t size)
+{
+  int remaining = available();
+
+  if (remaining <= 0) {
+    return 0;
+  }
+
+  if (size > (size_t)remaining) {
+    size = remaining;
+  }
+
+  // read all bytes in a single SPI transaction, the FIFO address auto-increments
+  burstRead(REG_FIFO, buffer, size);
+  _packetIndex += size;
+
+  return size;
+}
+
 #ifndef ARDUINO_SAMD_MKRWAN1300
 void LoRaClass::onReceive(void(*callback)(int))
 {
@@ -765,6 +824,8 @@ void LoRaClass::handleDio0Rise()
         _onTxDone();
       }
     }
+  } else if ((irqFlags & IRQ_RX_DONE_MASK) != 0) {
+    _crcErrors++;
   }
 }
 
@@ -792,6 +853,24 @@ uint8_t LoRaClass::singleTransfer(uint8_t address, uint8_t value)
   return response;
 }
 
+void LoRaClass::readRegisters(uint8_t address, uint8_t *buffer, size_t size)
+{
+  // the register address auto-increments during a burst
+  burstRead(address, buffer, size);
+}
+
+void LoRaClass::burstRead(uint8_t address, uint8_t *buffer, size_t size)
+{
+  _spi->beginTransaction(_spiSettings);
+  digitalWrite(_ss, LOW);
+  _spi->transfer(address & 0x7f);
+  for (size_t i = 0; i < size; i++) {
+    buffer[i] = _spi->transfer(0x00);
+  }
+  digitalWrite(_ss, HIGH);
+  _spi->endTransaction();
+}
+
 ISR_PREFIX void LoRaClass::onDio0Rise()
 {
   LoRa.handleDio0Rise();
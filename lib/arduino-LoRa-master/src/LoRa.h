@@ -35,6 +35,7 @@ public:
   LoRaClass();
 
   int begin(long frequency);
+  int resume(long frequency);
   void end();
 
   int beginPacket(int implicitHeader = false);
@@ -44,6 +45,7 @@ public:
   int packetRssi();
   float packetSnr();
   long packetFrequencyError();
+  uint32_t crcErrorCount();
 
   int rssi();
 
@@ -57,6 +59,8 @@ public:
   virtual int peek();
   virtual void flush();
 
+  size_t readPacket(uint8_t *buffer, size_t size);
+
 #ifndef ARDUINO_SAMD_MKRWAN1300
   void onReceive(void(*callback)(int));
   void onCadDone(void(*callback)(boolean));
@@ -97,6 +101,7 @@ public:
   void setSPIFrequency(uint32_t frequency);
 
   void dumpRegisters(Stream& out);
+  void readRegisters(uint8_t address, uint8_t *buffer, size_t size);
 
 private:
   void explicitHeaderMode();
@@ -114,6 +119,7 @@ private:
   uint8_t readRegister(uint8_t address);
   void writeRegister(uint8_t address, uint8_t value);
   uint8_t singleTransfer(uint8_t address, uint8_t value);
+  void burstRead(uint8_t address, uint8_t *buffer, size_t size);
 
   static void onDio0Rise();
 
@@ -126,6 +132,7 @@ private:
   long _frequency;
   int _packetIndex;
   int _implicitHeaderMode;
+  uint32_t _crcErrors;
   void (*_onReceive)(int);
   void (*_onCadDone)(boolean);
   void (*_onTxDone)();
@@ -0,0 +1,63 @@
+#ifndef COBS_H
+#define COBS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Consistent Overhead Byte Stuffing. The encoded data contains no zero
+// bytes, so a 0x00 can delimit frames on a byte stream and a receiver that
+// joins mid-stream resynchronises on the next delimiter. Overhead is one
+// byte per 254 bytes of input plus one.
+#define COBS_MAX_ENCODED(size) ((size) + (size) / 254 + 1)
+
+// Encodes size bytes into out (COBS_MAX_ENCODED(size) bytes), without the
+// trailing delimiter. Returns the encoded length.
+size_t cobsEncode(const uint8_t *in, size_t size, uint8_t *out)
+{
+    uint8_t *code = out++;
+    uint8_t run = 1;
+    uint8_t *start = code;
+
+    for (size_t i = 0; i < size; i++)
+    {
+        if (in[i])
+        {
+            *out++ = in[i];
+            run++;
+        }
+        if (!in[i] || run == 0xFF)
+        {
+            *code = run;
+            run = 1;
+            code = out++;
+        }
+    }
+    *code = run;
+    return out - start;
+}
+
+// Decodes size bytes (without the delimiter) into out, which may alias in.
+// Returns the decoded length, or 0 if the input is not valid COBS.
+size_t cobsDecode(const uint8_t *in, size_t size, uint8_t *out)
+{
+    const uint8_t *end = in + size;
+    uint8_t *start = out;
+
+    while (in < end)
+    {
+        uint8_t code = *in++;
+        if (!code || in + code - 1 > end)
+            return 0;
+        for (uint8_t i = 1; i < code; i++)
+        {
+            if (!*in)
+                return 0;
+            *out++ = *in++;
+        }
+        if (code != 0xFF && in < end)
+            *out++ = 0;
+    }
+    return out - start;
+}
+
+#endif
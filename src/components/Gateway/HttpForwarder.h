@@ -0,0 +1,312 @@
+#ifndef HTTP_FORWARDER_H
+#define HTTP_FORWARDER_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <HTTPClient.h>
+#include <WiFi.h>
+#include <WiFiClientSecure.h>
+#include "SegmentLog.h"
+#include "../LoRa/FrameHeader.h"
+#include "../Utils/BumpAllocator.h"
+#include "../Utils/Logger.h"
+#include "../Utils/TimeService.h"
+
+#ifndef FORWARD_BATCH_SIZE
+#define FORWARD_BATCH_SIZE 4096 // bytes, the only buffer the forwarder holds
+#endif
+
+#define FORWARD_MAX_RECORDS 64
+#define FORWARD_FLUSH_BYTES (FORWARD_BATCH_SIZE * 3 / 4)
+#define FORWARD_FLUSH_MS 5000
+#define FORWARD_BACKOFF_MIN_MS 1000
+#define FORWARD_BACKOFF_MAX_MS 60000
+
+// A POST blocks loop(): connecting, then waiting for each read, at most once
+// per loop()
+#ifndef FORWARD_CONNECT_TIMEOUT_MS
+#define FORWARD_CONNECT_TIMEOUT_MS 1000
+#endif
+#ifndef FORWARD_TIMEOUT_MS
+#define FORWARD_TIMEOUT_MS 1000
+#endif
+
+static_assert(FORWARD_BATCH_SIZE >= STORE_MAX_RECORD, "FORWARD_BATCH_SIZE must hold a stored record");
+
+enum ForwardFormat
+{
+    FORWARD_NDJSON,  // one JSON object per line, application/x-ndjson
+    FORWARD_MSGPACK, // concatenated MsgPack maps, application/msgpack
+};
+
+struct ForwarderStats
+{
+    uint32_t posts;       // successful POSTs
+    uint32_t failures;    // POSTs that failed or were refused
+    uint32_t reused;      // POSTs sent on a kept-alive connection
+    uint32_t records;     // records delivered
+    uint32_t bytes;       // body bytes delivered
+    uint32_t spilled;     // records moved to the store after a failure
+    uint32_t fromStore;   // records delivered from the store
+    uint32_t dropped;     // records lost: no store, or the store refused them
+};
+
+// Sends received frames upstream in batches over one kept-alive HTTP(S)
+// connection. Records are serialised straight into a fixed batch buffer
+// and POSTed when it is FORWARD_FLUSH_BYTES full or FORWARD_FLUSH_MS old.
+//
+// A failed POST doubles the retry delay (FORWARD_BACKOFF_MIN_MS up to
+// FORWARD_BACKOFF_MAX_MS, with jitter) and, when a SegmentLog is attached,
+// moves the batch's records into it so the buffer is free for new frames.
+// Once POSTs succeed again the store is drained one batch per loop(), its
+// cursor committed only after the server accepted the batch.
+//
+// A POST is synchronous, so each loop() makes at most one, counting the one
+// add() may have made since the previous loop(); with both timeouts that
+// bounds the time loop() can spend in the forwarder.
+//
+// Any HTTP server works as a stand-in, see tools/forwarder.
+class HttpForwarder
+{
+  private:
+    HTTPClient _http;
+    WiFiClient _plain;
+    WiFiClientSecure _secure;
+    WiFiClient *_client = &_plain;
+    const char *_url = nullptr;
+    ForwardFormat _format = FORWARD_NDJSON;
+    SegmentLog *_store = nullptr;
+
+    uint8_t _batch[FORWARD_BATCH_SIZE];
+    size_t _length = 0;
+    uint16_t _ends[FORWARD_MAX_RECORDS]; // end offset of each record
+    uint8_t _count = 0;
+    uint32_t _batchStartMs = 0;
+
+    uint32_t _backoffMs = 0;
+    uint32_t _retryAtMs = 0;
+    bool _attempted = false; // a POST was made since the last loop()
+
+    ForwarderStats _stats = {};
+
+    // each record is built in _doc, backed by the arena instead of the heap
+    BumpAllocator<JSON_ARENA_SIZE> _arena;
+    JsonDocument _doc;
+
+    bool post();
+    void failed(uint32_t now);
+    void spill();
+    void drainStore(uint32_t now);
+    void service(uint32_t now);
+    void clear()
+    {
+        _length = 0;
+        _count = 0;
+    }
+
+  public:
+    HttpForwarder() : _doc(&_arena) {}
+
+    // caCert verifies an https server; without it the connection is
+    // encrypted but the server is not authenticated
+    void begin(const char *url, ForwardFormat format = FORWARD_NDJSON, SegmentLog *store = nullptr, const char *caCert = nullptr);
+
+    // Serialises one frame into the batch, posting or spilling a full batch
+    // first. Returns false if the frame was dropped.
+    bool add(const char *payload, const PacketInfo &packet);
+
+    void loop();
+
+    const ForwarderStats &stats() const { return _stats; }
+    const AllocatorStats &allocatorStats() const { return _arena.stats(); }
+};
+
+void HttpForwarder::begin(const char *url, ForwardFormat format, SegmentLog *store, const char *caCert)
+{
+    _url = url;
+    _format = format;
+    _store = store;
+
+    if (!strncmp(url, "https:", 6))
+    {
+        if (caCert)
+            _secure.setCACert(caCert);
+        else
+            _secure.setInsecure();
+        _client = &_secure;
+    }
+
+    _http.setReuse(true);
+    _http.setConnectTimeout(FORWARD_CONNECT_TIMEOUT_MS);
+    _http.setTimeout(FORWARD_TIMEOUT_MS);
+}
+
+bool HttpForwarder::add(const char *payload, const PacketInfo &packet)
+{
+    JsonDocument &doc = _doc;
+    doc.clear();
+    _arena.reset();
+    if (packet.addressed)
+    {
+        doc["src"] = packet.source;
+        doc["seq"] = packet.sequence;
+        doc["hops"] = packet.hops;
+    }
+    doc["rssi"] = packet.rssi;
+    doc["snr"] = packet.snr;
+    doc["time"] = TimeService::instance().now();
+    doc["payload"] = JsonString(payload, packet.length);
+
+    size_t size = _format == FORWARD_MSGPACK ? measureMsgPack(doc) : measureJson(doc) + 1;
+    if (size > sizeof(_batch))
+    {
+        _stats.dropped++;
+        return false;
+    }
+
+    if (_length + size > sizeof(_batch) || _count == FORWARD_MAX_RECORDS)
+    {
+        uint32_t now = millis();
+        bool waiting = (int32_t)(now - _retryAtMs) < 0 || _attempted;
+        if (waiting || !post())
+        {
+            if (!waiting)
+                failed(now);
+            spill();
+        }
+    }
+
+    if (!_length)
+        _batchStartMs = millis();
+
+    char *out = (char *)_batch + _length;
+    if (_format == FORWARD_MSGPACK)
+    {
+        _length += serializeMsgPack(doc, out, sizeof(_batch) - _length);
+    }
+    else
+    {
+        _length += serializeJson(doc, out, sizeof(_batch) - _length);
+        _batch[_length++] = '\n';
+    }
+    _ends[_count++] = _length;
+    return true;
+}
+
+bool HttpForwarder::post()
+{
+    if (!_url || WiFi.status() != WL_CONNECTED)
+        return false;
+
+    _attempted = true;
+    bool reused = _http.connected();
+    if (!_http.begin(*_client, _url))
+        return false;
+    _http.addHeader("Content-Type", _format == FORWARD_MSGPACK ? "application/msgpack" : "application/x-ndjson");
+
+    int code = _http.POST(_batch, _length);
+    // end() keeps the connection open when the server allows keep-alive
+    _http.end();
+
+    if (code < 200 || code >= 300)
+    {
+        LOG("Forwarder: POST %s failed: %d", _url, code);
+        return false;
+    }
+
+    _stats.posts++;
+    _stats.reused += reused;
+    _stats.records += _count;
+    _stats.bytes += _length;
+    _backoffMs = 0;
+    clear();
+    return true;
+}
+
+void HttpForwarder::failed(uint32_t now)
+{
+    _stats.failures++;
+    _backoffMs = _backoffMs ? _backoffMs * 2 : FORWARD_BACKOFF_MIN_MS;
+    if (_backoffMs > FORWARD_BACKOFF_MAX_MS)
+        _backoffMs = FORWARD_BACKOFF_MAX_MS;
+    _retryAtMs = now + _backoffMs + random(_backoffMs / 4 + 1);
+}
+
+void HttpForwarder::spill()
+{
+    if (!_count)
+        return;
+
+    size_t start = 0;
+    for (uint8_t i = 0; i < _count; i++)
+    {
+        if (_store && _store->append(_batch + start, _ends[i] - start))
+            _stats.spilled++;
+        else
+            _stats.dropped++;
+        start = _ends[i];
+    }
+    if (_store)
+        _store->flush();
+    clear();
+}
+
+void HttpForwarder::drainStore(uint32_t now)
+{
+    int length;
+    while (_count < FORWARD_MAX_RECORDS && _length + STORE_MAX_RECORD <= sizeof(_batch) &&
+           (length = _store->next(_batch + _length)) >= 0)
+    {
+        _length += length;
+        _ends[_count++] = _length;
+    }
+    if (!_count)
+        return;
+
+    uint8_t count = _count;
+    if (post())
+    {
+        _stats.fromStore += count;
+        _store->commit();
+        _store->compact();
+    }
+    else
+    {
+        // the records are still in the store, read them again next time
+        _store->rewind();
+        clear();
+        failed(now);
+    }
+}
+
+void HttpForwarder::loop()
+{
+    if (!_attempted)
+        service(millis());
+    _attempted = false;
+}
+
+void HttpForwarder::service(uint32_t now)
+{
+    if ((int32_t)(now - _retryAtMs) < 0)
+        return;
+
+    if (_count && (_length >= FORWARD_FLUSH_BYTES || now - _batchStartMs >= FORWARD_FLUSH_MS))
+    {
+        if (!post())
+        {
+            // without a store the batch stays here for the retry, until
+            // add() needs the room
+            failed(now);
+            if (_store)
+                spill();
+            return;
+        }
+    }
+
+    // the batch buffer is free between flushes, refill it from the store
+    if (!_attempted && !_count && _store && _store->pending())
+        drainStore(now);
+}
+
+#endif
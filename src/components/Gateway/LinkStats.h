@@ -0,0 +1,346 @@
+#ifndef LINK_STATS_H
+#define LINK_STATS_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "../LoRa/FrameHeader.h"
+
+#ifndef LINK_STATS_CAPACITY
+#define LINK_STATS_CAPACITY 512 // 34 bytes per node (~17 KB), up to 448 nodes
+#endif
+
+// DRAM budget of one table. The gateway's table is a global in .bss, next to
+// the Logger ring, the CRC tables, the forwarder buffers and the heap WiFi
+// and TLS need; a plain ESP32 has no PSRAM, so a much larger table either
+// fails to link or leaves HTTPClient short of heap.
+#ifndef LINK_STATS_MAX_BYTES
+#define LINK_STATS_MAX_BYTES 32768
+#endif
+
+#ifndef LINK_STATS_MAX_AGE_MS
+#define LINK_STATS_MAX_AGE_MS 3600000UL // nodes silent for longer are evicted
+#endif
+
+#define LINK_STATS_EWMA_SHIFT 3   // RSSI/SNR smoothing, alpha = 1/8
+#define LINK_STATS_JITTER_SHIFT 4 // RFC 3550 jitter gain, 1/16
+
+// Per-node link quality seen by the gateway, keyed by the device id nodes
+// put in their payload (ESPUtils::getDeviceId()).
+//
+// Storage is one array per field (struct of arrays) in an open-addressed
+// table, so the probe loop only walks the id array and an update touches one
+// element of each field. The table never allocates. A new node takes over
+// the slot of a node not heard for LINK_STATS_MAX_AGE_MS when its probe
+// chain crosses one; once the table is 7/8 full every such node is evicted,
+// and only if none is left are new nodes counted in rejected() instead of
+// being added. Capacity must be a power of two.
+//
+// RSSI, SNR and jitter are kept in 1/16 fixed point. Jitter follows the
+// RFC 3550 estimator applied to the variation of the inter-arrival time,
+// normalised by the number of sequence numbers the gap spans, since nodes
+// do not carry a send timestamp.
+template <uint16_t Capacity = LINK_STATS_CAPACITY>
+class LinkStatsTable
+{
+    static_assert(Capacity && (Capacity & (Capacity - 1)) == 0, "LinkStatsTable capacity must be a power of two");
+
+    static_assert(Capacity * (sizeof(uint64_t) + 5 * sizeof(uint32_t) + 2 * sizeof(int16_t) + 2) <= LINK_STATS_MAX_BYTES,
+                  "LinkStatsTable exceeds LINK_STATS_MAX_BYTES, lower LINK_STATS_CAPACITY");
+
+  private:
+
+    uint64_t _ids[Capacity];
+    uint32_t _packets[Capacity];
+    uint32_t _lost[Capacity];
+    uint32_t _lastSeenMs[Capacity];
+    uint32_t _intervalMs[Capacity];
+    uint32_t _jitter[Capacity];
+    int16_t _rssi[Capacity];
+    int16_t _snr[Capacity];
+    uint8_t _sequence[Capacity];
+    uint8_t _flags[Capacity];
+
+    uint16_t _count = 0;
+    uint32_t _rejected = 0;
+
+    enum : uint8_t
+    {
+        USED = 0x01,
+        SEQUENCE = 0x02, // _sequence holds a valid header sequence
+        INTERVAL = 0x04  // _intervalMs holds a previous inter-arrival time
+    };
+
+    static uint16_t home(uint64_t id)
+    {
+        // Fibonacci hashing, device ids are MAC based and share their prefix
+        return (uint16_t)((id * 0x9E3779B97F4A7C15ULL) >> 48) & (Capacity - 1);
+    }
+
+    bool stale(uint16_t slot, uint32_t nowMs) const
+    {
+        return nowMs - _lastSeenMs[slot] >= LINK_STATS_MAX_AGE_MS;
+    }
+
+    int slotFor(uint64_t id, uint32_t nowMs);
+    void move(uint16_t to, uint16_t from);
+    void remove(uint16_t slot);
+    void writeRow(JsonDocument &row, uint16_t slot, uint32_t nowMs) const;
+
+  public:
+    LinkStatsTable() { clear(); }
+
+    void clear()
+    {
+        memset(_flags, 0, sizeof(_flags));
+        _count = 0;
+        _rejected = 0;
+    }
+
+    // Records one delivered frame. Returns false when the node is new and
+    // the table is full.
+    bool update(uint64_t id, const PacketInfo &packet, uint32_t nowMs);
+
+    // Evicts the nodes not heard for LINK_STATS_MAX_AGE_MS, returns how many
+    uint16_t expire(uint32_t nowMs);
+
+    uint16_t size() const { return _count; }
+    uint32_t rejected() const { return _rejected; }
+
+    // Snapshot, one row per node:
+    //   [id, packets, lost, lossRate, rssi, snr, lastSeenAgoMs, jitterMs]
+    // JSON is an array of rows, MsgPack the same with a fixed-size array
+    // header, so no document holds more than one row at a time.
+    size_t writeJson(Print &out, uint32_t nowMs) const;
+    size_t writeMsgPack(Print &out, uint32_t nowMs) const;
+
+    // The same rows one at a time, for callers that can't write the whole
+    // snapshot at once: nextRow() returns the first row at or after slot,
+    // or -1. Rows may be missed or repeated if the table changes in between.
+    int nextRow(int slot) const;
+    size_t writeRowJson(JsonDocument &row, uint16_t slot, char *buffer, size_t size, uint32_t nowMs) const;
+};
+
+template <uint16_t Capacity>
+int LinkStatsTable<Capacity>::slotFor(uint64_t id, uint32_t nowMs)
+{
+    uint16_t slot = home(id);
+    int reuse = -1;
+    while (_flags[slot] & USED)
+    {
+        if (_ids[slot] == id)
+            return slot;
+        if (reuse < 0 && stale(slot, nowMs))
+            reuse = slot;
+        slot = (slot + 1) & (Capacity - 1);
+    }
+
+    // Replacing the id of an occupied slot keeps the probe chains intact.
+    // Otherwise the load limit guarantees the loop above found an empty slot.
+    if (reuse >= 0)
+        slot = reuse;
+    else if (_count >= Capacity - Capacity / 8)
+        return expire(nowMs) ? slotFor(id, nowMs) : -1;
+    else
+        _count++;
+
+    _ids[slot] = id;
+    _flags[slot] = USED;
+    _packets[slot] = 0;
+    _lost[slot] = 0;
+    _jitter[slot] = 0;
+    _lastSeenMs[slot] = nowMs;
+    return slot;
+}
+
+template <uint16_t Capacity>
+void LinkStatsTable<Capacity>::move(uint16_t to, uint16_t from)
+{
+    _ids[to] = _ids[from];
+    _packets[to] = _packets[from];
+    _lost[to] = _lost[from];
+    _lastSeenMs[to] = _lastSeenMs[from];
+    _intervalMs[to] = _intervalMs[from];
+    _jitter[to] = _jitter[from];
+    _rssi[to] = _rssi[from];
+    _snr[to] = _snr[from];
+    _sequence[to] = _sequence[from];
+    _flags[to] = _flags[from];
+}
+
+// Backward-shift deletion: the entries after the hole whose probe path
+// crosses it move into it, so no lookup ever stops at a stale empty slot
+template <uint16_t Capacity>
+void LinkStatsTable<Capacity>::remove(uint16_t slot)
+{
+    uint16_t hole = slot;
+    for (uint16_t next = (hole + 1) & (Capacity - 1); _flags[next] & USED; next = (next + 1) & (Capacity - 1))
+    {
+        uint16_t probes = (next - home(_ids[next])) & (Capacity - 1);
+        if (probes >= ((next - hole) & (Capacity - 1)))
+        {
+            move(hole, next);
+            hole = next;
+        }
+    }
+    _flags[hole] = 0;
+    _count--;
+}
+
+template <uint16_t Capacity>
+uint16_t LinkStatsTable<Capacity>::expire(uint32_t nowMs)
+{
+    uint16_t evicted = 0;
+    for (uint16_t slot = 0; slot < Capacity; slot++)
+    {
+        // the slot is checked again after a removal shifted an entry into it
+        while ((_flags[slot] & USED) && stale(slot, nowMs))
+        {
+            remove(slot);
+            evicted++;
+        }
+    }
+    return evicted;
+}
+
+template <uint16_t Capacity>
+bool LinkStatsTable<Capacity>::update(uint64_t id, const PacketInfo &packet, uint32_t nowMs)
+{
+    int slot = slotFor(id, nowMs);
+    if (slot < 0)
+    {
+        _rejected++;
+        return false;
+    }
+
+    int16_t rssi = packet.rssi * 16;
+    int16_t snr = (int16_t)(packet.snr * 16);
+    uint32_t span = 1;
+
+    if (_packets[slot] == 0)
+    {
+        _rssi[slot] = rssi;
+        _snr[slot] = snr;
+    }
+    else
+    {
+        _rssi[slot] += (rssi - _rssi[slot]) / (1 << LINK_STATS_EWMA_SHIFT);
+        _snr[slot] += (snr - _snr[slot]) / (1 << LINK_STATS_EWMA_SHIFT);
+    }
+
+    if (packet.addressed)
+    {
+        if (_flags[slot] & SEQUENCE)
+        {
+            uint8_t gap = packet.sequence - _sequence[slot];
+            if (gap > 0 && gap < 128)
+            {
+                _lost[slot] += gap - 1;
+                _sequence[slot] = packet.sequence;
+                span = gap;
+            }
+            else if (gap >= 128 && _lost[slot])
+            {
+                _lost[slot]--; // late arrival of a frame counted as lost
+            }
+        }
+        else
+        {
+            _sequence[slot] = packet.sequence;
+            _flags[slot] |= SEQUENCE;
+        }
+    }
+
+    if (_packets[slot])
+    {
+        uint32_t interval = (nowMs - _lastSeenMs[slot]) / span;
+        if (_flags[slot] & INTERVAL)
+        {
+            uint32_t delta = interval > _intervalMs[slot] ? interval - _intervalMs[slot] : _intervalMs[slot] - interval;
+            int32_t error = (int32_t)(delta * 16) - (int32_t)_jitter[slot];
+            _jitter[slot] += error / (1 << LINK_STATS_JITTER_SHIFT);
+        }
+        _intervalMs[slot] = interval;
+        _flags[slot] |= INTERVAL;
+    }
+
+    _lastSeenMs[slot] = nowMs;
+    _packets[slot]++;
+    return true;
+}
+
+template <uint16_t Capacity>
+void LinkStatsTable<Capacity>::writeRow(JsonDocument &row, uint16_t slot, uint32_t nowMs) const
+{
+    uint32_t expected = _packets[slot] + _lost[slot];
+
+    row.clear();
+    row.add(_ids[slot]);
+    row.add(_packets[slot]);
+    row.add(_lost[slot]);
+    row.add(expected ? (float)_lost[slot] / expected : 0.0f);
+    row.add(_rssi[slot] / 16.0f);
+    row.add(_snr[slot] / 16.0f);
+    row.add(nowMs - _lastSeenMs[slot]);
+    row.add(_jitter[slot] / 16);
+}
+
+template <uint16_t Capacity>
+size_t LinkStatsTable<Capacity>::writeJson(Print &out, uint32_t nowMs) const
+{
+    JsonDocument row;
+    size_t written = out.write('[');
+    bool first = true;
+
+    for (uint16_t slot = 0; slot < Capacity; slot++)
+    {
+        if (!(_flags[slot] & USED))
+            continue;
+        if (!first)
+            written += out.write(',');
+        first = false;
+        writeRow(row, slot, nowMs);
+        written += serializeJson(row, out);
+    }
+
+    return written + out.write(']');
+}
+
+template <uint16_t Capacity>
+size_t LinkStatsTable<Capacity>::writeMsgPack(Print &out, uint32_t nowMs) const
+{
+    // array 16 header, Capacity fits in 16 bits
+    uint8_t header[3] = {0xDC, (uint8_t)(_count >> 8), (uint8_t)_count};
+    size_t written = out.write(header, sizeof(header));
+    JsonDocument row;
+
+    for (uint16_t slot = 0; slot < Capacity; slot++)
+    {
+        if (!(_flags[slot] & USED))
+            continue;
+        writeRow(row, slot, nowMs);
+        written += serializeMsgPack(row, out);
+    }
+
+    return written;
+}
+
+template <uint16_t Capacity>
+int LinkStatsTable<Capacity>::nextRow(int slot) const
+{
+    for (; slot >= 0 && slot < Capacity; slot++)
+    {
+        if (_flags[slot] & USED)
+            return slot;
+    }
+    return -1;
+}
+
+template <uint16_t Capacity>
+size_t LinkStatsTable<Capacity>::writeRowJson(JsonDocument &row, uint16_t slot, char *buffer, size_t size,
+                                              uint32_t nowMs) const
+{
+    writeRow(row, slot, nowMs);
+    return serializeJson(row, buffer, size);
+}
+
+#endif
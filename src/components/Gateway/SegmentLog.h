@@ -0,0 +1,436 @@
+#ifndef SEGMENT_LOG_H
+#define SEGMENT_LOG_H
+
+#include <dirent.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "../LoRa/Crc32.h"
+
+#ifndef STORE_SEGMENT_SIZE
+#define STORE_SEGMENT_SIZE 65536
+#endif
+
+#ifndef STORE_MAX_SEGMENTS
+#define STORE_MAX_SEGMENTS 16 // oldest segment is dropped beyond this
+#endif
+
+#ifndef STORE_WRITE_BUFFER
+#define STORE_WRITE_BUFFER 4096
+#endif
+
+#define STORE_MAX_RECORD 1024
+#define STORE_RECORD_HEADER 6 // length(2) CRC32(4)
+#define STORE_BLOCK_SIZE 4096 // flash erase block, for the wear estimate
+#define STORE_PATH_SIZE 64
+
+static_assert(STORE_WRITE_BUFFER >= STORE_RECORD_HEADER + STORE_MAX_RECORD, "STORE_WRITE_BUFFER must hold the largest record");
+
+struct StoreMetrics
+{
+    uint64_t appendedBytes;  // payload bytes handed to append()
+    uint64_t writtenBytes;   // bytes written to files: records, headers and cursor
+    uint32_t appended;       // records appended
+    uint32_t read;           // records returned by next()
+    uint32_t flushes;        // batched segment writes
+    uint32_t cursorWrites;   // durable cursor updates
+    uint32_t blockWrites;    // erase blocks touched by writes, a flash wear estimate
+    uint32_t segmentsCreated;
+    uint32_t segmentsDeleted; // compacted after being read
+    uint32_t segmentsDropped; // evicted unread because the log was full
+    uint32_t corrupt;        // records failing their length or CRC check, rest of segment skipped
+
+    // file bytes written per payload byte appended
+    float writeAmplification() const { return appendedBytes ? (float)writtenBytes / appendedBytes : 0; }
+};
+
+// Persistent append-only record log split into numbered segment files, used
+// to hold frames while the upstream is unreachable. Plain stdio, so the same
+// code runs on LittleFS (mounted into the ESP32 VFS, e.g. /littlefs/store)
+// and on a host directory.
+//
+// Each record is length(2) | CRC32(4) | payload, with the CRC covering the
+// length and the payload. Appends are batched in RAM and reach the file in
+// one write per STORE_WRITE_BUFFER or flush(); only flushed records are
+// readable and durable. flush() ends with fsync(): LittleFS commits file data
+// only on sync or close, so until then a power loss drops the records and
+// another handle on the segment, like the reader's, does not see them.
+//
+// Reading is transactional: next() advances a read position, commit()
+// persists it as the cursor (a small file replaced by rename) and rewind()
+// goes back to the cursor, e.g. when forwarding a batch failed. compact()
+// deletes the segments entirely behind the cursor. On open() the log resumes
+// from the cursor and continues writing in a fresh segment, so a torn write
+// at the end of the previous one never gets appended to.
+class SegmentLog
+{
+  private:
+    const Crc32 &_crc;
+    char _dir[STORE_PATH_SIZE - 24]; // room for the file name
+
+    uint32_t _first = 0; // oldest segment
+    uint32_t _last = 0;  // segment being written
+    uint32_t _writeOffset = 0;
+    FILE *_writer = nullptr;
+    uint8_t _buffer[STORE_WRITE_BUFFER];
+    size_t _buffered = 0;
+
+    uint32_t _readSegment = 0;
+    uint32_t _readOffset = 0;
+    FILE *_reader = nullptr;
+    uint32_t _cursorSegment = 0;
+    uint32_t _cursorOffset = 0;
+
+    StoreMetrics _metrics = {};
+
+    void path(char *out, uint32_t segment) const
+    {
+        snprintf(out, STORE_PATH_SIZE, "%s/%08lu.seg", _dir, (unsigned long)segment);
+    }
+
+    void written(uint32_t offset, size_t size)
+    {
+        _metrics.writtenBytes += size;
+        _metrics.blockWrites += (offset + size - 1) / STORE_BLOCK_SIZE - offset / STORE_BLOCK_SIZE + 1;
+    }
+
+    bool openSegment(uint32_t segment);
+    void dropOldest();
+    bool readCursor();
+    bool writeCursor();
+    void closeReader();
+    bool nextSegment();
+
+  public:
+    SegmentLog(const Crc32 &crc, const char *dir);
+    ~SegmentLog() { close(); }
+
+    bool open();
+    void close();
+
+    // Queues a record, flushing first if the batch is full. Returns false
+    // if the record is too large or the segment file cannot be written.
+    bool append(const uint8_t *data, size_t size);
+    bool flush();
+
+    // Copies the next flushed record into out (STORE_MAX_RECORD bytes) and
+    // returns its length, or -1 when there is nothing left to read
+    int next(uint8_t *out);
+    bool commit();
+    void rewind();
+
+    // Deletes the segments behind the cursor, returns how many
+    size_t compact();
+
+    bool pending() const
+    {
+        return _cursorSegment != _last || _cursorOffset != _writeOffset;
+    }
+    uint32_t segments() const { return _last - _first + 1; }
+    const StoreMetrics &metrics() const { return _metrics; }
+};
+
+SegmentLog::SegmentLog(const Crc32 &crc, const char *dir) : _crc(crc)
+{
+    snprintf(_dir, sizeof(_dir), "%s", dir);
+}
+
+bool SegmentLog::open()
+{
+    close();
+    mkdir(_dir, 0755);
+
+    DIR *dir = opendir(_dir);
+    if (!dir)
+        return false;
+
+    bool found = false;
+    uint32_t first = 0, last = 0;
+    struct dirent *entry;
+    while ((entry = readdir(dir)))
+    {
+        char *end;
+        unsigned long id = strtoul(entry->d_name, &end, 10);
+        if (end == entry->d_name || strcmp(end, ".seg"))
+            continue;
+        if (!found || id < first)
+            first = id;
+        if (!found || id > last)
+            last = id;
+        found = true;
+    }
+    closedir(dir);
+
+    _first = found ? first : 0;
+    if (!readCursor() || _cursorSegment < _first || _cursorSegment > last)
+    {
+        _cursorSegment = _first;
+        _cursorOffset = 0;
+    }
+    _readSegment = _cursorSegment;
+    _readOffset = _cursorOffset;
+
+    return openSegment(found ? last + 1 : 0);
+}
+
+void SegmentLog::close()
+{
+    flush();
+    if (_writer)
+        fclose(_writer);
+    _writer = nullptr;
+    closeReader();
+}
+
+void SegmentLog::closeReader()
+{
+    if (_reader)
+        fclose(_reader);
+    _reader = nullptr;
+}
+
+bool SegmentLog::openSegment(uint32_t segment)
+{
+    if (_writer)
+        fclose(_writer);
+
+    char file[STORE_PATH_SIZE];
+    path(file, segment);
+    _writer = fopen(file, "wb");
+    if (!_writer)
+        return false;
+
+    _last = segment;
+    _writeOffset = 0;
+    _metrics.segmentsCreated++;
+
+    while (segments() > STORE_MAX_SEGMENTS)
+        dropOldest();
+    return true;
+}
+
+void SegmentLog::dropOldest()
+{
+    char file[STORE_PATH_SIZE];
+    path(file, _first);
+    remove(file);
+    _metrics.segmentsDropped++;
+
+    if (_readSegment == _first)
+    {
+        closeReader();
+        _readSegment = _first + 1;
+        _readOffset = 0;
+    }
+    if (_cursorSegment == _first)
+    {
+        _cursorSegment = _first + 1;
+        _cursorOffset = 0;
+    }
+    _first++;
+}
+
+bool SegmentLog::append(const uint8_t *data, size_t size)
+{
+    if (size > STORE_MAX_RECORD || !_writer)
+        return false;
+
+    size_t record = STORE_RECORD_HEADER + size;
+    if (_buffered + record > sizeof(_buffer) && !flush())
+        return false;
+    if (_writeOffset + _buffered + record > STORE_SEGMENT_SIZE)
+    {
+        if (!flush() || !openSegment(_last + 1))
+            return false;
+    }
+
+    uint8_t *p = _buffer + _buffered;
+    p[0] = size;
+    p[1] = size >> 8;
+    memcpy(p + STORE_RECORD_HEADER, data, size);
+    uint32_t sum = _crc.compute(p, 2);
+    sum = _crc.compute(p + STORE_RECORD_HEADER, size, sum);
+    for (int i = 0; i < 4; i++)
+        p[2 + i] = sum >> (8 * i);
+
+    _buffered += record;
+    _metrics.appended++;
+    _metrics.appendedBytes += size;
+    return true;
+}
+
+bool SegmentLog::flush()
+{
+    if (!_buffered || !_writer)
+        return true;
+
+    bool ok = fwrite(_buffer, 1, _buffered, _writer) == _buffered && fflush(_writer) == 0 &&
+              fsync(fileno(_writer)) == 0;
+    if (ok)
+    {
+        written(_writeOffset, _buffered);
+        _writeOffset += _buffered;
+        _metrics.flushes++;
+    }
+    _buffered = 0;
+    return ok;
+}
+
+bool SegmentLog::nextSegment()
+{
+    if (_readSegment >= _last)
+        return false;
+    closeReader();
+    _readSegment++;
+    _readOffset = 0;
+    return true;
+}
+
+int SegmentLog::next(uint8_t *out)
+{
+    for (;;)
+    {
+        if (_readSegment == _last && _readOffset >= _writeOffset)
+            return -1;
+
+        if (!_reader)
+        {
+            char file[STORE_PATH_SIZE];
+            path(file, _readSegment);
+            _reader = fopen(file, "rb");
+            if (!_reader || fseek(_reader, _readOffset, SEEK_SET))
+            {
+                if (!nextSegment())
+                    return -1;
+                continue;
+            }
+        }
+
+        uint8_t header[STORE_RECORD_HEADER];
+        if (fread(header, 1, sizeof(header), _reader) != sizeof(header))
+        {
+            // end of a finished segment, or unflushed end of the current one
+            if (!nextSegment())
+            {
+                closeReader();
+                return -1;
+            }
+            continue;
+        }
+
+        size_t size = header[0] | (header[1] << 8);
+        uint32_t sum = header[2] | (header[3] << 8) | (header[4] << 16) | ((uint32_t)header[5] << 24);
+        if (size > STORE_MAX_RECORD || fread(out, 1, size, _reader) != size ||
+            _crc.compute(out, size, _crc.compute(header, 2)) != sum)
+        {
+            _metrics.corrupt++;
+            if (!nextSegment())
+            {
+                // the segment being written cannot hold a torn record, only
+                // one of the previous run's, which open() never writes to
+                closeReader();
+                _readOffset = _writeOffset;
+                return -1;
+            }
+            continue;
+        }
+
+        _readOffset += STORE_RECORD_HEADER + size;
+        _metrics.read++;
+        return size;
+    }
+}
+
+bool SegmentLog::commit()
+{
+    if (_readSegment == _cursorSegment && _readOffset == _cursorOffset)
+        return true;
+    _cursorSegment = _readSegment;
+    _cursorOffset = _readOffset;
+    return writeCursor();
+}
+
+void SegmentLog::rewind()
+{
+    closeReader();
+    _readSegment = _cursorSegment;
+    _readOffset = _cursorOffset;
+}
+
+size_t SegmentLog::compact()
+{
+    size_t deleted = 0;
+    while (_first < _cursorSegment)
+    {
+        char file[STORE_PATH_SIZE];
+        path(file, _first++);
+        remove(file);
+        _metrics.segmentsDeleted++;
+        deleted++;
+    }
+    return deleted;
+}
+
+bool SegmentLog::readCursor()
+{
+    char file[STORE_PATH_SIZE];
+    snprintf(file, sizeof(file), "%s/cursor", _dir);
+    FILE *f = fopen(file, "rb");
+    if (!f)
+        return false;
+
+    uint8_t data[12];
+    bool ok = fread(data, 1, sizeof(data), f) == sizeof(data);
+    fclose(f);
+
+    uint32_t values[3];
+    for (int v = 0; v < 3; v++)
+        values[v] = data[4 * v] | (data[4 * v + 1] << 8) | (data[4 * v + 2] << 16) | ((uint32_t)data[4 * v + 3] << 24);
+    if (!ok || _crc.compute(data, 8) != values[2])
+        return false;
+
+    _cursorSegment = values[0];
+    _cursorOffset = values[1];
+    return true;
+}
+
+bool SegmentLog::writeCursor()
+{
+    char file[STORE_PATH_SIZE], temp[STORE_PATH_SIZE];
+    snprintf(file, sizeof(file), "%s/cursor", _dir);
+    snprintf(temp, sizeof(temp), "%s/cursor.tmp", _dir);
+
+    uint8_t data[12];
+    uint32_t values[3] = {_cursorSegment, _cursorOffset, 0};
+    for (int v = 0; v < 2; v++)
+    {
+        for (int i = 0; i < 4; i++)
+            data[4 * v + i] = values[v] >> (8 * i);
+    }
+    values[2] = _crc.compute(data, 8);
+    for (int i = 0; i < 4; i++)
+        data[8 + i] = values[2] >> (8 * i);
+
+    FILE *f = fopen(temp, "wb");
+    if (!f)
+        return false;
+    // synced before the rename, so the new cursor is never an empty file
+    bool ok = fwrite(data, 1, sizeof(data), f) == sizeof(data) && fflush(f) == 0 && fsync(fileno(f)) == 0;
+    ok = fclose(f) == 0 && ok;
+    if (!ok)
+        return false;
+
+    // LittleFS and POSIX rename replace the target atomically
+    if (rename(temp, file))
+        return false;
+
+    written(0, sizeof(data));
+    _metrics.cursorWrites++;
+    return true;
+}
+
+#endif
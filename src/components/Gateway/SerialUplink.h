@@ -0,0 +1,182 @@
+#ifndef SERIAL_UPLINK_H
+#define SERIAL_UPLINK_H
+
+#include <Arduino.h>
+#include <mutex>
+#include "UplinkProtocol.h"
+#include "../LoRa/FrameHeader.h"
+
+#ifndef UPLINK_BATCH_SIZE
+#define UPLINK_BATCH_SIZE 2048
+#endif
+
+#define UPLINK_FLUSH_MS 10
+
+static_assert(UPLINK_BATCH_SIZE >= UPLINK_MAX_ENCODED, "UPLINK_BATCH_SIZE must hold the largest record");
+
+// Gateway side of the binary uplink (see UplinkProtocol.h). Encoded records
+// are appended to a batch buffer that goes to the UART in one write when it
+// fills up or UPLINK_FLUSH_MS after its first record, so the driver moves
+// large contiguous blocks instead of one write per frame.
+//
+// It is also a Print: every write() becomes one UPLINK_TYPE_LOG record, so
+// the Logger can drain into it and text never mixes with binary records.
+// Records may be sent from several tasks.
+class SerialUplink : public Print
+{
+  private:
+    HardwareSerial *_port = nullptr;
+    const Crc32 &_crc;
+    std::mutex _lock;
+
+    uint8_t _scratch[UPLINK_MAX_RECORD];
+    uint8_t _batch[UPLINK_BATCH_SIZE];
+    size_t _batchLength = 0;
+    uint32_t _batchStartMs = 0;
+
+    uint32_t _records = 0;
+    uint32_t _bytes = 0;
+    uint32_t _writes = 0;
+
+    void flushLocked();
+
+  public:
+    explicit SerialUplink(const Crc32 &crc) : _crc(crc) {}
+
+    // The TX buffer is sized to hold a whole batch, so writes only block
+    // when the link is saturated
+    void begin(HardwareSerial &port, uint32_t baud);
+
+    bool send(const UplinkHeader &header, const uint8_t *body);
+    bool sendFrame(const char *payload, const PacketInfo &packet);
+
+    // Flushes a batch that has been waiting for UPLINK_FLUSH_MS, call from
+    // loop()
+    void loop();
+    void flush() override;
+
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t *buffer, size_t size) override;
+
+    uint32_t records() const { return _records; }
+    uint32_t bytes() const { return _bytes; }
+    uint32_t writes() const { return _writes; }
+};
+
+// Print adapter that splits a stream of unknown length, e.g. a MsgPack
+// snapshot, into records of one type linked by UPLINK_FLAG_MORE. Call
+// close() to send the last record.
+class UplinkChunkWriter : public Print
+{
+  private:
+    SerialUplink &_uplink;
+    uint8_t _type;
+    uint8_t _buffer[UPLINK_MAX_BODY];
+    size_t _length = 0;
+
+    void send(uint8_t flags)
+    {
+        UplinkHeader header = {};
+        header.type = _type;
+        header.flags = flags;
+        header.length = _length;
+        header.timeUs = micros();
+        _uplink.send(header, _buffer);
+        _length = 0;
+    }
+
+  public:
+    UplinkChunkWriter(SerialUplink &uplink, uint8_t type) : _uplink(uplink), _type(type) {}
+
+    size_t write(uint8_t c) override { return write(&c, 1); }
+
+    size_t write(const uint8_t *buffer, size_t size) override
+    {
+        for (size_t i = 0; i < size; i++)
+        {
+            if (_length == sizeof(_buffer))
+                send(UPLINK_FLAG_MORE);
+            _buffer[_length++] = buffer[i];
+        }
+        return size;
+    }
+
+    void close() { send(0); }
+};
+
+void SerialUplink::begin(HardwareSerial &port, uint32_t baud)
+{
+    _port = &port;
+    _port->setTxBufferSize(UPLINK_BATCH_SIZE * 2);
+    _port->begin(baud);
+}
+
+bool SerialUplink::send(const UplinkHeader &header, const uint8_t *body)
+{
+    std::lock_guard<std::mutex> guard(_lock);
+
+    if (_batchLength + UPLINK_MAX_ENCODED > sizeof(_batch))
+        flushLocked();
+
+    size_t length = uplinkEncode(_crc, header, body, _scratch, _batch + _batchLength);
+    if (!length)
+        return false;
+
+    if (!_batchLength)
+        _batchStartMs = millis();
+    _batchLength += length;
+    _records++;
+    return true;
+}
+
+bool SerialUplink::sendFrame(const char *payload, const PacketInfo &packet)
+{
+    UplinkHeader header = {};
+    header.type = UPLINK_TYPE_FRAME;
+    header.flags = packet.addressed ? UPLINK_FLAG_ADDRESSED : 0;
+    header.hops = packet.hops;
+    header.length = packet.length;
+    header.timeUs = packet.rxDoneUs;
+    header.source = packet.source;
+    header.sequence = packet.sequence;
+    header.rssi = packet.rssi;
+    header.snr = (int16_t)(packet.snr * 16);
+    return send(header, (const uint8_t *)payload);
+}
+
+size_t SerialUplink::write(const uint8_t *buffer, size_t size)
+{
+    if (size > UPLINK_MAX_BODY)
+        size = UPLINK_MAX_BODY;
+
+    UplinkHeader header = {};
+    header.type = UPLINK_TYPE_LOG;
+    header.length = size;
+    header.timeUs = micros();
+    return send(header, buffer) ? size : 0;
+}
+
+void SerialUplink::flushLocked()
+{
+    if (!_batchLength || !_port)
+        return;
+    _port->write(_batch, _batchLength);
+    _bytes += _batchLength;
+    _writes++;
+    _batchLength = 0;
+}
+
+void SerialUplink::flush()
+{
+    std::lock_guard<std::mutex> guard(_lock);
+    flushLocked();
+}
+
+void SerialUplink::loop()
+{
+    std::lock_guard<std::mutex> guard(_lock);
+    if (_batchLength && millis() - _batchStartMs >= UPLINK_FLUSH_MS)
+        flushLocked();
+}
+
+#endif
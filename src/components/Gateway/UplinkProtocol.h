@@ -0,0 +1,109 @@
+#ifndef UPLINK_PROTOCOL_H
+#define UPLINK_PROTOCOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "Cobs.h"
+#include "../LoRa/Crc32.h"
+
+// Binary gateway to host serial protocol, shared by the firmware and the
+// reader under tools/uplink. Each record is
+//
+//   version(1) type(1) flags(1) hops(1) length(2) timeUs(4) source(1)
+//   sequence(1) rssi(2) snr(2, 1/16 dB) | body(length) | CRC32(4)
+//
+// little-endian, CRC32 (IEEE) over header and body, then COBS encoded and
+// terminated by a 0x00 delimiter.
+#define UPLINK_VERSION 1
+#define UPLINK_HEADER_SIZE 16
+#define UPLINK_MAX_BODY 512
+#define UPLINK_MAX_RECORD (UPLINK_HEADER_SIZE + UPLINK_MAX_BODY + 4)
+#define UPLINK_MAX_ENCODED (COBS_MAX_ENCODED(UPLINK_MAX_RECORD) + 1)
+
+#define UPLINK_TYPE_FRAME 0x01 // received LoRa frame, metadata in the header
+#define UPLINK_TYPE_LOG 0x02   // one formatted log line
+#define UPLINK_TYPE_STATS 0x03 // MsgPack link statistics snapshot
+
+#define UPLINK_FLAG_ADDRESSED 0x01 // source, sequence and hops are valid
+#define UPLINK_FLAG_MORE 0x02      // body continues in the next record of the same type
+
+struct UplinkHeader
+{
+    uint8_t type;
+    uint8_t flags;
+    uint8_t hops;
+    uint16_t length;
+    uint32_t timeUs;
+    uint8_t source;
+    uint8_t sequence;
+    int16_t rssi;
+    int16_t snr; // 1/16 dB
+};
+
+// Builds and encodes one record into out (UPLINK_MAX_ENCODED bytes),
+// including the delimiter. scratch holds the raw record
+// (UPLINK_MAX_RECORD bytes). Returns the number of bytes to send, or 0 if
+// the body is too long.
+size_t uplinkEncode(const Crc32 &crc, const UplinkHeader &header, const uint8_t *body, uint8_t *scratch, uint8_t *out)
+{
+    if (header.length > UPLINK_MAX_BODY)
+        return 0;
+
+    uint8_t *p = scratch;
+    *p++ = UPLINK_VERSION;
+    *p++ = header.type;
+    *p++ = header.flags;
+    *p++ = header.hops;
+    *p++ = header.length;
+    *p++ = header.length >> 8;
+    for (int i = 0; i < 4; i++)
+        *p++ = header.timeUs >> (8 * i);
+    *p++ = header.source;
+    *p++ = header.sequence;
+    *p++ = header.rssi;
+    *p++ = (uint16_t)header.rssi >> 8;
+    *p++ = header.snr;
+    *p++ = (uint16_t)header.snr >> 8;
+    memcpy(p, body, header.length);
+    p += header.length;
+
+    uint32_t sum = crc.compute(scratch, p - scratch);
+    for (int i = 0; i < 4; i++)
+        *p++ = sum >> (8 * i);
+
+    size_t length = cobsEncode(scratch, p - scratch, out);
+    out[length++] = 0;
+    return length;
+}
+
+// Decodes one record received between delimiters, in place. On success
+// header is filled in and body points into encoded.
+bool uplinkDecode(const Crc32 &crc, uint8_t *encoded, size_t size, UplinkHeader &header, const uint8_t *&body)
+{
+    size_t length = cobsDecode(encoded, size, encoded);
+    if (length < UPLINK_HEADER_SIZE + 4 || encoded[0] != UPLINK_VERSION)
+        return false;
+
+    const uint8_t *p = encoded;
+    uint32_t sum = p[length - 4] | (p[length - 3] << 8) | (p[length - 2] << 16) | ((uint32_t)p[length - 1] << 24);
+    if (crc.compute(p, length - 4) != sum)
+        return false;
+
+    header.type = p[1];
+    header.flags = p[2];
+    header.hops = p[3];
+    header.length = p[4] | (p[5] << 8);
+    header.timeUs = p[6] | (p[7] << 8) | (p[8] << 16) | ((uint32_t)p[9] << 24);
+    header.source = p[10];
+    header.sequence = p[11];
+    header.rssi = (int16_t)(p[12] | (p[13] << 8));
+    header.snr = (int16_t)(p[14] | (p[15] << 8));
+    if (header.length != length - UPLINK_HEADER_SIZE - 4)
+        return false;
+
+    body = p + UPLINK_HEADER_SIZE;
+    return true;
+}
+
+#endif
@@ -0,0 +1,325 @@
+#ifndef AES_CCM_H
+#define AES_CCM_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(ESP32)
+#include "mbedtls/aes.h"
+#endif
+
+#define AES_BLOCK_SIZE 16
+#define AES_KEY_SIZE 16
+#define CCM_NONCE_SIZE 13
+
+// Portable table-free AES-128 with the key schedule expanded once in
+// setKey(). Only the forward direction is needed since CCM uses AES in
+// counter mode.
+class PortableAes128
+{
+  private:
+    uint8_t _roundKeys[176];
+
+    static uint8_t xtime(uint8_t x)
+    {
+        return (x << 1) ^ ((x & 0x80) ? 0x1B : 0x00);
+    }
+
+    static const uint8_t *sbox()
+    {
+        static const uint8_t table[256] = {
+            0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76,
+            0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0, 0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0,
+            0xb7, 0xfd, 0x93, 0x26, 0x36, 0x3f, 0xf7, 0xcc, 0x34, 0xa5, 0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15,
+            0x04, 0xc7, 0x23, 0xc3, 0x18, 0x96, 0x05, 0x9a, 0x07, 0x12, 0x80, 0xe2, 0xeb, 0x27, 0xb2, 0x75,
+            0x09, 0x83, 0x2c, 0x1a, 0x1b, 0x6e, 0x5a, 0xa0, 0x52, 0x3b, 0xd6, 0xb3, 0x29, 0xe3, 0x2f, 0x84,
+            0x53, 0xd1, 0x00, 0xed, 0x20, 0xfc, 0xb1, 0x5b, 0x6a, 0xcb, 0xbe, 0x39, 0x4a, 0x4c, 0x58, 0xcf,
+            0xd0, 0xef, 0xaa, 0xfb, 0x43, 0x4d, 0x33, 0x85, 0x45, 0xf9, 0x02, 0x7f, 0x50, 0x3c, 0x9f, 0xa8,
+            0x51, 0xa3, 0x40, 0x8f, 0x92, 0x9d, 0x38, 0xf5, 0xbc, 0xb6, 0xda, 0x21, 0x10, 0xff, 0xf3, 0xd2,
+            0xcd, 0x0c, 0x13, 0xec, 0x5f, 0x97, 0x44, 0x17, 0xc4, 0xa7, 0x7e, 0x3d, 0x64, 0x5d, 0x19, 0x73,
+            0x60, 0x81, 0x4f, 0xdc, 0x22, 0x2a, 0x90, 0x88, 0x46, 0xee, 0xb8, 0x14, 0xde, 0x5e, 0x0b, 0xdb,
+            0xe0, 0x32, 0x3a, 0x0a, 0x49, 0x06, 0x24, 0x5c, 0xc2, 0xd3, 0xac, 0x62, 0x91, 0x95, 0xe4, 0x79,
+            0xe7, 0xc8, 0x37, 0x6d, 0x8d, 0xd5, 0x4e, 0xa9, 0x6c, 0x56, 0xf4, 0xea, 0x65, 0x7a, 0xae, 0x08,
+            0xba, 0x78, 0x25, 0x2e, 0x1c, 0xa6, 0xb4, 0xc6, 0xe8, 0xdd, 0x74, 0x1f, 0x4b, 0xbd, 0x8b, 0x8a,
+            0x70, 0x3e, 0xb5, 0x66, 0x48, 0x03, 0xf6, 0x0e, 0x61, 0x35, 0x57, 0xb9, 0x86, 0xc1, 0x1d, 0x9e,
+            0xe1, 0xf8, 0x98, 0x11, 0x69, 0xd9, 0x8e, 0x94, 0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf,
+            0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68, 0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16};
+        return table;
+    }
+
+  public:
+    PortableAes128();
+    ~PortableAes128();
+
+    PortableAes128(const PortableAes128 &) = delete;
+    PortableAes128 &operator=(const PortableAes128 &) = delete;
+
+    void setKey(const uint8_t key[AES_KEY_SIZE]);
+    void encryptBlock(const uint8_t input[AES_BLOCK_SIZE], uint8_t output[AES_BLOCK_SIZE]) const;
+};
+
+PortableAes128::PortableAes128()
+{
+    memset(_roundKeys, 0, sizeof(_roundKeys));
+}
+
+PortableAes128::~PortableAes128()
+{
+    memset(_roundKeys, 0, sizeof(_roundKeys));
+}
+
+void PortableAes128::setKey(const uint8_t key[AES_KEY_SIZE])
+{
+    const uint8_t *s = sbox();
+    memcpy(_roundKeys, key, AES_KEY_SIZE);
+
+    uint8_t rcon = 0x01;
+    for (int i = AES_KEY_SIZE; i < 176; i += 4)
+    {
+        uint8_t t[4];
+        memcpy(t, _roundKeys + i - 4, 4);
+        if (i % AES_KEY_SIZE == 0)
+        {
+            uint8_t first = t[0];
+            t[0] = s[t[1]] ^ rcon;
+            t[1] = s[t[2]];
+            t[2] = s[t[3]];
+            t[3] = s[first];
+            rcon = xtime(rcon);
+        }
+        for (int j = 0; j < 4; j++)
+            _roundKeys[i + j] = _roundKeys[i + j - AES_KEY_SIZE] ^ t[j];
+    }
+}
+
+void PortableAes128::encryptBlock(const uint8_t input[AES_BLOCK_SIZE], uint8_t output[AES_BLOCK_SIZE]) const
+{
+    const uint8_t *s = sbox();
+    uint8_t state[AES_BLOCK_SIZE];
+
+    for (int i = 0; i < AES_BLOCK_SIZE; i++)
+        state[i] = input[i] ^ _roundKeys[i];
+
+    for (int round = 1; round <= 10; round++)
+    {
+        // SubBytes and ShiftRows; the state is stored column by column
+        uint8_t shifted[AES_BLOCK_SIZE];
+        for (int column = 0; column < 4; column++)
+        {
+            for (int row = 0; row < 4; row++)
+                shifted[4 * column + row] = s[state[4 * ((column + row) % 4) + row]];
+        }
+
+        if (round < 10)
+        {
+            // MixColumns
+            for (int column = 0; column < 4; column++)
+            {
+                uint8_t *c = shifted + 4 * column;
+                uint8_t all = c[0] ^ c[1] ^ c[2] ^ c[3];
+                uint8_t first = c[0];
+                c[0] ^= all ^ xtime(c[0] ^ c[1]);
+                c[1] ^= all ^ xtime(c[1] ^ c[2]);
+                c[2] ^= all ^ xtime(c[2] ^ c[3]);
+                c[3] ^= all ^ xtime(c[3] ^ first);
+            }
+        }
+
+        for (int i = 0; i < AES_BLOCK_SIZE; i++)
+            state[i] = shifted[i] ^ _roundKeys[16 * round + i];
+    }
+
+    memcpy(output, state, AES_BLOCK_SIZE);
+}
+
+#if defined(ESP32)
+
+// AES-128 through mbedtls, which uses the AES hardware accelerator. The
+// portable class stays available on the ESP32 to compare the two.
+class Aes128
+{
+  private:
+    mutable mbedtls_aes_context _context;
+
+  public:
+    Aes128();
+    ~Aes128();
+
+    Aes128(const Aes128 &) = delete;
+    Aes128 &operator=(const Aes128 &) = delete;
+
+    void setKey(const uint8_t key[AES_KEY_SIZE]);
+    void encryptBlock(const uint8_t input[AES_BLOCK_SIZE], uint8_t output[AES_BLOCK_SIZE]) const;
+};
+
+Aes128::Aes128()
+{
+    mbedtls_aes_init(&_context);
+}
+
+Aes128::~Aes128()
+{
+    mbedtls_aes_free(&_context);
+}
+
+void Aes128::setKey(const uint8_t key[AES_KEY_SIZE])
+{
+    mbedtls_aes_setkey_enc(&_context, key, 128);
+}
+
+void Aes128::encryptBlock(const uint8_t input[AES_BLOCK_SIZE], uint8_t output[AES_BLOCK_SIZE]) const
+{
+    mbedtls_aes_crypt_ecb(&_context, MBEDTLS_AES_ENCRYPT, input, output);
+}
+
+#else
+
+// The block cipher the firmware uses: the accelerator on the ESP32, the
+// portable implementation elsewhere
+typedef PortableAes128 Aes128;
+
+#endif
+
+// AES-CCM (RFC 3610) with a 13-byte nonce and a 2-byte length field, which
+// covers any LoRa frame. The payload is encrypted or decrypted in place.
+// Cipher is Aes128 or PortableAes128, anything with encryptBlock().
+class AesCcm
+{
+  private:
+    static void formatCounter(uint8_t block[AES_BLOCK_SIZE], const uint8_t nonce[CCM_NONCE_SIZE], uint16_t counter)
+    {
+        block[0] = 1; // L - 1
+        memcpy(block + 1, nonce, CCM_NONCE_SIZE);
+        block[14] = counter >> 8;
+        block[15] = counter;
+    }
+
+    template <typename Cipher>
+    static void mac(const Cipher &cipher, const uint8_t nonce[CCM_NONCE_SIZE],
+                    const uint8_t *aad, size_t aadSize,
+                    const uint8_t *plaintext, size_t size,
+                    uint8_t tagSize, uint8_t tag[AES_BLOCK_SIZE]);
+
+    template <typename Cipher>
+    static void crypt(const Cipher &cipher, const uint8_t nonce[CCM_NONCE_SIZE], uint8_t *data, size_t size);
+
+  public:
+    // Encrypts data in place and writes tagSize (4, 6, 8...16) bytes of tag.
+    template <typename Cipher>
+    static void seal(const Cipher &cipher, const uint8_t nonce[CCM_NONCE_SIZE],
+                     const uint8_t *aad, size_t aadSize,
+                     uint8_t *data, size_t size,
+                     uint8_t *tag, uint8_t tagSize);
+
+    // Decrypts data in place. Returns false, leaving garbage in data, when
+    // the tag does not authenticate the ciphertext and the additional data.
+    template <typename Cipher>
+    static bool open(const Cipher &cipher, const uint8_t nonce[CCM_NONCE_SIZE],
+                     const uint8_t *aad, size_t aadSize,
+                     uint8_t *data, size_t size,
+                     const uint8_t *tag, uint8_t tagSize);
+};
+
+template <typename Cipher>
+void AesCcm::mac(const Cipher &cipher, const uint8_t nonce[CCM_NONCE_SIZE],
+                 const uint8_t *aad, size_t aadSize,
+                 const uint8_t *plaintext, size_t size,
+                 uint8_t tagSize, uint8_t tag[AES_BLOCK_SIZE])
+{
+    uint8_t x[AES_BLOCK_SIZE];
+
+    x[0] = (aadSize ? 0x40 : 0x00) | (((tagSize - 2) / 2) << 3) | 1;
+    memcpy(x + 1, nonce, CCM_NONCE_SIZE);
+    x[14] = size >> 8;
+    x[15] = size;
+    cipher.encryptBlock(x, x);
+
+    if (aadSize)
+    {
+        // the 2-byte length prefix shares the first block with the data
+        x[0] ^= aadSize >> 8;
+        x[1] ^= aadSize;
+        size_t used = 2;
+        for (size_t i = 0; i < aadSize; i++)
+        {
+            x[used++] ^= aad[i];
+            if (used == AES_BLOCK_SIZE)
+            {
+                cipher.encryptBlock(x, x);
+                used = 0;
+            }
+        }
+        if (used)
+            cipher.encryptBlock(x, x);
+    }
+
+    for (size_t i = 0; i < size; i += AES_BLOCK_SIZE)
+    {
+        size_t n = size - i < AES_BLOCK_SIZE ? size - i : AES_BLOCK_SIZE;
+        for (size_t j = 0; j < n; j++)
+            x[j] ^= plaintext[i + j];
+        cipher.encryptBlock(x, x);
+    }
+
+    memcpy(tag, x, AES_BLOCK_SIZE);
+}
+
+template <typename Cipher>
+void AesCcm::crypt(const Cipher &cipher, const uint8_t nonce[CCM_NONCE_SIZE], uint8_t *data, size_t size)
+{
+    uint8_t counter[AES_BLOCK_SIZE];
+    uint8_t stream[AES_BLOCK_SIZE];
+
+    for (size_t i = 0; i < size; i += AES_BLOCK_SIZE)
+    {
+        formatCounter(counter, nonce, i / AES_BLOCK_SIZE + 1);
+        cipher.encryptBlock(counter, stream);
+
+        size_t n = size - i < AES_BLOCK_SIZE ? size - i : AES_BLOCK_SIZE;
+        for (size_t j = 0; j < n; j++)
+            data[i + j] ^= stream[j];
+    }
+}
+
+template <typename Cipher>
+void AesCcm::seal(const Cipher &cipher, const uint8_t nonce[CCM_NONCE_SIZE],
+                  const uint8_t *aad, size_t aadSize,
+                  uint8_t *data, size_t size,
+                  uint8_t *tag, uint8_t tagSize)
+{
+    uint8_t t[AES_BLOCK_SIZE];
+    uint8_t block[AES_BLOCK_SIZE];
+
+    mac(cipher, nonce, aad, aadSize, data, size, tagSize, t);
+    crypt(cipher, nonce, data, size);
+
+    formatCounter(block, nonce, 0);
+    cipher.encryptBlock(block, block);
+    for (int i = 0; i < tagSize; i++)
+        tag[i] = t[i] ^ block[i];
+}
+
+template <typename Cipher>
+bool AesCcm::open(const Cipher &cipher, const uint8_t nonce[CCM_NONCE_SIZE],
+                  const uint8_t *aad, size_t aadSize,
+                  uint8_t *data, size_t size,
+                  const uint8_t *tag, uint8_t tagSize)
+{
+    uint8_t t[AES_BLOCK_SIZE];
+    uint8_t block[AES_BLOCK_SIZE];
+
+    crypt(cipher, nonce, data, size);
+    mac(cipher, nonce, aad, aadSize, data, size, tagSize, t);
+
+    formatCounter(block, nonce, 0);
+    cipher.encryptBlock(block, block);
+
+    // constant time comparison
+    uint8_t diff = 0;
+    for (int i = 0; i < tagSize; i++)
+        diff |= tag[i] ^ t[i] ^ block[i];
+    return diff == 0;
+}
+
+#endif
@@ -0,0 +1,100 @@
+#ifndef CRC32_H
+#define CRC32_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define CRC32_IEEE 0xEDB88320UL       // reflected 0x04C11DB7 (zlib, Ethernet)
+#define CRC32_CASTAGNOLI 0x82F63B78UL // reflected 0x1EDC6F41 (CRC32C, iSCSI)
+
+// Number of 256-entry lookup tables. 8 processes eight bytes per iteration
+// and needs 8 KiB of RAM, 4 needs 4 KiB, 1 is the classic bytewise table
+// (1 KiB). The tables are generated at construction time so they land in
+// DRAM rather than in flash, where each lookup would go through the cache.
+#ifndef CRC32_SLICES
+#define CRC32_SLICES 8
+#endif
+
+static_assert(CRC32_SLICES == 1 || CRC32_SLICES == 4 || CRC32_SLICES == 8, "CRC32_SLICES must be 1, 4 or 8");
+
+class Crc32
+{
+  private:
+    uint32_t _table[CRC32_SLICES][256];
+
+    static uint32_t load32(const uint8_t *p)
+    {
+        return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+    }
+
+  public:
+    explicit Crc32(uint32_t polynomial = CRC32_IEEE);
+
+    // Continues a running CRC; pass the value returned by a previous call
+    // (or 0 to start) to checksum data split across several buffers.
+    uint32_t compute(const uint8_t *data, size_t size, uint32_t crc = 0) const;
+    uint32_t computeBytewise(const uint8_t *data, size_t size, uint32_t crc = 0) const;
+};
+
+Crc32::Crc32(uint32_t polynomial)
+{
+    for (uint32_t i = 0; i < 256; i++)
+    {
+        uint32_t crc = i;
+        for (int bit = 0; bit < 8; bit++)
+            crc = (crc >> 1) ^ (polynomial & (0 - (crc & 1)));
+        _table[0][i] = crc;
+    }
+
+    for (int slice = 1; slice < CRC32_SLICES; slice++)
+    {
+        for (int i = 0; i < 256; i++)
+        {
+            uint32_t prev = _table[slice - 1][i];
+            _table[slice][i] = (prev >> 8) ^ _table[0][prev & 0xFF];
+        }
+    }
+}
+
+uint32_t Crc32::compute(const uint8_t *data, size_t size, uint32_t crc) const
+{
+    crc = ~crc;
+
+#if CRC32_SLICES == 8
+    while (size >= 8)
+    {
+        uint32_t one = load32(data) ^ crc;
+        uint32_t two = load32(data + 4);
+        crc = _table[7][one & 0xFF] ^ _table[6][(one >> 8) & 0xFF] ^
+              _table[5][(one >> 16) & 0xFF] ^ _table[4][one >> 24] ^
+              _table[3][two & 0xFF] ^ _table[2][(two >> 8) & 0xFF] ^
+              _table[1][(two >> 16) & 0xFF] ^ _table[0][two >> 24];
+        data += 8;
+        size -= 8;
+    }
+#elif CRC32_SLICES == 4
+    while (size >= 4)
+    {
+        uint32_t one = load32(data) ^ crc;
+        crc = _table[3][one & 0xFF] ^ _table[2][(one >> 8) & 0xFF] ^
+              _table[1][(one >> 16) & 0xFF] ^ _table[0][one >> 24];
+        data += 4;
+        size -= 4;
+    }
+#endif
+
+    while (size--)
+        crc = _table[0][(crc ^ *data++) & 0xFF] ^ (crc >> 8);
+
+    return ~crc;
+}
+
+uint32_t Crc32::computeBytewise(const uint8_t *data, size_t size, uint32_t crc) const
+{
+    crc = ~crc;
+    while (size--)
+        crc = _table[0][(crc ^ *data++) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+#endif
@@ -0,0 +1,91 @@
+#ifndef FRAME_HEADER_H
+#define FRAME_HEADER_H
+
+#include <stdint.h>
+
+#define FRAME_BROADCAST 0xFF
+#define FRAME_HEADER_SIZE 5
+
+// Frame types, stored in the low nibble of FrameHeader::flags
+#define FRAME_TYPE_MASK 0x0F
+#define FRAME_TYPE_DATA 0x00
+#define FRAME_TYPE_BEACON 0x01 // TDMA slot map, see TdmaScheduler
+#define FRAME_TYPE_JOIN 0x02   // TDMA slot request, header only
+
+// Option bits, stored in the high nibble of FrameHeader::flags
+#define FRAME_FLAG_CRC32 0x10 // 4-byte CRC32 trailer over header and payload
+#define FRAME_FLAG_FEC 0x20   // Reed-Solomon parity after payload and trailer
+#define FRAME_FLAG_SECURE 0x40 // AES-CCM encrypted payload, see Custom_LoRa::setKey
+#define FRAME_FLAG_MESH 0x80   // MeshHeader follows the frame header
+
+#define FRAME_CRC32_SIZE 4
+#define FRAME_COUNTER_SIZE 4 // frame counter in front of an encrypted payload
+#define FRAME_MIC_SIZE 4     // CCM tag after an encrypted payload
+
+// Fixed link header placed in front of every addressed frame. All fields are
+// single bytes so the struct has no padding and maps 1:1 onto the FIFO bytes.
+struct FrameHeader
+{
+    uint8_t network;
+    uint8_t destination;
+    uint8_t source;
+    uint8_t sequence;
+    uint8_t flags;
+};
+
+static_assert(sizeof(FrameHeader) == FRAME_HEADER_SIZE, "FrameHeader must not be padded");
+
+#define MESH_HEADER_SIZE 4
+#define MESH_MAX_HOPS 8
+
+// Per-hop routing fields of a mesh frame. Relays rewrite them in place, so
+// they are excluded from the CRC32 trailer and from the CCM additional data;
+// network, source, destination and sequence stay end-to-end protected.
+struct MeshHeader
+{
+    uint8_t previousHop; // node that transmitted this copy
+    uint8_t nextHop;     // relay expected to forward it, or FRAME_BROADCAST to flood
+    uint8_t ttl;         // remaining hops
+    uint8_t hops;        // hops travelled so far
+};
+
+static_assert(sizeof(MeshHeader) == MESH_HEADER_SIZE, "MeshHeader must not be padded");
+
+// Metadata of the frame being delivered to the receive callback
+struct PacketInfo
+{
+    bool addressed;  // header fields below are valid
+    uint8_t source;
+    uint8_t sequence;
+    uint8_t hops;    // mesh hops travelled, 0 when heard directly
+    uint8_t length;  // payload bytes, the payload may contain NULs
+    int16_t rssi;
+    float snr;
+    uint32_t rxDoneUs; // DIO0 RxDone timestamp
+};
+
+struct LoRaStats
+{
+    uint32_t received;        // frames reported by the radio
+    uint32_t accepted;        // frames delivered to the callback
+    uint32_t rejectedShort;   // shorter than a frame header
+    uint32_t rejectedNetwork; // foreign network id
+    uint32_t rejectedAddress; // addressed to another node
+    uint32_t crcErrors;       // CRC32 trailer mismatch
+    uint32_t radioCrcErrors;  // dropped by the radio's 16-bit payload CRC
+    uint32_t fecCorrected;    // bytes repaired by Reed-Solomon decoding
+    uint32_t fecFailures;     // frames with more errors than the parity can fix
+    uint32_t unknownPeers;    // encrypted frame from a source without a key
+    uint32_t replays;         // frame counter not above the last one accepted
+    uint32_t authFailures;    // CCM tag mismatch
+    uint32_t beacons;         // TDMA beacons sent (gateway) or received (node)
+    uint32_t txQueueDrops;    // frames dropped because the TX queue was full
+    uint32_t duplicates;      // mesh frames already seen
+    uint32_t ttlExpired;      // mesh frames not relayed because their TTL ran out
+    uint32_t relayed;         // mesh frames forwarded
+    uint32_t relayLatencyMaxUs;
+    uint64_t relayLatencyTotalUs; // RxDone to start of the forwarded transmission
+    uint32_t hops[MESH_MAX_HOPS]; // delivered mesh frames by hop count, last bucket is MESH_MAX_HOPS - 1 or more
+};
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef FRAME_QUEUE_H
+#define FRAME_QUEUE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifndef LORA_TX_QUEUE_SIZE
+#define LORA_TX_QUEUE_SIZE 4
+#endif
+
+struct QueuedFrame
+{
+    uint8_t length;
+    bool relay;
+    uint32_t notBeforeUs; // earliest transmit time, e.g. relay jitter
+    uint32_t receivedUs;  // RxDone of a relayed frame, for latency metrics
+    uint32_t backoffUs;   // TDMA contention backoff
+    uint8_t data[255];
+};
+
+// Fixed ring of complete frames waiting for the channel. Frames are copied
+// in as-is, ready to be written to the radio FIFO.
+class FrameQueue
+{
+  private:
+    QueuedFrame _frames[LORA_TX_QUEUE_SIZE];
+    uint8_t _head = 0;
+    uint8_t _count = 0;
+
+  public:
+    bool empty() const { return _count == 0; }
+    bool full() const { return _count == LORA_TX_QUEUE_SIZE; }
+
+    // Returns the slot to fill, or nullptr when the queue is full
+    QueuedFrame *push()
+    {
+        if (full())
+            return nullptr;
+        QueuedFrame *frame = &_frames[(_head + _count) % LORA_TX_QUEUE_SIZE];
+        _count++;
+        return frame;
+    }
+
+    // Gives back the slot of the last push(), which must not have been
+    // transmitted yet
+    void unpush()
+    {
+        if (_count)
+            _count--;
+    }
+
+    QueuedFrame *front()
+    {
+        return _count ? &_frames[_head] : nullptr;
+    }
+
+    void pop()
+    {
+        if (_count)
+        {
+            _head = (_head + 1) % LORA_TX_QUEUE_SIZE;
+            _count--;
+        }
+    }
+};
+
+#endif
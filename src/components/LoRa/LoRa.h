@@ -1,62 +1,443 @@
 #include <Arduino.h>
 #include <LoRa.h>
 #include <functional>
+#if defined(ESP32)
+#include <Preferences.h>
+#endif
+#include "FrameHeader.h"
+#include "Crc32.h"
+#include "../Utils/Logger.h"
+#include "ReedSolomon.h"
+#include "AesCcm.h"
+#include "RadioConfig.h"
+#include "TdmaScheduler.h"
+#include "MeshTable.h"
+#include "FrameQueue.h"
+#include "RadioPipeline.h"
+
+#define LORA_MAX_PEERS 8
+#define LORA_COUNTER_WINDOW 1024 // frame counters reserved per flash write
+
+#ifndef LORA_MESH_TABLE_SIZE
+#define LORA_MESH_TABLE_SIZE 32 // sources tracked by the seen cache and the route table
+#endif
+#define LORA_MESH_MAX_AGE_MS 120000
+#define LORA_RELAY_JITTER_US 50000 // spreads out relays that heard the same frame
+
+#define LORA_WARM_MAGIC 0x4C6F5261
+#define LORA_WARM_FIRST_REG 0x01 // REG_OP_MODE
+#define LORA_WARM_REGS 0x42      // burst up to and including REG_VERSION
+
+#if defined(ESP32)
+#define LORA_ISR_ATTR IRAM_ATTR
+#define LORA_RETAINED_ATTR RTC_NOINIT_ATTR // survives deep sleep and software resets
+#else
+#define LORA_ISR_ATTR
+#define LORA_RETAINED_ATTR
+#endif
+
+// Registers that hold the configuration begin() writes: frequency, PA, OCP,
+// LNA, FIFO base addresses, modem config, preamble, sync word, IQ and the
+// chip version
+static const uint8_t LORA_WARM_CHECKED[] = {0x06, 0x07, 0x08, 0x09, 0x0B, 0x0C, 0x0E, 0x0F, 0x1D, 0x1E,
+                                            0x20, 0x21, 0x26, 0x31, 0x33, 0x37, 0x39, 0x3B, 0x42};
+
+struct LoRaPeer
+{
+    bool used;
+    bool seen;
+    uint8_t address;
+    uint32_t lastCounter;
+    Aes128 cipher;
+};
+
+// Radio configuration left by the last cold start, kept in RTC memory.
+// Plain data so that nothing initialises it at boot.
+struct WarmState
+{
+    uint32_t magic;
+    uint32_t configHash;
+    uint8_t registers[LORA_WARM_REGS];
+    uint32_t checksum;
+};
+
+struct StartupStats
+{
+    bool warm;          // the radio kept its configuration, no reset
+    uint32_t beginUs;   // time spent in begin()
+    uint32_t firstRxUs; // micros() since boot when RX was first armed
+};
 
 class Custom_LoRa
 {
+    // calls poll() and transmit()
+    friend class RadioPipeline<Custom_LoRa>;
+
   private:
     uint8_t _ss;
     uint8_t _rst;
     uint8_t _dio0;
 
-    String LoRaData;
+    RadioConfig _radio;
+    static volatile uint32_t _dio0Micros;
+    static LORA_ISR_ATTR void onDio0Rise();
 
-    std::function<void(const char *, int rrsi)> callback;
-    void emit(const char *data, int rssi)
-    {
-        callback(data, rssi);
-    }
+    static WarmState _warmState;
+    StartupStats _startup = {};
+
+    bool _addressing = false;
+    uint8_t _network = 0;
+    uint8_t _address = 0;
+    uint8_t _sequence = 0;
+
+    const Crc32 *_crc32 = nullptr; // not owned, shared with the rest of the firmware
+    ReedSolomon *_fec = nullptr;
+    uint8_t _fecDepth = 1;
+
+    LoRaPeer _peers[LORA_MAX_PEERS] = {};
+    uint32_t _txCounter = 0;
+    uint32_t _txCounterLimit = 0;
+
+    TdmaScheduler *_tdma = nullptr;
+    bool _tdmaGateway = false;
+    uint32_t _tdmaErrors = 0; // corrupted frames counted at the last beacon
+
+    bool _relay = false;
+    uint8_t _meshTtl = 0;
+    MeshTable<SeenEntry, LORA_MESH_TABLE_SIZE> *_seen = nullptr;
+    MeshTable<RouteEntry, LORA_MESH_TABLE_SIZE> *_routes = nullptr;
+
+    FrameQueue _txQueue;
+
+    FrameHeader _rxHeader;
+    MeshHeader _rxMesh;
+    uint8_t _rxBuffer[LORA_MAX_FRAME + 1];
+    uint8_t _txBuffer[LORA_MAX_FRAME];
+
+    LoRaStats _stats = {};
+    PacketInfo _rxInfo = {};
+
+    RadioPipeline<Custom_LoRa> _pipeline;
+
+    bool acceptHeader(const FrameHeader &header, bool mesh);
+    bool checkCrc32(size_t &length);
+    LoRaPeer *findPeer(uint8_t address);
+    void reserveCounters();
+    void makeNonce(uint8_t nonce[CCM_NONCE_SIZE], const FrameHeader &header, uint32_t counter);
+    bool openSecure(uint8_t *&payload, size_t &length);
+    size_t frameOverhead();
+    size_t buildFrame(uint8_t type, uint8_t destination, const uint8_t *body, size_t size);
+    void serviceTdma(uint32_t now);
+    void serviceQueue(uint32_t now);
+    bool enqueue(const uint8_t *frame, size_t length, uint32_t backoffUs);
+    uint8_t nextHopFor(uint8_t destination);
+    bool meshDuplicate();
+    bool meshReceive(QueuedFrame *relayed);
+    QueuedFrame *stageRelay(size_t length, uint32_t rxDone);
+    void transmit(const char *payload, size_t size, uint8_t destination);
+    void poll();
+    static uint32_t fnv1a(uint32_t hash, const void *data, size_t size);
+    static uint32_t configHash(const RadioConfig &config);
+    bool resumeRadio(const RadioConfig &config);
+    void saveWarmState(const RadioConfig &config);
 
   public:
     Custom_LoRa(uint8_t ss, uint8_t rst, uint8_t dio0);
     ~Custom_LoRa();
 
     bool begin(uint32_t frequency);
+    bool begin(const RadioConfig &config);
+    void setAddress(uint8_t network, uint8_t address);
+    void enableCrc32(const Crc32 &crc);
+    void enableFec(uint8_t parity, uint8_t depth = 1);
+    bool setKey(uint8_t peer, const uint8_t key[AES_KEY_SIZE]);
+    void enableTdmaGateway(uint8_t maxFrame = TDMA_DEFAULT_MAX_FRAME,
+                           uint8_t contentionSlots = TDMA_DEFAULT_CONTENTION_SLOTS);
+    void enableTdmaNode();
+    void enableMesh(bool relay, uint8_t ttl = 4, bool routing = true);
     uint8_t sendPackage(uint8_t *data, uint8_t size);
     void sendPayload(const char *payload);
+    void sendPayload(const char *payload, uint8_t destination);
     void onReceive(std::function<void(const char *, int)> callback);
     void loop();
+
+    // Moves the radio pipeline to its own task, pinned to core. Received
+    // frames reach the callback from loop() through a lock-free queue and
+    // sendPayload() queues frames for the task, so the Arduino loop only
+    // runs application code. Configure everything before starting it.
+    bool startTask(int core = 0, uint8_t priority = 5);
+    void stopTask();
+
+    const LoRaStats &stats() const { return _stats; }
+    const RuntimeStats &runtimeStats() const { return _pipeline.stats(); }
+    const StartupStats &startupStats() const { return _startup; }
+
+    // Valid inside the receive callback, describes the frame being delivered
+    const PacketInfo &lastPacket() const { return _pipeline.delivered(); }
 };
 
-Custom_LoRa::Custom_LoRa(uint8_t ss, uint8_t rst, uint8_t dio0) : _ss(ss), _rst(rst), _dio0(dio0)
+Custom_LoRa::Custom_LoRa(uint8_t ss, uint8_t rst, uint8_t dio0) : _ss(ss), _rst(rst), _dio0(dio0), _pipeline(*this)
 {
 }
 
 Custom_LoRa::~Custom_LoRa()
 {
+    stopTask();
+    delete _fec;
+    delete _tdma;
+    delete _seen;
+    delete _routes;
+}
+
+volatile uint32_t Custom_LoRa::_dio0Micros = 0;
+LORA_RETAINED_ATTR WarmState Custom_LoRa::_warmState;
+
+// DIO0 rises on RxDone and TxDone; the timestamp is taken here because the
+// radio is only polled from loop() and may be serviced milliseconds later.
+LORA_ISR_ATTR void Custom_LoRa::onDio0Rise()
+{
+    _dio0Micros = micros();
 }
 
 bool Custom_LoRa::begin(uint32_t frequency)
 {
+    RadioConfig config;
+    config.frequency = frequency;
+    return begin(config);
+}
+
+// After deep sleep or a crash reboot the radio usually still holds the
+// configuration of the last cold start. If the configuration asked for is
+// the same and one burst read shows the registers unchanged, the reset and
+// the register writes are skipped.
+bool Custom_LoRa::begin(const RadioConfig &config)
+{
+    uint32_t beginStart = micros();
+    _radio = config;
     LoRa.setPins(_ss, _rst, _dio0); // setup LoRa transceiver module
 
-    uint32_t start = millis();
-    while (!LoRa.begin(frequency)) // 433E6 - Asia, 866E6 - Europe, 915E6 - North America
+    _startup.warm = resumeRadio(config);
+    if (!_startup.warm)
     {
-        if (millis() - start > 10000)
+        uint32_t start = millis();
+        while (!LoRa.begin(config.frequency)) // 433E6 - Asia, 866E6 - Europe, 915E6 - North America
         {
-            return false;
+            if (millis() - start > 10000)
+            {
+                return false;
+            }
+            LOG(".");
+            delay(500);
         }
-        Serial.println(".");
-        delay(500);
+
+        LoRa.setSpreadingFactor(config.spreadingFactor);
+        LoRa.setSignalBandwidth(config.bandwidth);
+        LoRa.setCodingRate4(config.codingRate);
+        LoRa.setPreambleLength(config.preambleLength);
+        LoRa.setSyncWord(config.syncWord);
+        if (config.crc)
+            LoRa.enableCrc();
+        else
+            LoRa.disableCrc();
+
+        saveWarmState(config);
     }
 
-    LoRa.setSyncWord(0xA5);
-    Serial.println("LoRa Initializing OK!");
+    pinMode(_dio0, INPUT);
+    attachInterrupt(digitalPinToInterrupt(_dio0), onDio0Rise, RISING);
+
+    _startup.beginUs = micros() - beginStart;
+    LOG("LoRa Initializing OK! %s start in %u us", _startup.warm ? "Warm" : "Cold", _startup.beginUs);
 
     return true;
 }
 
+uint32_t Custom_LoRa::fnv1a(uint32_t hash, const void *data, size_t size)
+{
+    const uint8_t *bytes = (const uint8_t *)data;
+    for (size_t i = 0; i < size; i++)
+        hash = (hash ^ bytes[i]) * 16777619u;
+    return hash;
+}
+
+uint32_t Custom_LoRa::configHash(const RadioConfig &config)
+{
+    // field by field, RadioConfig has padding
+    uint32_t hash = 2166136261u;
+    hash = fnv1a(hash, &config.frequency, sizeof(config.frequency));
+    hash = fnv1a(hash, &config.spreadingFactor, sizeof(config.spreadingFactor));
+    hash = fnv1a(hash, &config.bandwidth, sizeof(config.bandwidth));
+    hash = fnv1a(hash, &config.codingRate, sizeof(config.codingRate));
+    hash = fnv1a(hash, &config.preambleLength, sizeof(config.preambleLength));
+    hash = fnv1a(hash, &config.syncWord, sizeof(config.syncWord));
+    return fnv1a(hash, &config.crc, sizeof(config.crc));
+}
+
+bool Custom_LoRa::resumeRadio(const RadioConfig &config)
+{
+    // garbage after power-on fails the checksum
+    const WarmState &state = _warmState;
+    if (state.magic != LORA_WARM_MAGIC || state.configHash != configHash(config) ||
+        state.checksum != fnv1a(2166136261u, &state, offsetof(WarmState, checksum)))
+        return false;
+
+    if (!LoRa.resume(config.frequency))
+        return false;
+
+    uint8_t registers[LORA_WARM_REGS];
+    LoRa.readRegisters(LORA_WARM_FIRST_REG, registers, sizeof(registers));
+    if (!(registers[0] & 0x80)) // REG_OP_MODE, LoRa mode
+        return false;
+    for (uint8_t address : LORA_WARM_CHECKED)
+    {
+        if (registers[address - LORA_WARM_FIRST_REG] != state.registers[address - LORA_WARM_FIRST_REG])
+            return false;
+    }
+
+    LoRa.idle(); // standby, as after a cold start
+    return true;
+}
+
+void Custom_LoRa::saveWarmState(const RadioConfig &config)
+{
+    WarmState &state = _warmState;
+    state.magic = LORA_WARM_MAGIC;
+    state.configHash = configHash(config);
+    LoRa.readRegisters(LORA_WARM_FIRST_REG, state.registers, sizeof(state.registers));
+    state.checksum = fnv1a(2166136261u, &state, offsetof(WarmState, checksum));
+}
+
+// Enables the frame header. Every frame sent afterwards carries the network id
+// and a destination, and received frames for other networks or nodes are
+// dropped after reading only the header bytes from the FIFO.
+void Custom_LoRa::setAddress(uint8_t network, uint8_t address)
+{
+    _network = network;
+    _address = address;
+    _addressing = true;
+}
+
+// Appends a CRC32 trailer to every frame sent and verifies it on reception.
+// Unlike the radio CRC it survives implicit header mode and covers the frame
+// header as well. The tables of crc (8 KiB with slicing-by-8) are shared,
+// not copied, so it must outlive the radio; construct it with
+// CRC32_CASTAGNOLI to use CRC32C instead.
+void Custom_LoRa::enableCrc32(const Crc32 &crc)
+{
+    _crc32 = &crc;
+}
+
+// Protects the payload (and CRC32 trailer) with RS(k + parity, k) split over
+// depth interleaved codewords, so a burst of up to depth * parity / 2 corrupted
+// bytes is repaired instead of being retransmitted. Costs depth * parity bytes
+// of airtime per frame; both ends must use the same parameters.
+void Custom_LoRa::enableFec(uint8_t parity, uint8_t depth)
+{
+    delete _fec;
+    _fec = new ReedSolomon(parity);
+    _fecDepth = depth ? depth : 1;
+}
+
+// Registers the AES-128 key of a node. The key is expanded once here and
+// reused for every frame. Frames from that node must then be encrypted and
+// carry an increasing frame counter; the key registered for our own address
+// encrypts everything we send. Call after setAddress().
+bool Custom_LoRa::setKey(uint8_t peer, const uint8_t key[AES_KEY_SIZE])
+{
+    LoRaPeer *slot = findPeer(peer);
+    for (int i = 0; !slot && i < LORA_MAX_PEERS; i++)
+    {
+        if (!_peers[i].used)
+            slot = &_peers[i];
+    }
+    if (!slot)
+        return false;
+
+    slot->used = true;
+    slot->seen = false;
+    slot->address = peer;
+    slot->cipher.setKey(key);
+
+    if (peer == _address)
+        reserveCounters();
+
+    return true;
+}
+
+LoRaPeer *Custom_LoRa::findPeer(uint8_t address)
+{
+    for (int i = 0; i < LORA_MAX_PEERS; i++)
+    {
+        if (_peers[i].used && _peers[i].address == address)
+            return &_peers[i];
+    }
+    return nullptr;
+}
+
+// A CCM nonce must never repeat under the same key, so the transmit counter
+// survives reboots. Counters are handed out in windows and only the end of
+// the current window is written to flash.
+void Custom_LoRa::reserveCounters()
+{
+#if defined(ESP32)
+    Preferences preferences;
+    preferences.begin("lora", false);
+    if (_txCounterLimit == 0)
+        _txCounter = preferences.getUInt("counter", 0);
+    _txCounterLimit = _txCounter + LORA_COUNTER_WINDOW;
+    preferences.putUInt("counter", _txCounterLimit);
+    preferences.end();
+#else
+    _txCounterLimit = _txCounter + LORA_COUNTER_WINDOW;
+#endif
+}
+
+void Custom_LoRa::makeNonce(uint8_t nonce[CCM_NONCE_SIZE], const FrameHeader &header, uint32_t counter)
+{
+    memset(nonce, 0, CCM_NONCE_SIZE);
+    nonce[0] = header.network;
+    nonce[1] = header.source;
+    for (int i = 0; i < FRAME_COUNTER_SIZE; i++)
+        nonce[2 + i] = counter >> (8 * i);
+}
+
+// Gateway side of the beacon-synchronised TDMA mode. Slots are sized for a
+// frame of maxFrame bytes on air, longer frames never fit one, and handed
+// out to nodes as they ask or are heard. Join slots are sized for a frame
+// with no body, so set up addressing, CRC32, FEC and keys first.
+void Custom_LoRa::enableTdmaGateway(uint8_t maxFrame, uint8_t contentionSlots)
+{
+    delete _tdma;
+    _tdma = new TdmaScheduler();
+    _tdma->configure(timeOnAirUs(_radio, maxFrame), timeOnAirUs(_radio, frameOverhead()), contentionSlots);
+    _tdmaGateway = true;
+}
+
+// Node side: frames passed to sendPayload() are held until the node's slot
+// in the last beacon. While it has none, it sends a join request each
+// superframe it has frames waiting.
+void Custom_LoRa::enableTdmaNode()
+{
+    delete _tdma;
+    _tdma = new TdmaScheduler();
+    _tdma->listen(micros());
+    _tdmaGateway = false;
+}
+
+// Multi-hop mode. Frames we send carry a MeshHeader and every node drops
+// copies it has already seen. With relay set this node also forwards frames
+// for others: flooded while no route to the destination is known, otherwise
+// only by the next hop learned from the reverse path of earlier frames.
+void Custom_LoRa::enableMesh(bool relay, uint8_t ttl, bool routing)
+{
+    _relay = relay;
+    _meshTtl = ttl;
+    if (!_seen)
+        _seen = new MeshTable<SeenEntry, LORA_MESH_TABLE_SIZE>(LORA_MESH_MAX_AGE_MS);
+    if (routing && !_routes)
+        _routes = new MeshTable<RouteEntry, LORA_MESH_TABLE_SIZE>(LORA_MESH_MAX_AGE_MS);
+}
+
 uint8_t Custom_LoRa::sendPackage(uint8_t *data, uint8_t size)
 {
     LoRa.beginPacket();
@@ -67,26 +448,569 @@ uint8_t Custom_LoRa::sendPackage(uint8_t *data, uint8_t size)
 
 void Custom_LoRa::sendPayload(const char *payload)
 {
-    LoRa.beginPacket();
-    LoRa.print(payload);
-    LoRa.endPacket();
+    sendPayload(payload, FRAME_BROADCAST);
+}
+
+void Custom_LoRa::sendPayload(const char *payload, uint8_t destination)
+{
+    _pipeline.send(payload, strlen(payload), destination);
+}
+
+void Custom_LoRa::transmit(const char *payload, size_t size, uint8_t destination)
+{
+    if (!_addressing && !_crc32 && !_fec)
+    {
+        LoRa.beginPacket();
+        LoRa.write((const uint8_t *)payload, size);
+        LoRa.endPacket();
+        return;
+    }
+
+    size_t length = buildFrame(FRAME_TYPE_DATA, destination, (const uint8_t *)payload, size);
+
+    if (_tdma)
+    {
+        // held until our slot
+        enqueue(_txBuffer, length, random(_tdma->backoffRangeUs(timeOnAirUs(_radio, length))));
+        return;
+    }
+
+    sendPackage(_txBuffer, length);
+}
+
+bool Custom_LoRa::enqueue(const uint8_t *frame, size_t length, uint32_t backoffUs)
+{
+    QueuedFrame *queued = _txQueue.push();
+    if (!queued)
+    {
+        _stats.txQueueDrops++;
+        return false;
+    }
+
+    memcpy(queued->data, frame, length);
+    queued->length = length;
+    queued->relay = false;
+    queued->notBeforeUs = micros();
+    queued->receivedUs = 0;
+    queued->backoffUs = backoffUs;
+    return true;
+}
+
+// Bytes added around a body by buildFrame()
+size_t Custom_LoRa::frameOverhead()
+{
+    size_t overhead = _addressing ? FRAME_HEADER_SIZE : 0;
+    if (_addressing && _seen)
+        overhead += MESH_HEADER_SIZE;
+    if (_addressing && findPeer(_address))
+        overhead += FRAME_COUNTER_SIZE + FRAME_MIC_SIZE;
+    if (_crc32)
+        overhead += FRAME_CRC32_SIZE;
+    if (_fec)
+        overhead += _fecDepth * _fec->parity();
+    return overhead;
+}
+
+// Assembles header, mesh header, frame counter, (encrypted) body, MIC, CRC32
+// and FEC parity in _txBuffer. The body is truncated to what fits in one
+// frame. The mesh header is left out of CRC, CCM and FEC so relays can
+// rewrite it without touching the rest of the frame.
+size_t Custom_LoRa::buildFrame(uint8_t type, uint8_t destination, const uint8_t *body, size_t size)
+{
+    LoRaPeer *self = _addressing ? findPeer(_address) : nullptr;
+    FrameHeader header = {_network, destination, _address, _sequence++, type};
+
+    size_t length = 0;
+    size_t meshLength = 0;
+    if (_addressing)
+    {
+        if (_crc32)
+            header.flags |= FRAME_FLAG_CRC32;
+        if (_fec)
+            header.flags |= FRAME_FLAG_FEC;
+        if (self)
+            header.flags |= FRAME_FLAG_SECURE;
+        if (_seen)
+            header.flags |= FRAME_FLAG_MESH;
+        memcpy(_txBuffer, &header, FRAME_HEADER_SIZE);
+        length = FRAME_HEADER_SIZE;
+
+        if (_seen)
+        {
+            MeshHeader mesh = {_address, nextHopFor(destination), _meshTtl, 0};
+            memcpy(_txBuffer + length, &mesh, MESH_HEADER_SIZE);
+            meshLength = MESH_HEADER_SIZE;
+            length += meshLength;
+        }
+    }
+    size_t start = length;
+
+    uint32_t counter = _txCounter;
+    if (self)
+    {
+        if (++_txCounter >= _txCounterLimit)
+            reserveCounters();
+        for (int i = 0; i < FRAME_COUNTER_SIZE; i++)
+            _txBuffer[length++] = counter >> (8 * i);
+    }
+
+    size_t room = LORA_MAX_FRAME - frameOverhead();
+    if (size > room)
+        size = room;
+    memcpy(_txBuffer + length, body, size);
+
+    if (self)
+    {
+        // encrypted in place in the staging buffer, header and counter are
+        // authenticated as additional data
+        uint8_t aad[FRAME_HEADER_SIZE + FRAME_COUNTER_SIZE];
+        memcpy(aad, _txBuffer, FRAME_HEADER_SIZE);
+        memcpy(aad + FRAME_HEADER_SIZE, _txBuffer + start, FRAME_COUNTER_SIZE);
+
+        uint8_t nonce[CCM_NONCE_SIZE];
+        makeNonce(nonce, header, counter);
+        AesCcm::seal(self->cipher, nonce, aad, sizeof(aad), _txBuffer + length, size,
+                     _txBuffer + length + size, FRAME_MIC_SIZE);
+        length += FRAME_MIC_SIZE;
+    }
+    length += size;
+
+    if (_crc32)
+    {
+        uint32_t crc = _crc32->compute(_txBuffer, start - meshLength);
+        crc = _crc32->compute(_txBuffer + start, length - start, crc);
+        for (int i = 0; i < FRAME_CRC32_SIZE; i++)
+            _txBuffer[length++] = crc >> (8 * i);
+    }
+
+    if (_fec)
+        length = start + _fec->encodeInterleaved(_txBuffer + start, length - start, _fecDepth);
+
+    return length;
 }
 
 void Custom_LoRa::onReceive(std::function<void(const char *, int)> callback)
 {
-    this->callback = callback;
+    _pipeline.onReceive(callback);
+}
+
+bool Custom_LoRa::acceptHeader(const FrameHeader &header, bool mesh)
+{
+    if (header.network != _network)
+    {
+        _stats.rejectedNetwork++;
+        return false;
+    }
+
+    // a relay has to look at mesh frames for other nodes too
+    if (mesh && _relay)
+        return true;
+
+    if (header.destination != _address && header.destination != FRAME_BROADCAST)
+    {
+        _stats.rejectedAddress++;
+        return false;
+    }
+
+    return true;
+}
+
+// Verifies and strips the CRC32 trailer of the frame in _rxBuffer
+bool Custom_LoRa::checkCrc32(size_t &length)
+{
+    if (length < FRAME_CRC32_SIZE)
+        return false;
+
+    length -= FRAME_CRC32_SIZE;
+
+    uint32_t expected = 0;
+    for (int i = 0; i < FRAME_CRC32_SIZE; i++)
+        expected |= (uint32_t)_rxBuffer[length + i] << (8 * i);
+
+    uint32_t crc = 0;
+    if (_addressing)
+        crc = _crc32->compute((const uint8_t *)&_rxHeader, FRAME_HEADER_SIZE);
+    crc = _crc32->compute(_rxBuffer, length, crc);
+
+    return crc == expected;
+}
+
+// Authenticates and decrypts the frame in _rxBuffer in place, then points
+// payload past the frame counter
+bool Custom_LoRa::openSecure(uint8_t *&payload, size_t &length)
+{
+    if (length < FRAME_COUNTER_SIZE + FRAME_MIC_SIZE)
+    {
+        _stats.authFailures++;
+        return false;
+    }
+
+    LoRaPeer *peer = findPeer(_rxHeader.source);
+    if (!peer)
+    {
+        _stats.unknownPeers++;
+        return false;
+    }
+
+    uint32_t counter = 0;
+    for (int i = 0; i < FRAME_COUNTER_SIZE; i++)
+        counter |= (uint32_t)_rxBuffer[i] << (8 * i);
+
+    if (peer->seen && counter <= peer->lastCounter)
+    {
+        _stats.replays++;
+        return false;
+    }
+
+    uint8_t aad[FRAME_HEADER_SIZE + FRAME_COUNTER_SIZE];
+    memcpy(aad, &_rxHeader, FRAME_HEADER_SIZE);
+    memcpy(aad + FRAME_HEADER_SIZE, _rxBuffer, FRAME_COUNTER_SIZE);
+
+    uint8_t nonce[CCM_NONCE_SIZE];
+    makeNonce(nonce, _rxHeader, counter);
+
+    size_t size = length - FRAME_COUNTER_SIZE - FRAME_MIC_SIZE;
+    if (!AesCcm::open(peer->cipher, nonce, aad, sizeof(aad), _rxBuffer + FRAME_COUNTER_SIZE, size,
+                      _rxBuffer + FRAME_COUNTER_SIZE + size, FRAME_MIC_SIZE))
+    {
+        _stats.authFailures++;
+        return false;
+    }
+
+    peer->seen = true;
+    peer->lastCounter = counter;
+
+    payload = _rxBuffer + FRAME_COUNTER_SIZE;
+    length = size;
+    return true;
+}
+
+void Custom_LoRa::serviceTdma(uint32_t now)
+{
+    if (_tdmaGateway && _addressing && _tdma->beaconDue(now))
+    {
+        // collided join requests reach us, if at all, as frames that fail
+        // their checks
+        uint32_t errors = _stats.rejectedShort + _stats.crcErrors + _stats.radioCrcErrors + _stats.fecFailures;
+        _tdma->releaseIdle();
+        _tdma->sizeJoinWindow(errors - _tdmaErrors);
+        _tdmaErrors = errors;
+
+        // the beacon announces a period that depends on its own airtime
+        _tdma->setBeaconAirtime(timeOnAirUs(_radio, frameOverhead() + TDMA_BEACON_SIZE));
+
+        uint8_t body[TDMA_BEACON_SIZE];
+        size_t length = buildFrame(FRAME_TYPE_BEACON, FRAME_BROADCAST, body, _tdma->writeBeacon(body));
+
+        uint32_t before = _dio0Micros;
+        sendPackage(_txBuffer, length);
+        _tdma->beaconSent(_dio0Micros != before ? _dio0Micros : micros());
+        _stats.beacons++;
+        return;
+    }
+
+    if (!_tdmaGateway && _addressing && !_txQueue.empty() &&
+        _tdma->joinDue(now, timeOnAirUs(_radio, frameOverhead()), random(0x10000)))
+    {
+        // no body: the gateway only needs our address
+        size_t length = buildFrame(FRAME_TYPE_JOIN, FRAME_BROADCAST, _txBuffer, 0);
+        sendPackage(_txBuffer, length);
+    }
+}
+
+void Custom_LoRa::serviceQueue(uint32_t now)
+{
+    QueuedFrame *frame = _txQueue.front();
+    if (!frame || (int32_t)(now - frame->notBeforeUs) < 0)
+        return;
+
+    if (_tdma && !_tdma->canTransmit(now, timeOnAirUs(_radio, frame->length), frame->backoffUs))
+        return;
+
+    sendPackage(frame->data, frame->length);
+
+    if (frame->relay)
+    {
+        uint32_t latency = now - frame->receivedUs;
+        _stats.relayed++;
+        _stats.relayLatencyTotalUs += latency;
+        if (latency > _stats.relayLatencyMaxUs)
+            _stats.relayLatencyMaxUs = latency;
+    }
+
+    _txQueue.pop();
+}
+
+uint8_t Custom_LoRa::nextHopFor(uint8_t destination)
+{
+    if (!_routes || destination == FRAME_BROADCAST)
+        return FRAME_BROADCAST;
+
+    RouteEntry *route = _routes->find(destination, millis());
+    return route ? route->nextHop : FRAME_BROADCAST;
+}
+
+// Drops our own frames coming back from a relay and the frames already
+// seen. Nothing is recorded yet: the frame hasn't been verified.
+bool Custom_LoRa::meshDuplicate()
+{
+    if (_rxHeader.source == _address)
+        return true;
+    SeenEntry *seen = _seen->find(_rxHeader.source, millis());
+    return seen && seen->seen(_rxHeader.sequence);
+}
+
+// Duplicate recording, route learning and forwarding of a verified mesh
+// frame; relayed is the copy stageRelay() queued, if any. Returns true when
+// the frame is also for this node.
+bool Custom_LoRa::meshReceive(QueuedFrame *relayed)
+{
+    uint32_t now = millis();
+
+    // a duplicate doesn't keep the entry alive, only new frames do
+    bool fresh = false;
+    SeenEntry *seen = _seen->find(_rxHeader.source, now);
+    if (!seen)
+        seen = _seen->insert(_rxHeader.source, now, fresh);
+    if (seen->check(_rxHeader.sequence, fresh))
+    {
+        _stats.duplicates++;
+        if (relayed)
+            _txQueue.unpush();
+        return false;
+    }
+    _seen->touch(seen, now);
+
+    if (_routes)
+    {
+        // the transmitter is a neighbour, the source is one hop further
+        // than the frame has travelled
+        RouteEntry *route = _routes->insert(_rxMesh.previousHop, now, fresh);
+        route->nextHop = _rxMesh.previousHop;
+        route->hops = 1;
+
+        route = _routes->insert(_rxHeader.source, now, fresh);
+        if (fresh || _rxMesh.hops + 1 <= route->hops || route->nextHop == _rxMesh.previousHop)
+        {
+            route->nextHop = _rxMesh.previousHop;
+            route->hops = _rxMesh.hops + 1;
+        }
+    }
+
+    if (relayed)
+    {
+        MeshHeader mesh = _rxMesh;
+        mesh.previousHop = _address;
+        mesh.nextHop = nextHopFor(_rxHeader.destination);
+        mesh.ttl--;
+        mesh.hops++;
+        memcpy(relayed->data + FRAME_HEADER_SIZE, &mesh, MESH_HEADER_SIZE);
+    }
+
+    bool forUs = _rxHeader.destination == _address || _rxHeader.destination == FRAME_BROADCAST;
+    if (forUs)
+        _stats.hops[_rxMesh.hops < MESH_MAX_HOPS ? _rxMesh.hops : MESH_MAX_HOPS - 1]++;
+
+    return forUs;
+}
+
+// Copies the frame as received, (possibly encrypted) body, trailer and parity
+// included, to the TX queue before it's decrypted in place. meshReceive()
+// fills in the mesh header once the frame is verified; until then the copy
+// is the last push() and is given back with unpush() if the frame is dropped.
+QueuedFrame *Custom_LoRa::stageRelay(size_t length, uint32_t rxDone)
+{
+    bool viaUs = _rxMesh.nextHop == _address || _rxMesh.nextHop == FRAME_BROADCAST;
+    uint8_t type = _rxHeader.flags & FRAME_TYPE_MASK;
+    bool tdma = type == FRAME_TYPE_BEACON || type == FRAME_TYPE_JOIN; // timing is only valid first-hand
+    if (!_relay || _rxHeader.destination == _address || !viaUs || tdma)
+        return nullptr;
+
+    if (_rxMesh.ttl == 0)
+    {
+        _stats.ttlExpired++;
+        return nullptr;
+    }
+
+    QueuedFrame *frame = _txQueue.push();
+    if (!frame)
+    {
+        _stats.txQueueDrops++;
+        return nullptr;
+    }
+
+    memcpy(frame->data, &_rxHeader, FRAME_HEADER_SIZE);
+    memcpy(frame->data + FRAME_HEADER_SIZE + MESH_HEADER_SIZE, _rxBuffer, length);
+    frame->length = FRAME_HEADER_SIZE + MESH_HEADER_SIZE + length;
+    frame->relay = true;
+    frame->receivedUs = rxDone;
+    frame->notBeforeUs = micros() + random(LORA_RELAY_JITTER_US);
+    frame->backoffUs = _tdma ? random(_tdma->backoffRangeUs(timeOnAirUs(_radio, frame->length)) / 2) : 0;
+    return frame;
 }
 
 void Custom_LoRa::loop()
 {
+    _pipeline.loop();
+}
+
+bool Custom_LoRa::startTask(int core, uint8_t priority)
+{
+    return _pipeline.start(core, priority, 6144);
+}
+
+void Custom_LoRa::stopTask()
+{
+    _pipeline.stop();
+}
+
+void Custom_LoRa::poll()
+{
+    uint32_t now = micros();
+    if (!_startup.firstRxUs)
+    {
+        // the first parsePacket() below arms RX
+        _startup.firstRxUs = now ? now : 1;
+        LOG("LoRa: first RX at %u us after boot (%s start)", _startup.firstRxUs, _startup.warm ? "warm" : "cold");
+    }
+    if (_tdma)
+        serviceTdma(now);
+    serviceQueue(now);
+
     int packetSize = LoRa.parsePacket(); // try to parse packet
+    _stats.radioCrcErrors = LoRa.crcErrorCount();
     if (packetSize)
     {
-        while (LoRa.available()) // read packet
+        uint32_t rxDone = _dio0Micros;
+        _stats.received++;
+
+        size_t length = 0;
+        bool mesh = false;
+        if (_addressing)
+        {
+            if (packetSize < FRAME_HEADER_SIZE)
+            {
+                _stats.rejectedShort++;
+                return;
+            }
+
+            // only the headers are read, the rest of a rejected frame stays
+            // in the FIFO and is discarded by the next parsePacket()
+            uint8_t head[FRAME_HEADER_SIZE + MESH_HEADER_SIZE];
+            size_t headLength = LoRa.readPacket(head, sizeof(head));
+            memcpy(&_rxHeader, head, FRAME_HEADER_SIZE);
+            size_t used = FRAME_HEADER_SIZE;
+
+            mesh = _rxHeader.flags & FRAME_FLAG_MESH;
+            if (mesh)
+            {
+                if (headLength < sizeof(head))
+                {
+                    _stats.rejectedShort++;
+                    return;
+                }
+                memcpy(&_rxMesh, head + FRAME_HEADER_SIZE, MESH_HEADER_SIZE);
+                used += MESH_HEADER_SIZE;
+            }
+
+            if (!acceptHeader(_rxHeader, mesh))
+            {
+                return;
+            }
+
+            length = headLength - used;
+            memcpy(_rxBuffer, head + used, length);
+        }
+
+        length += LoRa.readPacket(_rxBuffer + length, LORA_MAX_FRAME - length);
+
+        if (mesh && _seen && meshDuplicate())
+        {
+            _stats.duplicates++;
+            return;
+        }
+
+        // a relayed frame keeps its trailer and parity
+        size_t frameLength = length;
+
+        bool hasFec = _addressing ? (_rxHeader.flags & FRAME_FLAG_FEC) : _fec != nullptr;
+        if (hasFec)
+        {
+            // corrects _rxBuffer in place, then drops the parity bytes
+            int corrected = _fec ? _fec->decodeInterleaved(_rxBuffer, length, _fecDepth) : -1;
+            if (corrected < 0)
+            {
+                _stats.fecFailures++;
+                return;
+            }
+            _stats.fecCorrected += corrected;
+            length -= _fecDepth * _fec->parity();
+        }
+
+        bool hasCrc32 = _addressing ? (_rxHeader.flags & FRAME_FLAG_CRC32) : _crc32 != nullptr;
+        if (hasCrc32 && (!_crc32 || !checkCrc32(length)))
         {
-            LoRaData += (char)LoRa.read();
+            _stats.crcErrors++;
+            return;
         }
-        emit(LoRaData.c_str(), LoRa.packetRssi());
-        LoRaData = "";
+
+        // the mesh tables and the relay only trust verified frames
+        QueuedFrame *relayed = mesh && _seen ? stageRelay(frameLength, rxDone) : nullptr;
+
+        uint8_t *payload = _rxBuffer;
+        bool secure = _addressing && (_rxHeader.flags & FRAME_FLAG_SECURE);
+        bool keyed = _addressing && findPeer(_rxHeader.source);
+        if (secure && !keyed)
+        {
+            // nothing to authenticate it with: relay it on the strength of
+            // the CRC, but deliver nothing
+            bool forUs = mesh && _seen ? meshReceive(relayed) : true;
+            if (forUs)
+                _stats.unknownPeers++;
+            return;
+        }
+        if (secure ? !openSecure(payload, length) : keyed)
+        {
+            // plaintext from a node that has a key is a downgrade attempt
+            if (!secure)
+                _stats.authFailures++;
+            if (relayed)
+                _txQueue.unpush();
+            return;
+        }
+
+        if (mesh && _seen && !meshReceive(relayed))
+            return;
+
+        if (_addressing && (_rxHeader.flags & FRAME_TYPE_MASK) == FRAME_TYPE_BEACON)
+        {
+            if (_tdma && !_tdmaGateway && !(mesh && _rxMesh.hops) && _tdma->onBeacon(payload, length, _address, rxDone))
+                _stats.beacons++;
+            return;
+        }
+
+        if (_addressing && (_rxHeader.flags & FRAME_TYPE_MASK) == FRAME_TYPE_JOIN)
+        {
+            if (_tdma && _tdmaGateway && !(mesh && _rxMesh.hops))
+                _tdma->assignSlot(_rxHeader.source);
+            return;
+        }
+
+        if (_tdma && _tdmaGateway && _addressing)
+            _tdma->assignSlot(mesh ? _rxMesh.previousHop : _rxHeader.source);
+
+        payload[length] = '\0';
+
+        _rxInfo.addressed = _addressing;
+        _rxInfo.source = _rxHeader.source;
+        _rxInfo.sequence = _rxHeader.sequence;
+        _rxInfo.hops = mesh ? _rxMesh.hops : 0;
+        _rxInfo.length = length;
+        _rxInfo.rssi = LoRa.packetRssi();
+        _rxInfo.snr = LoRa.packetSnr();
+        _rxInfo.rxDoneUs = rxDone;
+
+        _stats.accepted++;
+        _pipeline.emit((const char *)payload, _rxInfo);
     }
 }
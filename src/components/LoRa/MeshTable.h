@@ -0,0 +1,153 @@
+#ifndef MESH_TABLE_H
+#define MESH_TABLE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// Fixed-size open-addressed (linear probing) table keyed by node address.
+// Entries untouched for longer than the table's max age are treated as free,
+// and when every slot is live the least recently touched one is evicted, so
+// memory stays bounded however many nodes are heard. Size must be a power
+// of two.
+template <typename Entry, uint8_t Size>
+class MeshTable
+{
+    static_assert(Size && (Size & (Size - 1)) == 0, "MeshTable size must be a power of two");
+
+  private:
+    Entry _entries[Size];
+    uint8_t _keys[Size];
+    bool _used[Size];
+    uint32_t _touched[Size];
+    uint32_t _maxAgeMs;
+
+    static uint8_t home(uint8_t key)
+    {
+        return (uint8_t)(key * 157u) & (Size - 1);
+    }
+
+    bool live(uint8_t slot, uint32_t now) const
+    {
+        return _used[slot] && now - _touched[slot] < _maxAgeMs;
+    }
+
+  public:
+    explicit MeshTable(uint32_t maxAgeMs) : _maxAgeMs(maxAgeMs)
+    {
+        memset(_used, 0, sizeof(_used));
+    }
+
+    Entry *find(uint8_t key, uint32_t now)
+    {
+        uint8_t slot = home(key);
+        for (uint8_t i = 0; i < Size && _used[slot]; i++, slot = (slot + 1) & (Size - 1))
+        {
+            if (_keys[slot] == key)
+                return live(slot, now) ? &_entries[slot] : nullptr;
+        }
+        return nullptr;
+    }
+
+    // Marks an entry returned by find() or insert() as used now
+    void touch(const Entry *entry, uint32_t now)
+    {
+        _touched[entry - _entries] = now;
+    }
+
+    // Returns the entry for key, creating a value-initialised one if needed.
+    // fresh is set when the entry did not exist or had expired.
+    Entry *insert(uint8_t key, uint32_t now, bool &fresh)
+    {
+        uint8_t slot = home(key);
+        int reuse = -1;
+        int oldest = slot;
+
+        for (uint8_t i = 0; i < Size; i++, slot = (slot + 1) & (Size - 1))
+        {
+            if (!_used[slot])
+            {
+                if (reuse < 0)
+                    reuse = slot;
+                break;
+            }
+            if (_keys[slot] == key)
+            {
+                fresh = !live(slot, now);
+                if (fresh)
+                    _entries[slot] = Entry();
+                _touched[slot] = now;
+                return &_entries[slot];
+            }
+            if (reuse < 0 && !live(slot, now))
+                reuse = slot;
+            if (now - _touched[slot] > now - _touched[oldest])
+                oldest = slot;
+        }
+
+        // Replacing the key of an occupied slot keeps probe chains intact:
+        // the chain of the new key reaches it without crossing an empty slot.
+        slot = reuse >= 0 ? reuse : oldest;
+        _used[slot] = true;
+        _keys[slot] = key;
+        _touched[slot] = now;
+        _entries[slot] = Entry();
+        fresh = true;
+        return &_entries[slot];
+    }
+};
+
+// Duplicate detection state of one source: the highest sequence number seen
+// and a bitmap of the 32 sequence numbers below it.
+struct SeenEntry
+{
+    uint8_t highest;
+    uint32_t window;
+
+    // Returns true if seq has been seen, without recording it
+    bool seen(uint8_t seq) const
+    {
+        int8_t ahead = (int8_t)(seq - highest);
+        if (ahead > 0)
+            return false;
+        uint8_t behind = -ahead;
+        return behind < 32 && (window & (1UL << behind));
+    }
+
+    // Records seq and returns true if it had already been seen
+    bool check(uint8_t seq, bool fresh)
+    {
+        int8_t ahead = (int8_t)(seq - highest);
+        uint8_t behind = -ahead;
+
+        // a sequence number far behind the window is a node that rebooted and
+        // started counting again, not a frame that old still in flight
+        if (fresh || (ahead <= 0 && behind >= 32))
+        {
+            highest = seq;
+            window = 1;
+            return false;
+        }
+
+        if (ahead > 0)
+        {
+            window = ahead >= 32 ? 1 : (window << ahead) | 1;
+            highest = seq;
+            return false;
+        }
+
+        bool seen = window & (1UL << behind);
+        window |= 1UL << behind;
+        return seen;
+    }
+};
+
+// Learned reverse path towards a source: the neighbour it was last heard
+// through and how many hops away it is.
+struct RouteEntry
+{
+    uint8_t nextHop;
+    uint8_t hops;
+};
+
+#endif
@@ -0,0 +1,34 @@
+#ifndef RADIO_CONFIG_H
+#define RADIO_CONFIG_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Modem settings applied by Custom_LoRa::begin(). The defaults match the
+// SX127x power-on values that LoRaClass::begin() leaves in place.
+struct RadioConfig
+{
+    uint32_t frequency = 433E6;
+    uint8_t spreadingFactor = 7;
+    uint32_t bandwidth = 125E3;
+    uint8_t codingRate = 5; // denominator of 4/x
+    uint16_t preambleLength = 8;
+    uint8_t syncWord = 0xA5;
+    bool crc = false;
+};
+
+// Time on air of a frame in microseconds (Semtech AN1200.13, explicit header)
+uint32_t timeOnAirUs(const RadioConfig &config, size_t payloadLength)
+{
+    float symbolUs = (float)(1UL << config.spreadingFactor) * 1e6f / config.bandwidth;
+    int lowDataRate = symbolUs > 16000 ? 1 : 0;
+
+    int numerator = 8 * (int)payloadLength - 4 * config.spreadingFactor + 28 + (config.crc ? 16 : 0);
+    int denominator = 4 * (config.spreadingFactor - 2 * lowDataRate);
+    int blocks = numerator > 0 ? (numerator + denominator - 1) / denominator : 0;
+    int payloadSymbols = 8 + blocks * config.codingRate;
+
+    return (uint32_t)((config.preambleLength + 4.25f + payloadSymbols) * symbolUs);
+}
+
+#endif
@@ -0,0 +1,297 @@
+#ifndef RADIO_PIPELINE_H
+#define RADIO_PIPELINE_H
+
+#include <atomic>
+#include <functional>
+#include <stdint.h>
+#include <string.h>
+#include "FrameHeader.h"
+#include "../Utils/SpscQueue.h"
+#include "../Utils/Thread.h"
+
+#if !defined(ESP32)
+#include <chrono>
+#endif
+
+#define LORA_MAX_FRAME 255
+
+#define LORA_RX_QUEUE_SIZE 8 // frames waiting for the application task
+#define LORA_TX_REQUEST_QUEUE_SIZE 4
+#define LORA_TASK_IDLE_MS 1
+#define LORA_LOAD_WINDOW_US 1000000
+
+// Time a task spends working, measured by the task itself, as a share of
+// the last LORA_LOAD_WINDOW_US
+struct TaskStats
+{
+    uint32_t loops;
+    uint16_t loadPermille;
+    uint32_t busyUs;
+    uint32_t windowStartUs;
+
+    void record(uint32_t startUs, uint32_t endUs)
+    {
+        loops++;
+        busyUs += endUs - startUs;
+        uint32_t window = endUs - windowStartUs;
+        if (window >= LORA_LOAD_WINDOW_US)
+        {
+            loadPermille = (uint64_t)busyUs * 1000 / window;
+            busyUs = 0;
+            windowStartUs = endUs;
+        }
+    }
+};
+
+// Items passed between tasks and how long they waited in the queue
+struct QueueStats
+{
+    uint32_t passed;
+    uint32_t drops; // queue full
+    uint32_t latencyMaxUs;
+    uint64_t latencyTotalUs;
+
+    void record(uint32_t latencyUs)
+    {
+        passed++;
+        latencyTotalUs += latencyUs;
+        if (latencyUs > latencyMaxUs)
+            latencyMaxUs = latencyUs;
+    }
+};
+
+struct RuntimeStats
+{
+    TaskStats radio;       // radio task: SPI polling, frame pipeline, TX
+    TaskStats application; // time loop() spends delivering frames, callbacks included
+    QueueStats rx;         // radio task to loop()
+    QueueStats tx;         // sendPayload() to radio task
+};
+
+struct RxEvent
+{
+    PacketInfo info;
+    uint32_t queuedUs;
+    char payload[LORA_MAX_FRAME + 1];
+};
+
+struct TxRequest
+{
+    uint8_t destination;
+    uint8_t length;
+    uint32_t queuedUs;
+    char payload[LORA_MAX_FRAME + 1];
+};
+
+// Handoff between the radio and the application. Without a task, loop()
+// polls the radio and received frames go straight to the callback. After
+// start() a pinned task (a std::thread on the host) polls the radio and
+// transmits, received frames reach the callback from loop() through one
+// lock-free queue and send requests reach the task through another.
+//
+// Radio provides poll(), which hands each received frame to emit(), and
+// transmit(payload, size, destination). Nothing here touches the hardware,
+// so tools/pipeline runs this code on the host with a fake radio.
+template <typename Radio>
+class RadioPipeline
+{
+  private:
+    Radio &_radio;
+    Thread _thread;
+    std::atomic<bool> _stop;
+    SpscQueue<RxEvent, LORA_RX_QUEUE_SIZE> *_rxEvents = nullptr;
+    SpscQueue<TxRequest, LORA_TX_REQUEST_QUEUE_SIZE> *_txRequests = nullptr;
+    RuntimeStats _runtime = {};
+    PacketInfo _delivered = {};
+    std::function<void(const char *, int)> _callback;
+
+    bool serviceRequests();
+    void deliver();
+    void releaseQueues();
+    static void task(void *param);
+
+  public:
+    explicit RadioPipeline(Radio &radio) : _radio(radio), _stop(false) {}
+    ~RadioPipeline()
+    {
+        stop();
+        releaseQueues();
+    }
+
+    void onReceive(std::function<void(const char *, int)> callback) { _callback = callback; }
+
+    // Radio side: one received frame, payload NUL-terminated after
+    // info.length bytes
+    void emit(const char *payload, const PacketInfo &info);
+
+    // Application side: sends now without a task, queues for it otherwise
+    void send(const char *payload, size_t size, uint8_t destination);
+    void loop();
+
+    bool start(int core, uint8_t priority, uint32_t stackSize);
+    void stop();
+    bool running() const { return _thread.running(); }
+
+    const RuntimeStats &stats() const { return _runtime; }
+    const PacketInfo &delivered() const { return _delivered; }
+
+    static uint32_t nowUs()
+    {
+#if defined(ESP32)
+        return micros();
+#else
+        return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+#endif
+    }
+};
+
+template <typename Radio>
+void RadioPipeline<Radio>::emit(const char *payload, const PacketInfo &info)
+{
+    if (!_rxEvents)
+    {
+        _delivered = info;
+        _callback(payload, info.rssi);
+        return;
+    }
+
+    RxEvent *event = _rxEvents->reserve();
+    if (!event)
+    {
+        _runtime.rx.drops++;
+        return;
+    }
+    event->info = info;
+    event->queuedUs = nowUs();
+    memcpy(event->payload, payload, info.length + 1);
+    _rxEvents->publish();
+}
+
+template <typename Radio>
+void RadioPipeline<Radio>::send(const char *payload, size_t size, uint8_t destination)
+{
+    if (size > LORA_MAX_FRAME)
+        size = LORA_MAX_FRAME;
+
+    if (!_txRequests)
+    {
+        _radio.transmit(payload, size, destination);
+        return;
+    }
+
+    TxRequest *request = _txRequests->reserve();
+    if (!request)
+    {
+        _runtime.tx.drops++;
+        return;
+    }
+    request->destination = destination;
+    request->length = size;
+    request->queuedUs = nowUs();
+    memcpy(request->payload, payload, size);
+    request->payload[size] = '\0';
+    _txRequests->publish();
+}
+
+template <typename Radio>
+void RadioPipeline<Radio>::loop()
+{
+    if (_rxEvents)
+        deliver();
+    else
+        _radio.poll();
+}
+
+// Application side of the task mode: hands queued frames to the callback
+template <typename Radio>
+void RadioPipeline<Radio>::deliver()
+{
+    uint32_t start = nowUs();
+    RxEvent *event;
+    while ((event = _rxEvents->front()))
+    {
+        _runtime.rx.record(nowUs() - event->queuedUs);
+        _delivered = event->info;
+        _callback(event->payload, event->info.rssi);
+        _rxEvents->pop();
+    }
+    _runtime.application.record(start, nowUs());
+}
+
+template <typename Radio>
+bool RadioPipeline<Radio>::serviceRequests()
+{
+    bool busy = false;
+    TxRequest *request;
+    while ((request = _txRequests->front()))
+    {
+        _runtime.tx.record(nowUs() - request->queuedUs);
+        _radio.transmit(request->payload, request->length, request->destination);
+        _txRequests->pop();
+        busy = true;
+    }
+    return busy;
+}
+
+template <typename Radio>
+void RadioPipeline<Radio>::task(void *param)
+{
+    RadioPipeline *pipeline = (RadioPipeline *)param;
+    while (!pipeline->_stop.load(std::memory_order_relaxed))
+    {
+        uint32_t start = nowUs();
+        bool busy = pipeline->serviceRequests();
+        pipeline->_radio.poll();
+        pipeline->_runtime.radio.record(start, nowUs());
+        if (!busy)
+            Thread::sleepMs(LORA_TASK_IDLE_MS);
+    }
+}
+
+template <typename Radio>
+bool RadioPipeline<Radio>::start(int core, uint8_t priority, uint32_t stackSize)
+{
+    if (_thread.running())
+        return false;
+
+    if (!_rxEvents)
+        _rxEvents = new SpscQueue<RxEvent, LORA_RX_QUEUE_SIZE>();
+    if (!_txRequests)
+        _txRequests = new SpscQueue<TxRequest, LORA_TX_REQUEST_QUEUE_SIZE>();
+
+    _stop.store(false);
+    _runtime.radio.windowStartUs = _runtime.application.windowStartUs = nowUs();
+    if (_thread.start("lora", task, this, core, priority, stackSize))
+        return true;
+
+    // without the task, loop() must go back to polling the radio itself
+    releaseQueues();
+    return false;
+}
+
+template <typename Radio>
+void RadioPipeline<Radio>::stop()
+{
+    if (!_thread.running())
+        return;
+    _stop.store(true);
+    _thread.join();
+
+    // the task is gone: flush what it left behind, then poll from loop()
+    serviceRequests();
+    deliver();
+    releaseQueues();
+}
+
+template <typename Radio>
+void RadioPipeline<Radio>::releaseQueues()
+{
+    delete _rxEvents;
+    delete _txRequests;
+    _rxEvents = nullptr;
+    _txRequests = nullptr;
+}
+
+#endif
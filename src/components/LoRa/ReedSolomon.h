@@ -0,0 +1,277 @@
+#ifndef REED_SOLOMON_H
+#define REED_SOLOMON_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#define RS_MAX_PARITY 32
+#define RS_MAX_CODEWORD 255
+
+// Systematic Reed-Solomon code over GF(256) (primitive polynomial 0x11D,
+// first consecutive root alpha^0). A codeword of n bytes carries n - parity
+// data bytes and corrects up to parity / 2 byte errors. Shortened codewords
+// (n < 255) are supported, so k is simply the length of the data.
+class ReedSolomon
+{
+  private:
+    uint8_t _parity;
+    uint8_t _exp[512]; // doubled so mul() needs no modulo
+    uint8_t _log[256];
+    uint8_t _generator[RS_MAX_PARITY + 1];
+
+    uint8_t mul(uint8_t a, uint8_t b) const
+    {
+        if (a == 0 || b == 0)
+            return 0;
+        return _exp[_log[a] + _log[b]];
+    }
+
+    uint8_t div(uint8_t a, uint8_t b) const
+    {
+        if (a == 0)
+            return 0;
+        return _exp[_log[a] + 255 - _log[b]];
+    }
+
+    bool syndromes(const uint8_t *codeword, size_t n, uint8_t *syndromes) const;
+
+  public:
+    explicit ReedSolomon(uint8_t parity);
+
+    uint8_t parity() const { return _parity; }
+
+    // Computes the parity bytes of data[0], data[stride], data[2 * stride]...
+    // and stores them at parity[0], parity[parityStride]...
+    void encode(const uint8_t *data, size_t size, uint8_t *parity, size_t stride = 1, size_t parityStride = 1) const;
+
+    // Corrects a codeword in place. Returns the number of corrected bytes or
+    // -1 when the errors exceed the correction capacity.
+    int decode(uint8_t *codeword, size_t n) const;
+
+    // Interleaved variants: the data is split into depth codewords taking
+    // every depth-th byte, so a burst of b corrupted bytes costs each codeword
+    // only about b / depth errors. The parity of all codewords follows the
+    // data, interleaved so that any depth consecutive bytes of the whole
+    // frame belong to distinct codewords, for depth * parity bytes in total.
+    size_t encodeInterleaved(uint8_t *buffer, size_t size, uint8_t depth) const;
+    int decodeInterleaved(uint8_t *buffer, size_t size, uint8_t depth) const;
+};
+
+ReedSolomon::ReedSolomon(uint8_t parity) : _parity(parity < 2 ? 2 : parity > RS_MAX_PARITY ? RS_MAX_PARITY : parity)
+{
+    uint16_t x = 1;
+    for (int i = 0; i < 255; i++)
+    {
+        _exp[i] = x;
+        _log[x] = i;
+        x <<= 1;
+        if (x & 0x100)
+            x ^= 0x11D;
+    }
+    for (int i = 255; i < 512; i++)
+        _exp[i] = _exp[i - 255];
+    _log[0] = 0; // never used, mul() and div() test for zero
+
+    // generator = (x - a^0)(x - a^1)...(x - a^(parity-1)), highest degree first
+    memset(_generator, 0, sizeof(_generator));
+    _generator[0] = 1;
+    for (int i = 0; i < _parity; i++)
+    {
+        for (int j = i + 1; j > 0; j--)
+            _generator[j] ^= mul(_generator[j - 1], _exp[i]);
+    }
+}
+
+void ReedSolomon::encode(const uint8_t *data, size_t size, uint8_t *parity, size_t stride, size_t parityStride) const
+{
+    uint8_t remainder[RS_MAX_PARITY] = {};
+
+    for (size_t i = 0; i < size; i++)
+    {
+        uint8_t feedback = data[i * stride] ^ remainder[0];
+        for (int j = 0; j < _parity - 1; j++)
+            remainder[j] = remainder[j + 1] ^ mul(_generator[j + 1], feedback);
+        remainder[_parity - 1] = mul(_generator[_parity], feedback);
+    }
+
+    for (int j = 0; j < _parity; j++)
+        parity[j * parityStride] = remainder[j];
+}
+
+bool ReedSolomon::syndromes(const uint8_t *codeword, size_t n, uint8_t *syndromes) const
+{
+    bool clean = true;
+    for (int j = 0; j < _parity; j++)
+    {
+        uint8_t s = 0;
+        for (size_t i = 0; i < n; i++)
+            s = mul(s, _exp[j]) ^ codeword[i];
+        syndromes[j] = s;
+        clean &= s == 0;
+    }
+    return clean;
+}
+
+int ReedSolomon::decode(uint8_t *codeword, size_t n) const
+{
+    if (n <= _parity || n > RS_MAX_CODEWORD)
+        return -1;
+
+    uint8_t s[RS_MAX_PARITY];
+    if (syndromes(codeword, n, s))
+        return 0;
+
+    // Berlekamp-Massey, polynomials stored lowest degree first
+    uint8_t lambda[RS_MAX_PARITY + 1] = {1};
+    uint8_t prev[RS_MAX_PARITY + 1] = {1};
+    uint8_t temp[RS_MAX_PARITY + 1];
+    int errors = 0;
+    int shift = 1;
+    uint8_t prevDiscrepancy = 1;
+
+    for (int k = 0; k < _parity; k++)
+    {
+        uint8_t d = s[k];
+        for (int i = 1; i <= errors; i++)
+            d ^= mul(lambda[i], s[k - i]);
+
+        if (d == 0)
+        {
+            shift++;
+            continue;
+        }
+
+        uint8_t scale = div(d, prevDiscrepancy);
+        memcpy(temp, lambda, sizeof(temp));
+        for (int i = 0; i + shift <= _parity; i++)
+            lambda[i + shift] ^= mul(scale, prev[i]);
+
+        if (2 * errors <= k)
+        {
+            errors = k + 1 - errors;
+            memcpy(prev, temp, sizeof(prev));
+            prevDiscrepancy = d;
+            shift = 1;
+        }
+        else
+        {
+            shift++;
+        }
+    }
+
+    if (2 * errors > _parity)
+        return -1;
+
+    // error evaluator omega = s * lambda mod x^parity
+    uint8_t omega[RS_MAX_PARITY] = {};
+    for (int i = 0; i < _parity; i++)
+    {
+        for (int j = 0; j <= i && j <= errors; j++)
+            omega[i] ^= mul(s[i - j], lambda[j]);
+    }
+
+    // Chien search over the codeword positions, Forney for the magnitudes.
+    // Byte i holds the coefficient of x^(n - 1 - i).
+    int found = 0;
+    for (size_t power = 0; power < n; power++)
+    {
+        uint8_t xInverse = _exp[(255 - power) % 255];
+
+        // lambda(xInverse) and its formal derivative, which in GF(2^m)
+        // keeps only the odd terms: sum of lambda[i] * xInverse^(i - 1)
+        uint8_t value = 0;
+        uint8_t derivative = 0;
+        uint8_t x = 1;
+        uint8_t previous = 0;
+        for (int i = 0; i <= errors; i++)
+        {
+            value ^= mul(lambda[i], x);
+            if (i & 1)
+                derivative ^= mul(lambda[i], previous);
+            previous = x;
+            x = mul(x, xInverse);
+        }
+        if (value != 0)
+            continue;
+
+        uint8_t numerator = 0;
+        x = 1;
+        for (int i = 0; i < _parity; i++)
+        {
+            numerator ^= mul(omega[i], x);
+            x = mul(x, xInverse);
+        }
+        if (derivative == 0)
+            return -1;
+
+        uint8_t magnitude = mul(_exp[power % 255], div(numerator, derivative));
+        codeword[n - 1 - power] ^= magnitude;
+        found++;
+    }
+
+    if (found != errors || !syndromes(codeword, n, s))
+        return -1;
+
+    return found;
+}
+
+size_t ReedSolomon::encodeInterleaved(uint8_t *buffer, size_t size, uint8_t depth) const
+{
+    for (uint8_t j = 0; j < depth; j++)
+    {
+        size_t count = j < size ? (size - j + depth - 1) / depth : 0;
+        size_t parityStart = size + (j + depth - size % depth) % depth;
+        encode(buffer + j, count, buffer + parityStart, depth, depth);
+    }
+    return size + (size_t)depth * _parity;
+}
+
+int ReedSolomon::decodeInterleaved(uint8_t *buffer, size_t size, uint8_t depth) const
+{
+    size_t parityBytes = (size_t)depth * _parity;
+    if (depth == 0 || size <= parityBytes)
+        return -1;
+
+    size_t dataSize = size - parityBytes;
+    uint8_t codeword[RS_MAX_CODEWORD];
+    int corrected = 0;
+
+    for (uint8_t j = 0; j < depth; j++)
+    {
+        uint8_t *parity = buffer + dataSize + (j + depth - dataSize % depth) % depth;
+        if (j >= dataSize)
+        {
+            // an empty codeword has all-zero parity
+            for (int i = 0; i < _parity; i++)
+                parity[i * depth] = 0;
+            continue;
+        }
+
+        size_t count = (dataSize - j + depth - 1) / depth;
+        size_t n = count + _parity;
+        if (n > RS_MAX_CODEWORD)
+            return -1;
+
+        for (size_t i = 0; i < count; i++)
+            codeword[i] = buffer[j + i * depth];
+        for (int i = 0; i < _parity; i++)
+            codeword[count + i] = parity[i * depth];
+
+        int result = decode(codeword, n);
+        if (result < 0)
+            return -1;
+        if (result == 0)
+            continue;
+
+        for (size_t i = 0; i < count; i++)
+            buffer[j + i * depth] = codeword[i];
+        for (int i = 0; i < _parity; i++)
+            parity[i * depth] = codeword[count + i];
+        corrected += result;
+    }
+
+    return corrected;
+}
+
+#endif
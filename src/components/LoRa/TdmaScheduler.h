@@ -0,0 +1,354 @@
+#ifndef TDMA_SCHEDULER_H
+#define TDMA_SCHEDULER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifndef TDMA_SLOT_IDLE_BEACONS
+#define TDMA_SLOT_IDLE_BEACONS 64 // beacons without a frame before a slot is freed
+#endif
+
+// Defaults of Custom_LoRa::enableTdmaGateway(). The superframe grows by one
+// slot per node, so the slot frame decides how many nodes fit in a node's
+// reporting interval: 48 bytes at SF7/125 kHz is a 103 ms slot, 250 nodes
+// in 26 s.
+#define TDMA_DEFAULT_MAX_FRAME 48
+#define TDMA_DEFAULT_CONTENTION_SLOTS 1
+
+#define TDMA_MIN_JOIN_SLOTS 4 // while slots are free, so new nodes can always ask
+#define TDMA_MAX_JOIN_SLOTS 255 // one byte in the beacon
+
+#define TDMA_MAP_SIZE 32 // one bit per address
+#define TDMA_BEACON_SIZE (11 + TDMA_MAP_SIZE)
+#define TDMA_GUARD_US 5000
+#define TDMA_MAX_MISSED_BEACONS 3
+#define TDMA_LISTEN_MS 70000 // longer than the longest superframe
+
+// Beacon-driven TDMA superframe. All times are relative to the end of the
+// beacon (TxDone at the gateway, RxDone on the nodes, both stamped from DIO0):
+//
+//   | guard | slot 0 | ... | slot n-1 | join 0 | ... | join j-1 | contention | next beacon |
+//   0    offset
+//
+// The beacon carries the slot map as a bitmap of addresses; slots follow in
+// address order. A node in the map transmits only inside its own slot, and
+// only in the superframe whose beacon it heard: the map changes as nodes
+// come and go. A node without a slot holds its frames and sends a join
+// request, a header-only frame, in a join slot it picks at random each
+// superframe until the next beacon lists it. The gateway sizes the join
+// window from its estimate of the nodes still waiting, which it draws from
+// the collisions it saw (see sizeJoinWindow()), and frees a slot once it
+// hasn't heard from its node for TDMA_SLOT_IDLE_BEACONS superframes. The
+// contention window is for the gateway's downlink, and for nodes once the
+// map is full and the beacon announces no join slots.
+class TdmaScheduler
+{
+  private:
+    uint16_t _periodMs = 0;
+    uint16_t _offsetMs = 0;
+    uint16_t _slotMs = 0;
+    uint16_t _joinMs = 0;
+    uint16_t _contentionMs = 0;
+    uint16_t _beaconMs = 0;
+    uint8_t _joinSlots = 0;
+    uint8_t _count = 0;    // slots in the schedule announced by the last beacon
+    uint8_t _assigned = 0; // slots in the map, announced by the next beacon
+    uint8_t _map[TDMA_MAP_SIZE] = {};
+
+    // gateway
+    bool _gateway = false;
+    uint8_t _idle[TDMA_MAP_SIZE * 8]; // beacons sent since each slot's node was heard
+    uint16_t _backlog = 0;            // estimated nodes waiting for a slot
+
+    // node
+    int _ownSlot = -1;
+    int _joinSlot = -1; // picked for this superframe
+    bool _joinSent = false;
+    uint32_t _listenUs = 0;
+
+    bool _synchronized = false;
+    uint32_t _originUs = 0;
+
+    static void put16(uint8_t *p, uint16_t value)
+    {
+        p[0] = value;
+        p[1] = value >> 8;
+    }
+
+    static uint16_t get16(const uint8_t *p)
+    {
+        return p[0] | (p[1] << 8);
+    }
+
+    bool listed(uint8_t address) const { return _map[address >> 3] & (1 << (address & 7)); }
+
+    uint32_t periodFor(uint8_t count, uint8_t joinSlots) const;
+    uint32_t contentionStartUs() const;
+    bool updatePeriod(uint8_t count);
+
+  public:
+    // Gateway side. A slot must hold the longest frame a node sends, a join
+    // slot a header-only frame and the end of the superframe the next beacon,
+    // so the airtimes come from timeOnAirUs(). Before sending each beacon,
+    // free the idle slots with releaseIdle(), size the join window with
+    // sizeJoinWindow(), then call setBeaconAirtime().
+    void configure(uint32_t slotAirtimeUs, uint32_t joinAirtimeUs, uint8_t contentionSlots);
+    void releaseIdle();
+    void sizeJoinWindow(uint32_t collisions);
+    void setBeaconAirtime(uint32_t beaconAirtimeUs);
+    int assignSlot(uint8_t address);
+    size_t writeBeacon(uint8_t *buffer) const;
+    void beaconSent(uint32_t txDoneUs);
+    bool beaconDue(uint32_t nowUs) const;
+
+    // Node side. Nothing is sent before a beacon is heard, for up to
+    // TDMA_LISTEN_MS from listen() or from losing the beacons. joinDue() is
+    // true once per superframe, at the start of the join slot picked with
+    // random, while the node has no slot.
+    void listen(uint32_t nowUs) { _listenUs = nowUs; }
+    bool onBeacon(const uint8_t *body, size_t size, uint8_t address, uint32_t rxDoneUs);
+    bool joinDue(uint32_t nowUs, uint32_t airtimeUs, uint32_t random);
+
+    // Both sides: may a frame of the given airtime start now? Senders in the
+    // contention window should pass a random backoff so they do not all
+    // start at the same instant; it is ignored inside an assigned slot.
+    bool synchronized(uint32_t nowUs) const;
+    bool canTransmit(uint32_t nowUs, uint32_t airtimeUs, uint32_t backoffUs = 0) const;
+    uint32_t contentionUs() const { return (uint32_t)_contentionMs * 1000; }
+    uint32_t backoffRangeUs(uint32_t airtimeUs) const;
+
+    uint8_t slotCount() const { return _assigned; }
+    uint8_t joinSlots() const { return _joinSlots; }
+    uint16_t backlog() const { return _backlog; }
+    int ownSlot() const { return _ownSlot; }
+    uint16_t periodMs() const { return _periodMs; }
+};
+
+void TdmaScheduler::configure(uint32_t slotAirtimeUs, uint32_t joinAirtimeUs, uint8_t contentionSlots)
+{
+    _offsetMs = TDMA_GUARD_US / 1000;
+    _slotMs = (slotAirtimeUs + 2 * TDMA_GUARD_US + 999) / 1000;
+    _joinMs = (joinAirtimeUs + 2 * TDMA_GUARD_US + 999) / 1000;
+    _contentionMs = contentionSlots * _slotMs;
+    _joinSlots = TDMA_MIN_JOIN_SLOTS;
+    _count = _assigned = 0;
+    _backlog = 0;
+    memset(_map, 0, sizeof(_map));
+    _gateway = true;
+    updatePeriod(0);
+}
+
+void TdmaScheduler::releaseIdle()
+{
+    for (int address = 0; address < TDMA_MAP_SIZE * 8; address++)
+    {
+        if (!listed(address) || ++_idle[address] < TDMA_SLOT_IDLE_BEACONS)
+            continue;
+        _map[address >> 3] &= ~(1 << (address & 7));
+        _assigned--;
+    }
+}
+
+// Frame slotted ALOHA with one try per node and superframe: a join window
+// as wide as the number of contenders gets the most of them through. Every
+// collided join slot held 2.39 nodes on average (Schoute), and all of them
+// try again, so the window follows the collisions of the last one. The
+// gateway only sees a collision as a corrupted frame, so collisions counts
+// the frames it dropped since the last beacon; the slots themselves are
+// collision-free.
+void TdmaScheduler::sizeJoinWindow(uint32_t collisions)
+{
+    uint32_t backlog = (collisions * 239 + 99) / 100;
+    _backlog = backlog < 0xFFFF ? backlog : 0xFFFF;
+
+    if (_assigned >= TDMA_MAP_SIZE * 8 - 1 || periodFor(_assigned + 1, TDMA_MIN_JOIN_SLOTS) > 0xFFFF)
+    {
+        // no slot left to hand out: nodes without one use the contention window
+        _joinSlots = 0;
+        return;
+    }
+
+    uint32_t slots = backlog;
+    if (slots < TDMA_MIN_JOIN_SLOTS)
+        slots = TDMA_MIN_JOIN_SLOTS;
+    if (slots > TDMA_MAX_JOIN_SLOTS)
+        slots = TDMA_MAX_JOIN_SLOTS;
+    while (slots > TDMA_MIN_JOIN_SLOTS && periodFor(_assigned + 1, slots) > 0xFFFF)
+        slots--;
+    _joinSlots = slots;
+}
+
+// Also puts the slot map into force: the current superframe keeps the one
+// its beacon announced
+void TdmaScheduler::setBeaconAirtime(uint32_t beaconAirtimeUs)
+{
+    _beaconMs = (beaconAirtimeUs + TDMA_GUARD_US + 999) / 1000;
+    _count = _assigned;
+    updatePeriod(_count);
+}
+
+uint32_t TdmaScheduler::periodFor(uint8_t count, uint8_t joinSlots) const
+{
+    return (uint32_t)_offsetMs + (uint32_t)count * _slotMs + (uint32_t)joinSlots * _joinMs + _contentionMs + _beaconMs;
+}
+
+uint32_t TdmaScheduler::contentionStartUs() const
+{
+    return ((uint32_t)_offsetMs + (uint32_t)_count * _slotMs + (uint32_t)_joinSlots * _joinMs) * 1000;
+}
+
+bool TdmaScheduler::updatePeriod(uint8_t count)
+{
+    uint32_t period = periodFor(count, _joinSlots);
+    if (period > 0xFFFF)
+        return false;
+    _periodMs = period;
+    return true;
+}
+
+// Keeps the slot of a node that is heard, or gives one to a node that isn't
+// in the map yet, join request or not. The broadcast address never gets one.
+int TdmaScheduler::assignSlot(uint8_t address)
+{
+    if (address == 0xFF)
+        return -1;
+
+    if (!listed(address))
+    {
+        if (periodFor(_assigned + 1, _joinSlots) > 0xFFFF)
+            return -1;
+        _map[address >> 3] |= 1 << (address & 7);
+        _assigned++;
+    }
+    _idle[address] = 0;
+
+    int slot = 0;
+    for (int i = 0; i < address; i++)
+        slot += listed(i);
+    return slot;
+}
+
+size_t TdmaScheduler::writeBeacon(uint8_t *buffer) const
+{
+    put16(buffer, _periodMs);
+    put16(buffer + 2, _offsetMs);
+    put16(buffer + 4, _slotMs);
+    put16(buffer + 6, _joinMs);
+    buffer[8] = _joinSlots;
+    put16(buffer + 9, _contentionMs);
+    memcpy(buffer + 11, _map, TDMA_MAP_SIZE);
+    return TDMA_BEACON_SIZE;
+}
+
+void TdmaScheduler::beaconSent(uint32_t txDoneUs)
+{
+    _originUs = txDoneUs;
+    _synchronized = true;
+}
+
+bool TdmaScheduler::beaconDue(uint32_t nowUs) const
+{
+    return !_synchronized || nowUs - _originUs >= (uint32_t)(_periodMs - _beaconMs) * 1000;
+}
+
+bool TdmaScheduler::onBeacon(const uint8_t *body, size_t size, uint8_t address, uint32_t rxDoneUs)
+{
+    if (size < TDMA_BEACON_SIZE)
+        return false;
+
+    _periodMs = get16(body);
+    _offsetMs = get16(body + 2);
+    _slotMs = get16(body + 4);
+    _joinMs = get16(body + 6);
+    _joinSlots = body[8];
+    _contentionMs = get16(body + 9);
+    memcpy(_map, body + 11, TDMA_MAP_SIZE);
+
+    _count = 0;
+    _ownSlot = -1;
+    for (int i = 0; i < TDMA_MAP_SIZE * 8; i++)
+    {
+        if (!listed(i))
+            continue;
+        if (i == address)
+            _ownSlot = _count;
+        _count++;
+    }
+    _assigned = _count;
+
+    _joinSlot = -1;
+    _joinSent = false;
+    _originUs = rxDoneUs;
+    _synchronized = true;
+    return true;
+}
+
+bool TdmaScheduler::joinDue(uint32_t nowUs, uint32_t airtimeUs, uint32_t random)
+{
+    uint32_t t = nowUs - _originUs;
+    if (_gateway || _ownSlot >= 0 || !_joinSlots || _joinSent || t >= (uint32_t)_periodMs * 1000)
+        return false;
+
+    if (_joinSlot < 0)
+        _joinSlot = random % _joinSlots;
+    uint32_t start = ((uint32_t)_offsetMs + (uint32_t)_count * _slotMs + (uint32_t)_joinSlot * _joinMs) * 1000;
+    if (t < start + TDMA_GUARD_US || t + airtimeUs + TDMA_GUARD_US > start + (uint32_t)_joinMs * 1000)
+        return false;
+
+    _joinSent = true;
+    return true;
+}
+
+bool TdmaScheduler::synchronized(uint32_t nowUs) const
+{
+    return _synchronized && nowUs - _originUs < (uint32_t)_periodMs * 1000 * TDMA_MAX_MISSED_BEACONS;
+}
+
+// Backoffs below this still leave room for the frame in the contention
+// window, with a guard time of slack for the sender's polling
+uint32_t TdmaScheduler::backoffRangeUs(uint32_t airtimeUs) const
+{
+    uint32_t used = airtimeUs + 2 * TDMA_GUARD_US;
+    return contentionUs() > used ? contentionUs() - used : 0;
+}
+
+bool TdmaScheduler::canTransmit(uint32_t nowUs, uint32_t airtimeUs, uint32_t backoffUs) const
+{
+    // a node that talks before it hears a beacon collides with the ones that
+    // do; past TDMA_LISTEN_MS without one there is no schedule to respect
+    if (!synchronized(nowUs))
+    {
+        uint32_t since = _synchronized ? _originUs + (uint32_t)_periodMs * 1000 * TDMA_MAX_MISSED_BEACONS : _listenUs;
+        return _gateway || nowUs - since >= (uint32_t)TDMA_LISTEN_MS * 1000;
+    }
+
+    uint32_t elapsed = nowUs - _originUs;
+    uint32_t start, width;
+    if (_ownSlot >= 0)
+    {
+        // after a missed beacon the slot may belong to someone else
+        if (elapsed >= (uint32_t)_periodMs * 1000)
+            return false;
+        start = ((uint32_t)_offsetMs + (uint32_t)_ownSlot * _slotMs) * 1000;
+        width = (uint32_t)_slotMs * 1000;
+    }
+    else
+    {
+        // while join slots are open, a node waits for a slot of its own
+        if (!_gateway && _joinSlots)
+            return false;
+        start = contentionStartUs();
+        width = (uint32_t)_contentionMs * 1000;
+        if (backoffUs < width)
+        {
+            start += backoffUs;
+            width -= backoffUs;
+        }
+    }
+
+    uint32_t t = elapsed % ((uint32_t)_periodMs * 1000);
+    return t >= start && t + airtimeUs + TDMA_GUARD_US <= start + width;
+}
+
+#endif
@@ -0,0 +1,146 @@
+#ifndef BUMP_ALLOCATOR_H
+#define BUMP_ALLOCATOR_H
+
+#include <ArduinoJson.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// One ArduinoJson variant pool (slots of two pointers) plus room for strings
+#define JSON_ARENA_SIZE (ARDUINOJSON_POOL_CAPACITY * 2 * ARDUINOJSON_SIZEOF_POINTER + 512)
+
+struct AllocatorStats
+{
+    uint32_t allocations;     // served from the arena
+    uint32_t heapAllocations; // arena full, served by malloc
+    uint32_t resets;
+    size_t peak; // highest arena usage, in bytes
+};
+
+// ArduinoJson allocator handing out memory from a fixed arena by moving a
+// pointer. Freeing is a no-op except for the latest block, which also is
+// the only one that can grow in place (the string being parsed, the pool
+// being shrunk). reset() rewinds the arena once the document using it has
+// been cleared, so a document reused every cycle never reaches the heap;
+// heapAllocations counts the times the arena was too small.
+template <size_t Size>
+class BumpAllocator : public ArduinoJson::Allocator
+{
+  private:
+    // each block is preceded by its size, which keeps blocks 8-byte aligned
+    static const size_t HEADER = 8;
+    static_assert(sizeof(size_t) <= HEADER, "block header too small");
+
+    alignas(8) uint8_t _arena[Size];
+    size_t _used = 0;
+    size_t _last = Size; // offset of the latest block
+    uint32_t _live = 0;  // blocks not yet freed, arena and heap
+    AllocatorStats _stats = {};
+
+    void setEnd(size_t start, size_t size)
+    {
+        _used = (start + size + 7) & ~(size_t)7;
+        if (_used > _stats.peak)
+            _stats.peak = _used;
+    }
+
+    bool owns(const void *ptr) const
+    {
+        return (const uint8_t *)ptr >= _arena && (const uint8_t *)ptr < _arena + Size;
+    }
+
+  public:
+    void *allocate(size_t size) override;
+    void deallocate(void *ptr) override;
+    void *reallocate(void *ptr, size_t size) override;
+
+    // Rewinds the arena; refused while blocks are still in use
+    bool reset();
+
+    size_t used() const { return _used; }
+    const AllocatorStats &stats() const { return _stats; }
+};
+
+template <size_t Size>
+void *BumpAllocator<Size>::allocate(size_t size)
+{
+    size_t start = _used + HEADER;
+    if (start + size > Size)
+    {
+        void *ptr = malloc(size);
+        if (ptr)
+        {
+            _stats.heapAllocations++;
+            _live++;
+        }
+        return ptr;
+    }
+
+    _last = start;
+    setEnd(start, size);
+    *(size_t *)(_arena + start - HEADER) = size;
+    _stats.allocations++;
+    _live++;
+    return _arena + start;
+}
+
+template <size_t Size>
+void BumpAllocator<Size>::deallocate(void *ptr)
+{
+    if (!ptr)
+        return;
+    _live--;
+    if (!owns(ptr))
+    {
+        free(ptr);
+        return;
+    }
+    if ((uint8_t *)ptr == _arena + _last)
+    {
+        _used = _last - HEADER;
+        _last = Size;
+    }
+}
+
+template <size_t Size>
+void *BumpAllocator<Size>::reallocate(void *ptr, size_t size)
+{
+    if (!ptr)
+        return allocate(size);
+    if (!owns(ptr))
+        return realloc(ptr, size);
+
+    size_t offset = (uint8_t *)ptr - _arena;
+    size_t &blockSize = *(size_t *)(_arena + offset - HEADER);
+    if (offset == _last && offset + size <= Size)
+    {
+        blockSize = size;
+        setEnd(offset, size);
+        return ptr;
+    }
+    if (size <= blockSize)
+    {
+        blockSize = size; // the rest stays unused until reset()
+        return ptr;
+    }
+
+    void *moved = allocate(size);
+    if (!moved)
+        return nullptr;
+    memcpy(moved, ptr, blockSize);
+    _live--; // the old block is abandoned in place
+    return moved;
+}
+
+template <size_t Size>
+bool BumpAllocator<Size>::reset()
+{
+    if (_live)
+        return false;
+    _used = 0;
+    _last = Size;
+    _stats.resets++;
+    return true;
+}
+
+#endif
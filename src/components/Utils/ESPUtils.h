@@ -6,6 +6,7 @@
 #include <ArduinoJson.h>
 #include <HTTPClient.h>
 #include <WiFi.h>
+#include "TimeService.h"
 
 class ESPUtils
 {
@@ -42,51 +43,17 @@ const char *ESPUtils::getModuleId()
     return "N/A"; // Placeholder for module ID, replace with actual logic if needed
 }
 
+// Unix time in ms as a string, served by TimeService without network
+// access once it has synchronised. Empty when it has not and WiFi is down.
 String ESPUtils::getDateTime()
 {
-    if (WiFi.status() == WL_CONNECTED)
-    {
-        HTTPClient http;
+    TimeService &time = TimeService::instance();
+    if (!time.synchronized() && (WiFi.status() != WL_CONNECTED || !time.sync()))
+        return String();
 
-        http.begin("https://api.bitget.com/api/v2/public/time");
-        int httpResponseCode = http.GET();
-        if (httpResponseCode > 0)
-        {
-            String payload = http.getString();
-            if (httpResponseCode == 200)
-            {
-                // Parse the JSON response
-                JsonDocument doc;
-                DeserializationError error = deserializeJson(doc, payload);
-                if (error)
-                {
-                    Serial.print(F("deserializeJson() failed: "));
-                    Serial.println(error.f_str());
-                    return String();
-                }
-
-                // Extract the date and time
-                String dateTime = doc["data"]["serverTime"].as<String>();
-                return dateTime;
-            }
-            else
-            {
-                Serial.println("GET failed!");
-            }
-        }
-        else
-        {
-            Serial.print("Error on sending GET: ");
-            Serial.println(httpResponseCode);
-        }
-        http.end();
-    }
-    else
-    {
-        Serial.println("WiFi not connected");
-    }
-
-    return String();
+    char dateTime[21];
+    snprintf(dateTime, sizeof(dateTime), "%lld", (long long)time.now());
+    return String(dateTime);
 }
 
 #endif
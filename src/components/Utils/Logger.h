@@ -0,0 +1,414 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <type_traits>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <chrono>
+#endif
+
+#ifndef LOG_QUEUE_SIZE
+#define LOG_QUEUE_SIZE 32 // records, power of two
+#endif
+
+// Bytes of encoded arguments per record: a whole LoRa frame (255 bytes)
+// passed as %s, with room left for a few more arguments
+#ifndef LOG_RECORD_SIZE
+#define LOG_RECORD_SIZE 320
+#endif
+
+#define LOG_LINE_SIZE 512
+#define LOG_DRAIN_INTERVAL_MS 5
+
+#define LOG(...) Logger::instance().log(__VA_ARGS__)
+
+// Non-blocking logger. log() only copies the format pointer and its
+// arguments into a fixed ring of binary records; formatting and the UART
+// write happen later in drain(), which runs in a low priority task on the
+// ESP32 (start()) or is called directly on the host, where it writes to
+// stdout. When the ring is full the record is dropped and counted, the
+// caller never waits.
+//
+// The ring is a bounded multi-producer queue (one sequence number per
+// record, as in Vyukov's MPMC queue) with a single consumer, so log() may be
+// called from several tasks but not from an ISR. Formats must be string
+// literals, strings passed as %s are copied and truncated to what fits in
+// the record.
+class Logger
+{
+  private:
+    static_assert(LOG_QUEUE_SIZE && (LOG_QUEUE_SIZE & (LOG_QUEUE_SIZE - 1)) == 0, "LOG_QUEUE_SIZE must be a power of two");
+    static_assert(LOG_RECORD_SIZE <= 0xFFFF, "LOG_RECORD_SIZE must fit the record's size field");
+
+    enum : uint8_t
+    {
+        ARG_INT = 'i',
+        ARG_UINT = 'u',
+        ARG_INT64 = 'I',
+        ARG_UINT64 = 'U',
+        ARG_DOUBLE = 'f',
+        ARG_STRING = 's'
+    };
+
+    struct Record
+    {
+        std::atomic<uint32_t> sequence;
+        uint32_t timeUs;
+        const char *format;
+        uint16_t size;
+        bool truncated;
+        uint8_t args[LOG_RECORD_SIZE];
+    };
+
+    class Encoder
+    {
+      private:
+        Record &_record;
+
+        bool put(uint8_t tag, const void *value, size_t size)
+        {
+            if (_record.size + 1 + size > LOG_RECORD_SIZE)
+            {
+                _record.truncated = true;
+                return false;
+            }
+            _record.args[_record.size] = tag;
+            memcpy(_record.args + _record.size + 1, value, size);
+            _record.size += 1 + size;
+            return true;
+        }
+
+      public:
+        explicit Encoder(Record &record) : _record(record) {}
+
+        template <typename T>
+        typename std::enable_if<std::is_integral<T>::value>::type add(T value)
+        {
+            if (sizeof(T) <= 4)
+            {
+                uint32_t v = (uint32_t)value;
+                put(std::is_signed<T>::value ? ARG_INT : ARG_UINT, &v, sizeof(v));
+            }
+            else
+            {
+                uint64_t v = (uint64_t)value;
+                put(std::is_signed<T>::value ? ARG_INT64 : ARG_UINT64, &v, sizeof(v));
+            }
+        }
+
+        template <typename T>
+        typename std::enable_if<std::is_enum<T>::value>::type add(T value)
+        {
+            add((int32_t)value);
+        }
+
+        void add(double value)
+        {
+            put(ARG_DOUBLE, &value, sizeof(value));
+        }
+
+        void add(const char *value)
+        {
+            if (!value)
+                value = "(null)";
+            size_t room = LOG_RECORD_SIZE - _record.size;
+            if (room < 2)
+            {
+                _record.truncated = true;
+                return;
+            }
+            size_t length = 0;
+            while (length < room - 2 && value[length])
+                length++;
+            if (value[length])
+                _record.truncated = true;
+            _record.args[_record.size] = ARG_STRING;
+            memcpy(_record.args + _record.size + 1, value, length);
+            _record.args[_record.size + 1 + length] = '\0';
+            _record.size += length + 2;
+        }
+
+#ifdef ARDUINO
+        void add(const String &value)
+        {
+            add(value.c_str());
+        }
+#endif
+
+        void addAll() {}
+
+        template <typename T, typename... Rest>
+        void addAll(const T &first, const Rest &...rest)
+        {
+            add(first);
+            addAll(rest...);
+        }
+    };
+
+    Record _records[LOG_QUEUE_SIZE];
+    std::atomic<uint32_t> _enqueue;
+    uint32_t _dequeue = 0;
+
+    std::atomic<uint32_t> _dropped;
+    uint32_t _written = 0;
+    uint32_t _truncated = 0;
+
+#ifdef ARDUINO
+    Print *_out = &Serial;
+    TaskHandle_t _task = nullptr;
+
+    static void drainTask(void *param);
+#endif
+
+    static uint32_t nowUs()
+    {
+#ifdef ARDUINO
+        return micros();
+#else
+        using namespace std::chrono;
+        return (uint32_t)duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+
+    Record *acquire();
+    size_t format(const Record &record, char *line, size_t size) const;
+    void write(const char *line, size_t length);
+
+    Logger();
+
+  public:
+    static Logger &instance();
+
+    // Queues a record, returns false if it was dropped because the ring is
+    // full
+    template <typename... Args>
+    bool log(const char *format, const Args &...args)
+    {
+        Record *record = acquire();
+        if (!record)
+            return false;
+
+        record->timeUs = nowUs();
+        record->format = format;
+        record->size = 0;
+        record->truncated = false;
+        Encoder(*record).addAll(args...);
+
+        // publish to the consumer
+        uint32_t position = record->sequence.load(std::memory_order_relaxed);
+        record->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Formats and writes up to max queued records, returns how many were
+    // written. Single consumer: call it from one task only.
+    size_t drain(size_t max = (size_t)-1);
+
+#ifdef ARDUINO
+    // Drains to out from a background task
+    void start(Print &out = Serial, UBaseType_t priority = 1);
+#endif
+
+    uint32_t dropped() const { return _dropped.load(std::memory_order_relaxed); }
+    uint32_t written() const { return _written; }
+    uint32_t truncated() const { return _truncated; }
+};
+
+Logger::Logger() : _enqueue(0), _dropped(0)
+{
+    for (uint32_t i = 0; i < LOG_QUEUE_SIZE; i++)
+        _records[i].sequence.store(i, std::memory_order_relaxed);
+}
+
+Logger &Logger::instance()
+{
+    static Logger logger;
+    return logger;
+}
+
+Logger::Record *Logger::acquire()
+{
+    uint32_t position = _enqueue.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        Record &record = _records[position & (LOG_QUEUE_SIZE - 1)];
+        int32_t diff = (int32_t)(record.sequence.load(std::memory_order_acquire) - position);
+        if (diff == 0)
+        {
+            if (_enqueue.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                return &record;
+        }
+        else if (diff < 0)
+        {
+            _dropped.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        else
+        {
+            position = _enqueue.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+size_t Logger::format(const Record &record, char *line, size_t size) const
+{
+    size_t length = snprintf(line, size, "[%lu.%06lu] ", (unsigned long)(record.timeUs / 1000000), (unsigned long)(record.timeUs % 1000000));
+    const char *f = record.format;
+    size_t arg = 0;
+
+    while (*f && length < size - 1)
+    {
+        if (*f != '%' || f[1] == '%')
+        {
+            line[length++] = *f;
+            f += *f == '%' ? 2 : 1;
+            continue;
+        }
+
+        // split "%-08.3lf" into flags/width/precision and the conversion,
+        // dropping the length modifier: the argument's tag decides it
+        char spec[16] = "%";
+        size_t s = 1;
+        const char *start = f++;
+        while (*f && strchr("-+ #0123456789.", *f) && s < sizeof(spec) - 4)
+            spec[s++] = *f++;
+        while (*f && strchr("hlLqjzt", *f))
+            f++;
+        char conversion = *f ? *f++ : 's';
+
+        if (arg >= record.size)
+        {
+            // missing argument, print the specifier as written
+            int n = snprintf(line + length, size - length, "%.*s", (int)(f - start), start);
+            length += n > 0 ? n : 0;
+            continue;
+        }
+
+        uint8_t tag = record.args[arg++];
+        const uint8_t *value = record.args + arg;
+        bool integer = strchr("diouxXc", conversion) != nullptr;
+        int n = 0;
+
+        switch (tag)
+        {
+        case ARG_INT:
+        case ARG_UINT:
+        {
+            uint32_t v;
+            memcpy(&v, value, sizeof(v));
+            arg += sizeof(v);
+            spec[s++] = integer ? conversion : (tag == ARG_INT ? 'd' : 'u');
+            spec[s] = '\0';
+            n = tag == ARG_INT ? snprintf(line + length, size - length, spec, (int)(int32_t)v) : snprintf(line + length, size - length, spec, (unsigned)v);
+            break;
+        }
+        case ARG_INT64:
+        case ARG_UINT64:
+        {
+            uint64_t v;
+            memcpy(&v, value, sizeof(v));
+            arg += sizeof(v);
+            spec[s++] = 'l';
+            spec[s++] = 'l';
+            spec[s++] = integer && conversion != 'c' ? conversion : (tag == ARG_INT64 ? 'd' : 'u');
+            spec[s] = '\0';
+            n = snprintf(line + length, size - length, spec, (unsigned long long)v);
+            break;
+        }
+        case ARG_DOUBLE:
+        {
+            double v;
+            memcpy(&v, value, sizeof(v));
+            arg += sizeof(v);
+            spec[s++] = strchr("fFeEgGaA", conversion) ? conversion : 'f';
+            spec[s] = '\0';
+            n = snprintf(line + length, size - length, spec, v);
+            break;
+        }
+        default: // ARG_STRING
+        {
+            const char *v = (const char *)value;
+            arg += strlen(v) + 1;
+            spec[s++] = 's';
+            spec[s] = '\0';
+            n = snprintf(line + length, size - length, spec, v);
+            break;
+        }
+        }
+        length += n > 0 ? n : 0;
+    }
+
+    if (length > size - 2)
+        length = size - 2;
+    line[length++] = '\n';
+    line[length] = '\0';
+    return length;
+}
+
+void Logger::write(const char *line, size_t length)
+{
+#ifdef ARDUINO
+    _out->write((const uint8_t *)line, length);
+#else
+    fwrite(line, 1, length, stdout);
+#endif
+}
+
+size_t Logger::drain(size_t max)
+{
+    char line[LOG_LINE_SIZE];
+    size_t count = 0;
+
+    while (count < max)
+    {
+        Record &record = _records[_dequeue & (LOG_QUEUE_SIZE - 1)];
+        if (record.sequence.load(std::memory_order_acquire) != _dequeue + 1)
+            break;
+
+        size_t length = format(record, line, sizeof(line));
+        if (record.truncated)
+            _truncated++;
+
+        // hand the record back to the producers before the slow write
+        record.sequence.store(_dequeue + LOG_QUEUE_SIZE, std::memory_order_release);
+        _dequeue++;
+
+        write(line, length);
+        _written++;
+        count++;
+    }
+
+#ifndef ARDUINO
+    if (count)
+        fflush(stdout);
+#endif
+    return count;
+}
+
+#ifdef ARDUINO
+void Logger::drainTask(void *param)
+{
+    Logger *logger = (Logger *)param;
+    for (;;)
+    {
+        if (!logger->drain())
+            vTaskDelay(pdMS_TO_TICKS(LOG_DRAIN_INTERVAL_MS));
+    }
+}
+
+void Logger::start(Print &out, UBaseType_t priority)
+{
+    _out = &out;
+    if (!_task)
+        xTaskCreate(drainTask, "log", 4096, this, priority, &_task);
+}
+#endif
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+// Lock-free single-producer single-consumer ring. Items are filled and
+// consumed in place (reserve/publish, front/pop) so large items such as
+// frames are copied once. Size must be a power of two.
+template <typename T, uint16_t Size>
+class SpscQueue
+{
+    static_assert(Size && (Size & (Size - 1)) == 0, "SpscQueue size must be a power of two");
+
+  private:
+    T _items[Size];
+    std::atomic<uint32_t> _head; // next item to consume, written by the consumer
+    std::atomic<uint32_t> _tail; // next slot to fill, written by the producer
+
+  public:
+    SpscQueue() : _head(0), _tail(0) {}
+
+    // Producer: slot to fill, or nullptr when full
+    T *reserve()
+    {
+        uint32_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail - _head.load(std::memory_order_acquire) == Size)
+            return nullptr;
+        return &_items[tail & (Size - 1)];
+    }
+
+    // Producer: makes the reserved slot visible to the consumer
+    void publish()
+    {
+        _tail.store(_tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // Consumer: oldest item, or nullptr when empty
+    T *front()
+    {
+        uint32_t head = _head.load(std::memory_order_relaxed);
+        if (head == _tail.load(std::memory_order_acquire))
+            return nullptr;
+        return &_items[head & (Size - 1)];
+    }
+
+    // Consumer: releases the item returned by front()
+    void pop()
+    {
+        _head.store(_head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    size_t size() const
+    {
+        return _tail.load(std::memory_order_acquire) - _head.load(std::memory_order_acquire);
+    }
+};
+
+#endif
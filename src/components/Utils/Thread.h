@@ -0,0 +1,88 @@
+#ifndef THREAD_H
+#define THREAD_H
+
+#include <atomic>
+#include <stdint.h>
+
+#if defined(ESP32)
+#include <Arduino.h>
+#else
+#include <chrono>
+#include <thread>
+#endif
+
+// Minimal thread wrapper so the same pipeline runs as a pinned FreeRTOS
+// task on the ESP32 and as a std::thread in host tests, where core and
+// priority are ignored.
+class Thread
+{
+  private:
+    void (*_entry)(void *) = nullptr;
+    void *_arg = nullptr;
+    std::atomic<bool> _running;
+#if defined(ESP32)
+    TaskHandle_t _handle = nullptr;
+#else
+    std::thread _thread;
+#endif
+
+    static void run(void *param)
+    {
+        Thread *thread = (Thread *)param;
+        thread->_entry(thread->_arg);
+        thread->_running.store(false);
+#if defined(ESP32)
+        vTaskDelete(nullptr);
+#endif
+    }
+
+  public:
+    Thread() : _running(false) {}
+    ~Thread() { join(); }
+
+    // core < 0 lets the scheduler pick a core
+    bool start(const char *name, void (*entry)(void *), void *arg, int core = -1, uint8_t priority = 1, uint32_t stackSize = 4096)
+    {
+        if (_running.load())
+            return false;
+        _entry = entry;
+        _arg = arg;
+        _running.store(true);
+#if defined(ESP32)
+        BaseType_t ok = core < 0 ? xTaskCreate(run, name, stackSize, this, priority, &_handle)
+                                 : xTaskCreatePinnedToCore(run, name, stackSize, this, priority, &_handle, core);
+        if (ok != pdPASS)
+            _running.store(false);
+        return ok == pdPASS;
+#else
+        (void)name, (void)core, (void)priority, (void)stackSize;
+        _thread = std::thread(run, this);
+        return true;
+#endif
+    }
+
+    // Waits for the entry function to return; it has to be told to stop
+    void join()
+    {
+#if defined(ESP32)
+        while (_running.load())
+            sleepMs(1);
+#else
+        if (_thread.joinable())
+            _thread.join();
+#endif
+    }
+
+    bool running() const { return _running.load(); }
+
+    static void sleepMs(uint32_t ms)
+    {
+#if defined(ESP32)
+        vTaskDelay(pdMS_TO_TICKS(ms) ? pdMS_TO_TICKS(ms) : 1);
+#else
+        std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+#endif
+    }
+};
+
+#endif
@@ -0,0 +1,310 @@
+#ifndef TIME_SERVICE_H
+#define TIME_SERVICE_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <HTTPClient.h>
+#include <WiFi.h>
+#include <atomic>
+#include <mutex>
+#include <esp_timer.h>
+#include "Logger.h"
+
+#ifndef TIME_SERVICE_URL
+#define TIME_SERVICE_URL "https://api.bitget.com/api/v2/public/time"
+#endif
+
+#define TIME_SYNC_INTERVAL_MS 600000 // after a successful sync
+#define TIME_RETRY_INTERVAL_MS 30000 // after a failure or while WiFi is down
+#define TIME_MAX_RTT_US 2000000      // slower answers are too imprecise to use
+#define TIME_MAX_DRIFT_PPB 500000    // 500 ppm, far beyond any crystal
+#define TIME_MIN_DRIFT_SPAN_US 60000000
+
+// Reads data.serverTime, as an integer, a float or a string, from the answer
+// of the time server without building a document: the other values are
+// skipped and the parsing stops after the field. A value anywhere else, such
+// as the chunk size a chunked body starts with, is ignored.
+class ServerTimeHandler : public JsonHandler
+{
+  private:
+    int _depth = 0;
+    bool _inData = false;
+    bool _found = false;
+
+  public:
+    int64_t serverMs = 0;
+
+    bool startObject()
+    {
+        _depth++;
+        return true;
+    }
+
+    bool endObject()
+    {
+        _depth--;
+        return true;
+    }
+
+    bool startArray()
+    {
+        _depth++;
+        return true;
+    }
+
+    bool endArray()
+    {
+        _depth--;
+        return true;
+    }
+
+    bool key(JsonString key)
+    {
+        if (_depth == 1)
+            _inData = key == "data";
+        else if (_depth == 2)
+            _found = _inData && key == "serverTime";
+        return true;
+    }
+
+    bool skipValue() { return _depth == 1 ? !_inData : !_found; }
+
+    bool string(JsonString value)
+    {
+        char digits[21];
+        size_t n = value.size() < sizeof(digits) - 1 ? value.size() : sizeof(digits) - 1;
+        memcpy(digits, value.c_str(), n);
+        digits[n] = 0;
+        if (_found)
+            serverMs = strtoll(digits, nullptr, 10);
+        return !_found;
+    }
+
+    bool integer(JsonInteger value)
+    {
+        if (_found)
+            serverMs = (int64_t)value;
+        return !_found;
+    }
+
+    bool unsignedInteger(JsonUInt value)
+    {
+        if (_found)
+            serverMs = (int64_t)value;
+        return !_found;
+    }
+
+    // e.g. 1.7e12, or an integer too large for JsonInteger; a double holds
+    // Unix milliseconds exactly, a float only to a few minutes
+    bool floatingPoint(JsonFloat value)
+    {
+        if (_found)
+            serverMs = (int64_t)(value + 0.5);
+        return !_found;
+    }
+};
+
+// Wall clock kept against esp_timer without touching the network on reads.
+// A background task fetches the server time every TIME_SYNC_INTERVAL_MS,
+// takes the middle of the request as the instant it refers to, and updates
+// an offset and a drift estimate (from the change of offset between syncs,
+// smoothed). now() is a few integer operations on that model.
+//
+// The server must answer with {"data":{"serverTime":<Unix ms>}}, as a number
+// or a string; only that field is parsed, straight from the stream unless
+// the answer is chunked. To test without the internet, point begin() at the
+// stand-in server in tools/time.
+//
+// The model is published with a sequence counter (seqlock): the sync task
+// is the only writer and readers on any core retry in the rare case they
+// overlap an update, so now() never blocks. Until the first update is
+// complete the counter is below 2, which is all synchronized() needs.
+class TimeService
+{
+  private:
+    struct Model
+    {
+        int64_t localUs;  // esp_timer time of the last sync
+        int64_t offsetUs; // Unix time minus esp_timer time at localUs
+        int32_t driftPpb; // rate of the wall clock relative to esp_timer, minus one
+    };
+
+    Model _model = {};
+    std::atomic<uint32_t> _version;
+
+    const char *_url = TIME_SERVICE_URL;
+    uint32_t _intervalMs = TIME_SYNC_INTERVAL_MS;
+    TaskHandle_t _task = nullptr;
+    std::mutex _syncLock; // the task and sync() callers
+
+    uint32_t _syncs = 0;
+    uint32_t _failures = 0;
+    uint32_t _lastRttUs = 0;
+
+    static void syncTask(void *param);
+    bool fetch(int64_t &serverMs, int64_t &sentUs, int64_t &receivedUs);
+    void apply(int64_t serverMs, int64_t sentUs, int64_t receivedUs);
+
+    Model load(uint32_t &version) const;
+
+    TimeService() : _version(0) {}
+
+  public:
+    static TimeService &instance();
+
+    // Starts the background sync task
+    void begin(const char *url = TIME_SERVICE_URL, uint32_t intervalMs = TIME_SYNC_INTERVAL_MS);
+
+    // One blocking sync, for callers that need the time before the task's
+    // first run
+    bool sync();
+
+    bool synchronized() const { return _version.load(std::memory_order_acquire) > 1; }
+
+    // Unix time in ms, or 0 before the first successful sync
+    int64_t now() const;
+
+    int32_t driftPpb() const
+    {
+        uint32_t version;
+        return load(version).driftPpb;
+    }
+    uint32_t syncs() const { return _syncs; }
+    uint32_t failures() const { return _failures; }
+    uint32_t lastRttUs() const { return _lastRttUs; }
+};
+
+TimeService &TimeService::instance()
+{
+    static TimeService service;
+    return service;
+}
+
+void TimeService::begin(const char *url, uint32_t intervalMs)
+{
+    _url = url;
+    _intervalMs = intervalMs;
+    if (!_task)
+        xTaskCreate(syncTask, "time", 6144, this, 1, &_task);
+}
+
+void TimeService::syncTask(void *param)
+{
+    TimeService *service = (TimeService *)param;
+    for (;;)
+    {
+        bool ok = WiFi.status() == WL_CONNECTED && service->sync();
+        vTaskDelay(pdMS_TO_TICKS(ok ? service->_intervalMs : TIME_RETRY_INTERVAL_MS));
+    }
+}
+
+bool TimeService::fetch(int64_t &serverMs, int64_t &sentUs, int64_t &receivedUs)
+{
+    HTTPClient http;
+    if (!http.begin(_url))
+        return false;
+
+    sentUs = esp_timer_get_time();
+    int httpResponseCode = http.GET();
+    receivedUs = esp_timer_get_time();
+
+    bool ok = false;
+    if (httpResponseCode == 200)
+    {
+        // the raw stream still carries the chunk sizes of a chunked answer
+        // (no Content-Length, getSize() < 0); getString() decodes them
+        ServerTimeHandler handler;
+        DeserializationError error;
+        if (http.getSize() >= 0)
+            error = parseJson(http.getStream(), handler);
+        else
+            error = parseJson(http.getString(), handler);
+        if (error)
+            LOG("Time sync: parseJson() failed: %s", error.c_str());
+        serverMs = handler.serverMs;
+        ok = !error && serverMs > 0;
+    }
+    else
+    {
+        LOG("Time sync: GET %s failed: %d", _url, httpResponseCode);
+    }
+
+    http.end();
+    return ok;
+}
+
+bool TimeService::sync()
+{
+    std::lock_guard<std::mutex> guard(_syncLock);
+    int64_t serverMs = 0, sentUs, receivedUs;
+    if (!fetch(serverMs, sentUs, receivedUs) || receivedUs - sentUs > TIME_MAX_RTT_US)
+    {
+        _failures++;
+        return false;
+    }
+
+    apply(serverMs, sentUs, receivedUs);
+    return true;
+}
+
+void TimeService::apply(int64_t serverMs, int64_t sentUs, int64_t receivedUs)
+{
+    Model previous = _model;
+    Model next;
+
+    // the server read its clock somewhere during the request, assume the
+    // middle
+    next.localUs = sentUs + (receivedUs - sentUs) / 2;
+    next.offsetUs = serverMs * 1000 - next.localUs;
+    next.driftPpb = previous.driftPpb;
+
+    int64_t span = next.localUs - previous.localUs;
+    // the sync task is the only writer, its own reads need no ordering
+    bool synchronized = _version.load(std::memory_order_relaxed) != 0;
+    if (synchronized && span >= TIME_MIN_DRIFT_SPAN_US)
+    {
+        // the offset seen now minus the one the current model predicts is
+        // the drift left uncorrected over the span
+        int64_t predicted = previous.offsetUs + span * previous.driftPpb / 1000000000;
+        int64_t measured = previous.driftPpb + (next.offsetUs - predicted) * 1000000000 / span;
+        int64_t drift = previous.driftPpb + (measured - previous.driftPpb) / 4;
+        if (drift > TIME_MAX_DRIFT_PPB)
+            drift = TIME_MAX_DRIFT_PPB;
+        if (drift < -TIME_MAX_DRIFT_PPB)
+            drift = -TIME_MAX_DRIFT_PPB;
+        next.driftPpb = drift;
+    }
+
+    _version.fetch_add(1, std::memory_order_acq_rel); // odd: update in progress
+    _model = next;
+    _version.fetch_add(1, std::memory_order_release);
+
+    _lastRttUs = receivedUs - sentUs;
+    _syncs++;
+}
+
+TimeService::Model TimeService::load(uint32_t &version) const
+{
+    Model model;
+    do
+    {
+        version = _version.load(std::memory_order_acquire);
+        model = _model;
+        std::atomic_thread_fence(std::memory_order_acquire);
+    } while ((version & 1) || version != _version.load(std::memory_order_relaxed));
+    return model;
+}
+
+int64_t TimeService::now() const
+{
+    uint32_t version;
+    Model model = load(version);
+    if (!version)
+        return 0;
+
+    int64_t local = esp_timer_get_time();
+    int64_t elapsed = local - model.localUs;
+    return (local + model.offsetUs + elapsed * model.driftPpb / 1000000000) / 1000;
+}
+
+#endif
@@ -2,47 +2,159 @@
 
 Custom_LoRa *custom_LoRa;
 uint32_t lastTime = 0;
+uint32_t lastStatsReport = 0;
+LinkStatsTable<> linkStats;
+int linkStatsRow = -1; // next row of the snapshot being logged
+
+Crc32 crc;
+SegmentLog store(crc, STORE_PATH);
+HttpForwarder forwarder;
+
+// Every JSON document in the loop is built in jsonDoc, whose memory comes
+// from a static arena, so a steady-state iteration never touches the heap
+BumpAllocator<JSON_ARENA_SIZE> jsonArena;
+JsonDocument jsonDoc(&jsonArena);
+JsonDocument idFilter;
+char txBuffer[LORA_MAX_FRAME + 1];
+
+#if SERIAL_UPLINK
+SerialUplink uplink(crc);
+#endif
 
 void setup()
 {
-    Serial.begin(115200);
+#if SERIAL_UPLINK
+    uplink.begin(Serial, UPLINK_BAUD);
+    Logger::instance().start(uplink);
+#else
+    Serial.begin(SERIAL_BAUD);
+    Logger::instance().start(Serial);
+#endif
+    idFilter["id"] = true;
+
+    if (strlen(WIFI_SSID))
+        WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
+    TimeService::instance().begin();
+
+    if (strlen(FORWARD_URL))
+    {
+        if (LittleFS.begin(true) && store.open())
+            forwarder.begin(FORWARD_URL, FORWARD_FORMAT, &store);
+        else
+            forwarder.begin(FORWARD_URL, FORWARD_FORMAT);
+    }
+
     custom_LoRa = new Custom_LoRa(ss, rst, dio0);
 
     custom_LoRa->onReceive(receivePayload);
+    custom_LoRa->setAddress(LORA_NETWORK, LORA_ADDRESS);
+    custom_LoRa->enableCrc32(crc);
 
     if (!custom_LoRa->begin(433E6))
     {
-        Serial.println("LoRa Initialization Failed!");
+        LOG("LoRa Initialization Failed!");
         while (1)
             ;
     }
 
-    Serial.println("LoRa Initializing OK!");
+    LOG("LoRa Initializing OK!");
+
+    if (!custom_LoRa->startTask(LORA_TASK_CORE, LORA_TASK_PRIORITY))
+        LOG("LoRa task failed to start, polling from loop()");
 }
 
 void loop()
 {
     custom_LoRa->loop();
+#if SERIAL_UPLINK
+    uplink.loop();
+#endif
+    if (strlen(FORWARD_URL))
+        forwarder.loop();
     if (millis() - lastTime > 5000)
     {
         lastTime = millis();
-        String payload = sendPayload();
-        custom_LoRa->sendPayload(payload.c_str());
-        Serial.printf("Sending packet: %s\n", payload.c_str());
+        const char *payload = sendPayload();
+        custom_LoRa->sendPayload(payload);
+        LOG("Sending packet: %s", payload);
+    }
+
+    if (millis() - lastStatsReport > LINK_STATS_REPORT_MS)
+    {
+        lastStatsReport = millis();
+        const RuntimeStats &runtime = custom_LoRa->runtimeStats();
+        LOG("Load: radio %u/1000, app %u/1000, rx queue max %u us, %u dropped",
+            runtime.radio.loadPermille, runtime.application.loadPermille,
+            runtime.rx.latencyMaxUs, runtime.rx.drops);
+        LOG("JSON arena: peak %u/%u bytes, %u heap allocations",
+            jsonArena.stats().peak, JSON_ARENA_SIZE, jsonArena.stats().heapAllocations);
+#if SERIAL_UPLINK
+        UplinkChunkWriter stats(uplink, UPLINK_TYPE_STATS);
+        linkStats.writeMsgPack(stats, lastStatsReport);
+        stats.close();
+#else
+        linkStats.expire(lastStatsReport);
+        LOG("Link stats: %u nodes, %u rejected", linkStats.size(), linkStats.rejected());
+        linkStatsRow = linkStats.nextRow(0);
+#endif
+    }
+    logLinkStats();
+}
+
+// Logs the link stats snapshot a few rows per loop() through the logger, so
+// neither loop() nor the log ring is held up by hundreds of nodes. A row
+// the ring has no room for is tried again on the next call.
+void logLinkStats()
+{
+    char row[LINK_STATS_ROW_SIZE];
+    for (int i = 0; i < LINK_STATS_ROWS_PER_LOOP && linkStatsRow >= 0; i++)
+    {
+        linkStats.writeRowJson(resetJson(), linkStatsRow, row, sizeof(row), millis());
+        if (!LOG("Link stats: %s", row))
+            return;
+        linkStatsRow = linkStats.nextRow(linkStatsRow + 1);
     }
 }
 
 void receivePayload(const char *payload, int rssi)
 {
-    Serial.printf("Received Package with RSSI %d: %s\n", rssi, payload);
+#if SERIAL_UPLINK
+    uplink.sendFrame(payload, custom_LoRa->lastPacket());
+#else
+    LOG("Received Package with RSSI %d: %s", rssi, payload);
+#endif
+
+    if (strlen(FORWARD_URL))
+        forwarder.add(payload, custom_LoRa->lastPacket());
+
+    JsonDocument &doc = resetJson();
+    // the JsonDocument overload of Filter would shrink idFilter on every call
+    if (deserializeJson(doc, payload, DeserializationOption::Filter(idFilter.as<JsonVariantConst>())))
+        return;
+
+    // an id that isn't a number would take a slot of its own
+    const char *id = doc["id"];
+    char *end = nullptr;
+    uint64_t value = id ? strtoull(id, &end, 10) : 0;
+    if (value && *end == '\0')
+        linkStats.update(value, custom_LoRa->lastPacket(), millis());
 }
 
-String sendPayload()
+// Valid until the next call
+const char *sendPayload()
 {
-    JsonDocument doc;
+    JsonDocument &doc = resetJson();
     doc["id"] = ESPUtils::getDeviceId();
     doc["type"] = "test";
     doc["data"] = "Hello World!";
     doc["date"] = millis();
-    return doc.as<String>();
+    serializeJson(doc, txBuffer, sizeof(txBuffer));
+    return txBuffer;
+}
+
+JsonDocument &resetJson()
+{
+    jsonDoc.clear();
+    jsonArena.reset();
+    return jsonDoc;
 }
@@ -0,0 +1,104 @@
+// On-device check and benchmark of both AES-CCM backends: the mbedtls path
+// the firmware uses (Aes128, the AES accelerator) and the portable one
+// (PortableAes128). Both run the known-answer vectors of tools/bench, then
+// seal() and open() frames of the sizes ccm_bench uses on the host, with
+// Custom_LoRa's header, counter and 4-byte MIC.
+//
+//   pio test -e node32s -f test_ccm
+
+#include <Arduino.h>
+#include <unity.h>
+#include "../../tools/bench/ccm_vectors.h"
+#include "../../src/components/LoRa/FrameHeader.h"
+
+#define BENCH_ROUNDS 200
+#define BENCH_MAX_PAYLOAD 256
+
+static const size_t SIZES[] = {16, 64, 128, 238};
+
+static void report(const char *what, int index)
+{
+    char message[80];
+    snprintf(message, sizeof(message), "%s, vector %d", what, index + 1);
+    TEST_MESSAGE(message);
+}
+
+// Microseconds per call of seal() and open() of one frame
+template <typename Cipher>
+static void benchFrame(const Cipher &cipher, size_t size, float &sealUs, float &openUs)
+{
+    uint8_t nonce[CCM_NONCE_SIZE] = {};
+    uint8_t aad[FRAME_HEADER_SIZE + FRAME_COUNTER_SIZE] = {};
+    uint8_t plain[BENCH_MAX_PAYLOAD], data[BENCH_MAX_PAYLOAD], sealed[BENCH_MAX_PAYLOAD];
+    uint8_t tag[FRAME_MIC_SIZE];
+    for (size_t i = 0; i < size; i++)
+        plain[i] = esp_random();
+
+    memcpy(sealed, plain, size);
+    AesCcm::seal(cipher, nonce, aad, sizeof(aad), sealed, size, tag, sizeof(tag));
+
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < BENCH_ROUNDS; i++)
+    {
+        memcpy(data, plain, size);
+        AesCcm::seal(cipher, nonce, aad, sizeof(aad), data, size, tag, sizeof(tag));
+    }
+    sealUs = (float)(esp_timer_get_time() - start) / BENCH_ROUNDS;
+
+    bool ok = true;
+    start = esp_timer_get_time();
+    for (int i = 0; i < BENCH_ROUNDS; i++)
+    {
+        memcpy(data, sealed, size);
+        ok &= AesCcm::open(cipher, nonce, aad, sizeof(aad), data, size, tag, sizeof(tag));
+    }
+    openUs = (float)(esp_timer_get_time() - start) / BENCH_ROUNDS;
+    TEST_ASSERT_TRUE(ok);
+    TEST_ASSERT_EQUAL_MEMORY(plain, data, size);
+}
+
+static void test_vectors_mbedtls()
+{
+    TEST_ASSERT_EQUAL(0, checkCcmVectors<Aes128>(report));
+}
+
+static void test_vectors_portable()
+{
+    TEST_ASSERT_EQUAL(0, checkCcmVectors<PortableAes128>(report));
+}
+
+static void test_throughput()
+{
+    uint8_t key[AES_KEY_SIZE];
+    ccmVectorKey(key);
+    Aes128 hardware;
+    PortableAes128 portable;
+    hardware.setKey(key);
+    portable.setKey(key);
+
+    char line[96];
+    TEST_MESSAGE("payload  mbedtls seal/open (us)  portable seal/open (us)  speedup");
+    for (size_t size : SIZES)
+    {
+        float hardwareSeal, hardwareOpen, portableSeal, portableOpen;
+        benchFrame(hardware, size, hardwareSeal, hardwareOpen);
+        benchFrame(portable, size, portableSeal, portableOpen);
+        snprintf(line, sizeof(line), "%7u  %10.1f %10.1f  %11.1f %11.1f  %6.1fx", (unsigned)size, hardwareSeal,
+                 hardwareOpen, portableSeal, portableOpen, portableSeal / hardwareSeal);
+        TEST_MESSAGE(line);
+    }
+}
+
+void setup()
+{
+    delay(2000); // lets the test runner attach to the serial port
+    UNITY_BEGIN();
+    RUN_TEST(test_vectors_mbedtls);
+    RUN_TEST(test_vectors_portable);
+    RUN_TEST(test_throughput);
+    UNITY_END();
+}
+
+void loop()
+{
+}
@@ -0,0 +1,52 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <chrono>
+#include <stddef.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Cost of one call, in nanoseconds and in TSC cycles (0 where there is no
+// TSC). The TSC ticks at the nominal clock, so turbo and power saving skew
+// the cycle counts; pin the clock for stable numbers.
+struct BenchResult
+{
+    double ns;
+    double cycles;
+};
+
+static inline unsigned long long benchCycles()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+// Calls fn in growing batches until a batch takes at least minSeconds
+template <typename Fn>
+BenchResult bench(Fn fn, double minSeconds = 0.2)
+{
+    for (size_t calls = 1;; calls *= 2)
+    {
+        auto start = std::chrono::steady_clock::now();
+        unsigned long long cycles = benchCycles();
+        for (size_t i = 0; i < calls; i++)
+            fn();
+        cycles = benchCycles() - cycles;
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (seconds >= minSeconds)
+            return {seconds * 1e9 / calls, (double)cycles / calls};
+    }
+}
+
+// Keeps the compiler from dropping a computation whose result is unused
+template <typename T>
+static inline void benchKeep(const T &value)
+{
+    asm volatile("" : : "r"(&value) : "memory");
+}
+
+#endif
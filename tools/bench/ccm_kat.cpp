@@ -0,0 +1,22 @@
+// Known-answer check of the portable AES-128 and of AES-CCM: the FIPS-197
+// block vectors and the RFC 3610 packets, sealed and opened with the 8-byte
+// tags of the RFC and with the firmware's 4-byte MIC. The ESP32's mbedtls
+// path runs the same vectors in test/test_ccm.
+//
+//   ccm_kat
+
+#include <stdio.h>
+#include "ccm_vectors.h"
+
+static void report(const char *what, int index)
+{
+    printf("FAIL %s, vector %d\n", what, index + 1);
+}
+
+int main()
+{
+    int failures = checkCcmVectors<PortableAes128>(report);
+    printf("%zu AES-128 and %zu CCM vectors: %s\n", sizeof(AES_VECTORS) / sizeof(AES_VECTORS[0]),
+           sizeof(CCM_VECTORS) / sizeof(CCM_VECTORS[0]), failures ? "FAILED" : "ok");
+    return failures ? 1 : 0;
+}
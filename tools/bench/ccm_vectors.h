@@ -0,0 +1,151 @@
+// Known-answer vectors for AesCcm.h, shared by the host check (ccm_kat.cpp)
+// and the on-device test (test/test_ccm).
+//
+// AES-128: FIPS-197 appendices B and C.1. CCM: RFC 3610 packet vectors 1 to
+// 3, whose 13-byte nonce and 2-byte length field are the ones Custom_LoRa
+// uses. The RFC tags are 8 bytes. The tag length is part of the first MAC
+// block, so the firmware's 4-byte MIC is not a truncated 8-byte tag: the
+// 4-byte tags below were computed from the same packets with OpenSSL's
+// AES-128-CCM.
+
+#ifndef CCM_VECTORS_H
+#define CCM_VECTORS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "../../src/components/LoRa/AesCcm.h"
+
+struct AesVector
+{
+    uint8_t key[16];
+    uint8_t plaintext[16];
+    uint8_t ciphertext[16];
+};
+
+static const AesVector AES_VECTORS[] = {
+    // FIPS-197 appendix B
+    {{0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c},
+     {0x32, 0x43, 0xf6, 0xa8, 0x88, 0x5a, 0x30, 0x8d, 0x31, 0x31, 0x98, 0xa2, 0xe0, 0x37, 0x07, 0x34},
+     {0x39, 0x25, 0x84, 0x1d, 0x02, 0xdc, 0x09, 0xfb, 0xdc, 0x11, 0x85, 0x97, 0x19, 0x6a, 0x0b, 0x32}},
+    // FIPS-197 appendix C.1
+    {{0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f},
+     {0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff},
+     {0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30, 0xd8, 0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5, 0x5a}},
+};
+
+// Key C0..CF; the packet is the bytes 00, 01, 02... of which the first 8 are
+// the additional data and the rest the payload
+struct CcmVector
+{
+    uint8_t nonce[13];
+    uint8_t size; // payload bytes
+    uint8_t ciphertext[25];
+    uint8_t tag8[8];
+    uint8_t tag4[4];
+};
+
+#define CCM_VECTOR_AAD_SIZE 8
+
+static const CcmVector CCM_VECTORS[] = {
+    // RFC 3610 packet vector #1
+    {{0x00, 0x00, 0x00, 0x03, 0x02, 0x01, 0x00, 0xa0, 0xa1, 0xa2, 0xa3, 0xa4, 0xa5},
+     23,
+     {0x58, 0x8c, 0x97, 0x9a, 0x61, 0xc6, 0x63, 0xd2, 0xf0, 0x66, 0xd0, 0xc2, 0xc0,
+      0xf9, 0x89, 0x80, 0x6d, 0x5f, 0x6b, 0x61, 0xda, 0xc3, 0x84},
+     {0x17, 0xe8, 0xd1, 0x2c, 0xfd, 0xf9, 0x26, 0xe0},
+     {0x50, 0x19, 0x8b, 0xbc}},
+    // RFC 3610 packet vector #2
+    {{0x00, 0x00, 0x00, 0x04, 0x03, 0x02, 0x01, 0xa0, 0xa1, 0xa2, 0xa3, 0xa4, 0xa5},
+     24,
+     {0x72, 0xc9, 0x1a, 0x36, 0xe1, 0x35, 0xf8, 0xcf, 0x29, 0x1c, 0xa8, 0x94, 0x08,
+      0x5c, 0x87, 0xe3, 0xcc, 0x15, 0xc4, 0x39, 0xc9, 0xe4, 0x3a, 0x3b},
+     {0xa0, 0x91, 0xd5, 0x6e, 0x10, 0x40, 0x09, 0x16},
+     {0xf6, 0xe0, 0x07, 0x99}},
+    // RFC 3610 packet vector #3
+    {{0x00, 0x00, 0x00, 0x05, 0x04, 0x03, 0x02, 0xa0, 0xa1, 0xa2, 0xa3, 0xa4, 0xa5},
+     25,
+     {0x51, 0xb1, 0xe5, 0xf4, 0x4a, 0x19, 0x7d, 0x1d, 0xa4, 0x6b, 0x0f, 0x8e, 0x2d,
+      0x28, 0x2a, 0xe8, 0x71, 0xe8, 0x38, 0xbb, 0x64, 0xda, 0x85, 0x96, 0x57},
+     {0x4a, 0xda, 0xa7, 0x6f, 0xbd, 0x9f, 0xb0, 0xc5},
+     {0xa3, 0x93, 0x8a, 0x1d}},
+};
+
+static void ccmVectorKey(uint8_t key[16])
+{
+    for (int i = 0; i < 16; i++)
+        key[i] = 0xc0 + i;
+}
+
+static void ccmVectorPacket(uint8_t *packet, size_t size)
+{
+    for (size_t i = 0; i < size; i++)
+        packet[i] = i;
+}
+
+// Runs every vector through Cipher (Aes128 or PortableAes128) and AesCcm,
+// sealing and opening with both tag lengths and rejecting a flipped bit.
+// Returns the number of failures, each reported through fail(what, index).
+template <typename Cipher>
+int checkCcmVectors(void (*fail)(const char *what, int index))
+{
+    int failures = 0;
+    for (size_t v = 0; v < sizeof(AES_VECTORS) / sizeof(AES_VECTORS[0]); v++)
+    {
+        Cipher cipher;
+        uint8_t block[16];
+        cipher.setKey(AES_VECTORS[v].key);
+        cipher.encryptBlock(AES_VECTORS[v].plaintext, block);
+        if (memcmp(block, AES_VECTORS[v].ciphertext, 16))
+        {
+            fail("AES-128 block", v);
+            failures++;
+        }
+    }
+
+    uint8_t key[16];
+    ccmVectorKey(key);
+    Cipher cipher;
+    cipher.setKey(key);
+
+    for (size_t v = 0; v < sizeof(CCM_VECTORS) / sizeof(CCM_VECTORS[0]); v++)
+    {
+        const CcmVector &vector = CCM_VECTORS[v];
+        uint8_t packet[CCM_VECTOR_AAD_SIZE + 25];
+        ccmVectorPacket(packet, CCM_VECTOR_AAD_SIZE + vector.size);
+        const uint8_t *aad = packet;
+        const uint8_t *tags[2] = {vector.tag8, vector.tag4};
+        const uint8_t tagSizes[2] = {8, 4};
+
+        for (int t = 0; t < 2; t++)
+        {
+            uint8_t data[25], tag[8];
+            memcpy(data, packet + CCM_VECTOR_AAD_SIZE, vector.size);
+            AesCcm::seal(cipher, vector.nonce, aad, CCM_VECTOR_AAD_SIZE, data, vector.size, tag, tagSizes[t]);
+            if (memcmp(data, vector.ciphertext, vector.size) || memcmp(tag, tags[t], tagSizes[t]))
+            {
+                fail(t ? "CCM seal, 4-byte tag" : "CCM seal, 8-byte tag", v);
+                failures++;
+            }
+
+            memcpy(data, vector.ciphertext, vector.size);
+            if (!AesCcm::open(cipher, vector.nonce, aad, CCM_VECTOR_AAD_SIZE, data, vector.size, tags[t], tagSizes[t]) ||
+                memcmp(data, packet + CCM_VECTOR_AAD_SIZE, vector.size))
+            {
+                fail(t ? "CCM open, 4-byte tag" : "CCM open, 8-byte tag", v);
+                failures++;
+            }
+
+            memcpy(data, vector.ciphertext, vector.size);
+            data[vector.size / 2] ^= 0x01;
+            if (AesCcm::open(cipher, vector.nonce, aad, CCM_VECTOR_AAD_SIZE, data, vector.size, tags[t], tagSizes[t]))
+            {
+                fail(t ? "CCM open of a forged frame, 4-byte tag" : "CCM open of a forged frame, 8-byte tag", v);
+                failures++;
+            }
+        }
+    }
+    return failures;
+}
+
+#endif
@@ -0,0 +1,43 @@
+// Throughput of Crc32::compute(), slicing-by-8 (CRC32_SLICES 8, the
+// firmware's default), against Crc32::computeBytewise(), the classic one
+// table lookup per byte, on frame-sized and larger buffers.
+//
+//   crc_bench [bytes...]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include "../../src/components/LoRa/Crc32.h"
+#include "bench.h"
+
+int main(int argc, char **argv)
+{
+    std::vector<size_t> sizes;
+    for (int i = 1; i < argc; i++)
+        sizes.push_back(atol(argv[i]));
+    if (sizes.empty())
+        sizes = {16, 64, 255, 1024, 65536};
+
+    Crc32 crc;
+    printf("%8s %14s %10s %14s %10s %8s\n", "bytes", "bytewise c/B", "(MB/s)", "sliced c/B", "(MB/s)",
+           "speedup");
+
+    for (size_t size : sizes)
+    {
+        std::vector<uint8_t> data(size);
+        for (size_t i = 0; i < size; i++)
+            data[i] = rand();
+
+        if (crc.compute(data.data(), size) != crc.computeBytewise(data.data(), size))
+        {
+            printf("%8zu: the two functions disagree\n", size);
+            return 1;
+        }
+
+        BenchResult bytewise = bench([&] { benchKeep(crc.computeBytewise(data.data(), size)); });
+        BenchResult sliced = bench([&] { benchKeep(crc.compute(data.data(), size)); });
+        printf("%8zu %14.2f %10.0f %14.2f %10.0f %7.1fx\n", size, bytewise.cycles / size, size * 1e3 / bytewise.ns,
+               sliced.cycles / size, size * 1e3 / sliced.ns, bytewise.ns / sliced.ns);
+    }
+    return 0;
+}
@@ -0,0 +1,70 @@
+// Cost of the Reed-Solomon FEC per data byte: interleaved encoding, decoding
+// of a clean frame (syndromes only) and decoding of a frame with as many
+// byte errors as each codeword can correct.
+//
+//   fec_bench [data bytes]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../../src/components/LoRa/ReedSolomon.h"
+#include "bench.h"
+
+int main(int argc, char **argv)
+{
+    size_t size = argc > 1 ? atol(argv[1]) : 128;
+
+    printf("%6s %6s %6s %12s %12s %12s\n", "data", "parity", "depth", "encode c/B", "clean c/B", "errors c/B");
+
+    const uint8_t parities[] = {4, 8, 16, 32};
+    const uint8_t depths[] = {1, 2, 4};
+    for (uint8_t parity : parities)
+    {
+        ReedSolomon rs(parity);
+        for (uint8_t depth : depths)
+        {
+            size_t length = size + (size_t)depth * parity;
+            if (length > RS_MAX_CODEWORD * depth || (size + depth - 1) / depth + parity > RS_MAX_CODEWORD)
+                continue;
+
+            uint8_t frame[RS_MAX_CODEWORD * 4];
+            uint8_t clean[RS_MAX_CODEWORD * 4];
+            uint8_t damaged[RS_MAX_CODEWORD * 4];
+            for (size_t i = 0; i < size; i++)
+                frame[i] = rand();
+            rs.encodeInterleaved(frame, size, depth);
+            memcpy(clean, frame, length);
+
+            // parity / 2 errors in every codeword: consecutive bytes belong
+            // to distinct codewords
+            memcpy(damaged, clean, length);
+            for (size_t i = 0; i < (size_t)depth * (parity / 2) && i < length; i++)
+                damaged[i] ^= 1 + rand() % 255;
+            memcpy(frame, damaged, length);
+            if (rs.decodeInterleaved(frame, length, depth) < 0 || memcmp(frame, clean, size))
+            {
+                printf("%6zu %6u %6u: failed to correct the errors\n", size, parity, depth);
+                return 1;
+            }
+
+            BenchResult encode = bench([&] { benchKeep(rs.encodeInterleaved(frame, size, depth)); });
+            BenchResult copy = bench([&] {
+                memcpy(frame, clean, length);
+                benchKeep(frame);
+            });
+            BenchResult decodeClean = bench([&] {
+                memcpy(frame, clean, length);
+                benchKeep(rs.decodeInterleaved(frame, length, depth));
+            });
+            BenchResult decodeErrors = bench([&] {
+                memcpy(frame, damaged, length);
+                benchKeep(rs.decodeInterleaved(frame, length, depth));
+            });
+
+            // the decode loops restore the frame first, which is subtracted
+            printf("%6zu %6u %6u %12.1f %12.1f %12.1f\n", size, parity, depth, encode.cycles / size,
+                   (decodeClean.cycles - copy.cycles) / size, (decodeErrors.cycles - copy.cycles) / size);
+        }
+    }
+    return 0;
+}
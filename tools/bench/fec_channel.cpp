@@ -0,0 +1,123 @@
+// Frames sent over a simulated burst-error channel (Gilbert-Elliott: the
+// channel alternates between a clean state and bursts in which each byte is
+// corrupted with probability 1/2), protected either by the CRC32 alone, with
+// every corrupted frame sent again, or by interleaved Reed-Solomon FEC on top,
+// with a retransmission only when the decoder gives up. The sender gets up to
+// four attempts. Reports the frames delivered, the attempts and the airtime
+// per delivered frame, as Custom_LoRa frames them (header, payload, CRC32,
+// parity).
+//
+//   fec_channel [payload bytes] [mean burst bytes] [frames]
+
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../../src/components/LoRa/FrameHeader.h"
+#include "../../src/components/LoRa/RadioConfig.h"
+#include "../../src/components/LoRa/ReedSolomon.h"
+
+#define CHANNEL_ATTEMPTS 4
+
+// Byte-level Gilbert-Elliott channel
+class BurstChannel
+{
+  private:
+    std::mt19937 _rng;
+    std::uniform_real_distribution<double> _uniform;
+    double _enterBurst;
+    double _leaveBurst;
+    bool _burst = false;
+
+  public:
+    BurstChannel(double meanGapBytes, double meanBurstBytes)
+        : _rng(1), _uniform(0, 1), _enterBurst(1 / meanGapBytes), _leaveBurst(1 / meanBurstBytes)
+    {
+    }
+
+    void send(uint8_t *frame, size_t length)
+    {
+        for (size_t i = 0; i < length; i++)
+        {
+            _burst = _uniform(_rng) < (_burst ? 1 - _leaveBurst : _enterBurst);
+            if (_burst && _uniform(_rng) < 0.5)
+                frame[i] ^= 1 + _rng() % 255;
+        }
+    }
+};
+
+struct Scheme
+{
+    const char *name;
+    uint8_t parity; // 0: CRC32 only
+    uint8_t depth;
+};
+
+int main(int argc, char **argv)
+{
+    size_t payload = argc > 1 ? atol(argv[1]) : 64;
+    double burst = argc > 2 ? atof(argv[2]) : 8;
+    long frames = argc > 3 ? atol(argv[3]) : 10000;
+
+    const Scheme schemes[] = {
+        {"crc32", 0, 1}, {"rs8", 8, 1}, {"rs8x4", 8, 4}, {"rs16x4", 16, 4}, {"rs32x2", 32, 2},
+    };
+    const double gaps[] = {5000, 1000, 500, 200, 100};
+
+    RadioConfig radio;
+    printf("%zu-byte payload, bursts of %.0f bytes on average, %ld frames\n\n", payload, burst, frames);
+    printf("%-8s %6s %6s %10s %9s %12s %10s\n", "scheme", "frame", "gap", "delivered", "attempts", "airtime/fr",
+           "vs crc32");
+    printf("%-8s %6s %6s %10s %9s %12s %10s\n", "", "(B)", "(B)", "(%)", "", "(ms)", "");
+
+    for (double gap : gaps)
+    {
+        double reference = 0;
+        for (const Scheme &scheme : schemes)
+        {
+            size_t data = FRAME_HEADER_SIZE + payload + FRAME_CRC32_SIZE;
+            size_t length = data + (size_t)scheme.depth * scheme.parity;
+            if (length > 255)
+                continue;
+
+            ReedSolomon rs(scheme.parity ? scheme.parity : 2);
+            BurstChannel channel(gap, burst);
+            std::mt19937 rng(2);
+            uint32_t airtime = timeOnAirUs(radio, length);
+
+            long delivered = 0, attempts = 0;
+            for (long f = 0; f < frames; f++)
+            {
+                uint8_t sent[255], received[255];
+                for (size_t i = 0; i < data; i++)
+                    sent[i] = rng();
+                if (scheme.parity)
+                    rs.encodeInterleaved(sent, data, scheme.depth);
+
+                for (int attempt = 0; attempt < CHANNEL_ATTEMPTS; attempt++)
+                {
+                    attempts++;
+                    memcpy(received, sent, length);
+                    channel.send(received, length);
+                    if (scheme.parity && rs.decodeInterleaved(received, length, scheme.depth) < 0)
+                        continue;
+                    // stands in for the CRC32 check, which catches a wrong
+                    // correction as well
+                    if (memcmp(received, sent, data) == 0)
+                    {
+                        delivered++;
+                        break;
+                    }
+                }
+            }
+
+            double perFrame = delivered ? (double)attempts * airtime / delivered / 1000 : 0;
+            if (!scheme.parity)
+                reference = perFrame;
+            printf("%-8s %6zu %6.0f %10.2f %9.3f %12.1f %9.2fx\n", scheme.name, length, gap, 100.0 * delivered / frames,
+                   (double)attempts / frames, perFrame, reference && perFrame ? perFrame / reference : 0);
+        }
+        printf("\n");
+    }
+    return 0;
+}
@@ -0,0 +1,89 @@
+#!/usr/bin/env python3
+"""Stand-in for the upstream the gateway's HttpForwarder POSTs to.
+
+Speaks HTTP/1.1 with keep-alive, prints every batch and counts connections,
+so connection reuse shows up as many batches per connection. --fail-every N
+answers every Nth request with 503 to exercise the backoff and the
+store-and-forward path.
+
+    python3 stand_in_server.py --port 8080
+    # firmware: FORWARD_URL "http://<host ip>:8080/frames"
+"""
+
+import argparse
+import json
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+try:
+    import msgpack  # optional, only for application/msgpack batches
+except ImportError:
+    msgpack = None
+
+requests = 0
+connections = 0
+
+
+class Handler(BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"
+
+    def setup(self):
+        global connections
+        super().setup()
+        connections += 1
+        self.connection_id = connections
+        self.requests_here = 0
+
+    def do_POST(self):
+        global requests
+        requests += 1
+        self.requests_here += 1
+        body = self.rfile.read(int(self.headers.get("Content-Length", 0)))
+
+        if self.server.fail_every and requests % self.server.fail_every == 0:
+            self.reply(503)
+            print(f"#{requests} refused ({len(body)} bytes)")
+            return
+
+        records = list(decode(self.headers.get("Content-Type", ""), body))
+        print(f"#{requests} connection {self.connection_id} request {self.requests_here}: {len(records)} records, {len(body)} bytes")
+        for record in records:
+            print("   ", record)
+        self.reply(204)
+
+    def reply(self, code):
+        self.send_response(code)
+        self.send_header("Content-Length", "0")
+        self.end_headers()
+
+    def log_message(self, format, *args):
+        pass
+
+
+def decode(content_type, body):
+    if content_type.startswith("application/msgpack"):
+        if not msgpack:
+            yield f"<{len(body)} bytes of MsgPack, pip install msgpack to decode>"
+            return
+        unpacker = msgpack.Unpacker(raw=False)
+        unpacker.feed(body)
+        yield from unpacker
+        return
+    for line in body.splitlines():
+        if line.strip():
+            yield json.loads(line)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--port", type=int, default=8080)
+    parser.add_argument("--fail-every", type=int, default=0)
+    args = parser.parse_args()
+
+    server = ThreadingHTTPServer(("", args.port), Handler)
+    server.fail_every = args.fail_every
+    print(f"listening on :{args.port}")
+    server.serve_forever()
+
+
+if __name__ == "__main__":
+    main()
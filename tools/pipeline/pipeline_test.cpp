@@ -0,0 +1,170 @@
+// Host test of RadioPipeline (src/components/LoRa/RadioPipeline.h), the
+// handoff Custom_LoRa runs between its radio task and loop(). The radio is a
+// fake whose poll() emits numbered frames and whose transmit() checks the
+// requests, so the code under test is the firmware's own: emit(), send(),
+// loop(), the task, start() and stop().
+//
+// Checks, without the task and then on a std::thread, that every frame and
+// every request crosses once, intact and in order, and that frames finding
+// a full queue are dropped and counted rather than blocking either side.
+//
+//   pipeline_test [frames]
+
+#include <atomic>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include "../../src/components/LoRa/RadioPipeline.h"
+
+// Payload of frame or request n: its number in hex, then letters
+static size_t fill(char *payload, uint32_t n)
+{
+    size_t length = 8 + n % 200;
+    snprintf(payload, 9, "%08x", n);
+    for (size_t i = 8; i < length; i++)
+        payload[i] = (char)('a' + (n + i) % 26);
+    payload[length] = '\0';
+    return length;
+}
+
+// Number of an intact payload, or -1
+static long check(const char *payload, size_t length)
+{
+    char expected[LORA_MAX_FRAME + 1];
+    uint32_t n = strtoul(std::string(payload, 8).c_str(), nullptr, 16);
+    return length == fill(expected, n) && memcmp(payload, expected, length + 1) == 0 ? (long)n : -1;
+}
+
+struct FakeRadio
+{
+    RadioPipeline<FakeRadio> *pipeline = nullptr;
+    uint32_t frames = 0;                // to receive in total
+    uint32_t burst = 1;                 // frames per poll()
+    std::atomic<uint32_t> emitted{0};
+    std::atomic<uint32_t> transmitted{0};
+    uint32_t txErrors = 0;
+
+    void poll()
+    {
+        for (uint32_t i = 0; i < burst && emitted.load() < frames; i++)
+        {
+            char payload[LORA_MAX_FRAME + 1];
+            PacketInfo info = {};
+            uint32_t n = emitted.load();
+            info.addressed = true;
+            info.sequence = (uint8_t)n;
+            info.length = fill(payload, n);
+            info.rssi = -(int)(n % 120);
+            pipeline->emit(payload, info);
+            emitted.store(n + 1);
+        }
+    }
+
+    void transmit(const char *payload, size_t size, uint8_t destination)
+    {
+        if (check(payload, size) != (long)transmitted.load() || destination != (uint8_t)transmitted.load())
+            txErrors++;
+        transmitted.fetch_add(1);
+    }
+};
+
+// The application: the receive callback checks what arrives
+struct Application
+{
+    RadioPipeline<FakeRadio> *pipeline = nullptr;
+    long last = -1;
+    uint32_t delivered = 0;
+    uint32_t errors = 0;
+
+    void receive(const char *payload, int rssi)
+    {
+        const PacketInfo &info = pipeline->delivered();
+        long n = check(payload, info.length);
+        if (n <= last || info.sequence != (uint8_t)n || rssi != -(int)(n % 120))
+            errors++;
+        last = n;
+        delivered++;
+    }
+};
+
+static bool report(const char *mode, const FakeRadio &radio, const Application &app, uint32_t requested,
+                   const RuntimeStats &stats)
+{
+    bool ok = app.errors == 0 && radio.txErrors == 0 && app.delivered + stats.rx.drops == radio.frames &&
+              radio.transmitted + stats.tx.drops == requested;
+    printf("%s: %u/%u frames delivered, %u dropped; %u/%u requests sent, %u dropped; %s\n", mode, app.delivered,
+           radio.frames, stats.rx.drops, radio.transmitted.load(), requested, stats.tx.drops, ok ? "PASS" : "FAIL");
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t frames = argc > 1 ? atol(argv[1]) : 100000;
+    bool ok = true;
+
+    // Without the task loop() polls the radio, nothing is queued
+    {
+        FakeRadio radio;
+        RadioPipeline<FakeRadio> pipeline(radio);
+        Application app;
+        radio.pipeline = app.pipeline = &pipeline;
+        radio.frames = frames / 10;
+        pipeline.onReceive([&](const char *payload, int rssi) { app.receive(payload, rssi); });
+
+        uint32_t requested = 0;
+        char payload[LORA_MAX_FRAME + 1];
+        while (radio.emitted < radio.frames)
+        {
+            pipeline.loop();
+            size_t length = fill(payload, requested);
+            pipeline.send(payload, length, (uint8_t)requested++);
+        }
+        ok &= report("polled", radio, app, requested, pipeline.stats());
+        ok &= app.delivered == radio.frames;
+    }
+
+    // With the task
+    {
+        FakeRadio radio;
+        RadioPipeline<FakeRadio> pipeline(radio);
+        Application app;
+        radio.pipeline = app.pipeline = &pipeline;
+        radio.frames = frames;
+        radio.burst = LORA_RX_QUEUE_SIZE;
+        pipeline.onReceive([&](const char *payload, int rssi) { app.receive(payload, rssi); });
+
+        if (!pipeline.start(0, 5, 6144) || pipeline.start(0, 5, 6144))
+        {
+            puts("FAIL: the task must start once");
+            return 1;
+        }
+
+        uint32_t requested = 0;
+        char payload[LORA_MAX_FRAME + 1];
+        while (radio.emitted < radio.frames)
+        {
+            pipeline.loop();
+            if (requested < app.delivered / 4)
+            {
+                size_t length = fill(payload, requested);
+                pipeline.send(payload, length, (uint8_t)requested++);
+            }
+        }
+        // stop() sends and delivers what the task left in the queues
+        pipeline.stop();
+        ok &= !pipeline.running();
+        ok &= report("task", radio, app, requested, pipeline.stats());
+        ok &= app.delivered > 0 && pipeline.stats().rx.passed == app.delivered;
+
+        // and loop() polls the radio again
+        radio.frames += 10;
+        uint32_t before = app.delivered;
+        while (radio.emitted < radio.frames)
+            pipeline.loop();
+        ok &= app.delivered == before + 10;
+    }
+
+    puts(ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
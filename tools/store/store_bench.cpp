@@ -0,0 +1,162 @@
+// Throughput of SegmentLog on the host file backend: appends records like
+// the gateway does, then drains them in forwarder-sized batches with a
+// commit and compaction after each batch. Before that it checks that
+// flushed records can be read through another handle on the segment still
+// being written, the way the forwarder drains the store between rotations.
+//
+//   store_bench [directory] [records] [payload bytes] [batch]
+
+// the firmware's flash budget would drop most of a large run
+#define STORE_MAX_SEGMENTS 4096
+
+#include <chrono>
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include "../../src/components/Gateway/SegmentLog.h"
+
+static double since(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Reads the records of the only segment in dir through a handle of its own,
+// returns how many are intact
+static size_t readSegment(const Crc32 &crc, const char *dir)
+{
+    std::string file;
+    DIR *d = opendir(dir);
+    struct dirent *entry;
+    while (d && (entry = readdir(d)))
+    {
+        if (strstr(entry->d_name, ".seg"))
+            file = std::string(dir) + "/" + entry->d_name;
+    }
+    if (d)
+        closedir(d);
+
+    FILE *f = fopen(file.c_str(), "rb");
+    if (!f)
+        return 0;
+    size_t intact = 0;
+    uint8_t header[STORE_RECORD_HEADER], data[STORE_MAX_RECORD];
+    while (fread(header, 1, sizeof(header), f) == sizeof(header))
+    {
+        size_t size = header[0] | (header[1] << 8);
+        uint32_t sum = header[2] | (header[3] << 8) | (header[4] << 16) | ((uint32_t)header[5] << 24);
+        if (size > STORE_MAX_RECORD || fread(data, 1, size, f) != size ||
+            crc.compute(data, size, crc.compute(header, 2)) != sum)
+            break;
+        intact++;
+    }
+    fclose(f);
+    return intact;
+}
+
+// A few records, flushed but far from filling the segment: both the log's
+// reader and an unrelated handle must see all of them before any rotation
+static bool checkVisibility(const Crc32 &crc, const char *dir)
+{
+    std::string checkDir = std::string(dir) + ".check";
+    SegmentLog log(crc, checkDir.c_str());
+    uint8_t record[STORE_MAX_RECORD];
+    if (!log.open())
+        return false;
+    while (log.next(record) >= 0)
+        ;
+    log.commit();
+    log.compact();
+
+    const size_t count = 10;
+    uint32_t segments = log.segments();
+    for (size_t i = 0; i < count; i++)
+    {
+        memset(record, (int)i, 32);
+        log.append(record, 32);
+    }
+    if (!log.flush() || log.segments() != segments)
+        return false;
+
+    size_t other = readSegment(crc, checkDir.c_str());
+    size_t own = 0;
+    while (log.next(record) >= 0)
+        own++;
+    printf("visibility: %zu records flushed, %zu read by the log, %zu by another handle\n", count, own, other);
+    log.commit();
+    log.compact();
+    return own == count && other == count;
+}
+
+int main(int argc, char **argv)
+{
+    const char *dir = argc > 1 ? argv[1] : "store_bench.d";
+    size_t count = argc > 2 ? atol(argv[2]) : 100000;
+    size_t payload = argc > 3 ? atol(argv[3]) : 96;
+    size_t batch = argc > 4 ? atol(argv[4]) : 32;
+    if (payload > STORE_MAX_RECORD)
+        payload = STORE_MAX_RECORD;
+
+    Crc32 crc;
+    if (!checkVisibility(crc, dir))
+    {
+        printf("visibility: flushed records are not readable before rotation\n");
+        return 1;
+    }
+
+    SegmentLog log(crc, dir);
+    if (!log.open())
+    {
+        perror(dir);
+        return 1;
+    }
+
+    uint8_t record[STORE_MAX_RECORD];
+    for (size_t i = 0; i < payload; i++)
+        record[i] = 'a' + i % 26;
+
+    // drain whatever a previous run left, so the numbers below are this run's
+    while (log.next(record) >= 0)
+        ;
+    log.commit();
+    log.compact();
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; i++)
+    {
+        memcpy(record, &i, sizeof(i));
+        log.append(record, payload);
+    }
+    log.flush();
+    double writeSeconds = since(start);
+
+    size_t read = 0, bad = 0;
+    start = std::chrono::steady_clock::now();
+    for (;;)
+    {
+        size_t n = 0;
+        int length;
+        while (n < batch && (length = log.next(record)) >= 0)
+        {
+            size_t id;
+            memcpy(&id, record, sizeof(id));
+            bad += (size_t)length != payload || id != read;
+            read++;
+            n++;
+        }
+        if (!n)
+            break;
+        log.commit();
+        log.compact();
+    }
+    double readSeconds = since(start);
+
+    const StoreMetrics &m = log.metrics();
+    double mb = (double)count * payload / 1e6;
+    printf("append: %zu x %zu bytes, %.1f MB/s, %u flushes\n", count, payload, mb / writeSeconds, m.flushes);
+    printf("drain:  %zu records in batches of %zu, %.1f MB/s, %zu mismatches\n", read, batch, mb / readSeconds, bad);
+    printf("write amplification %.3f, %u cursor writes, %u blocks written, %u segments created, %u compacted, %u dropped, %u corrupt\n",
+           m.writeAmplification(), m.cursorWrites, m.blockWrites, m.segmentsCreated, m.segmentsDeleted,
+           m.segmentsDropped, m.corrupt);
+    return read == count && !bad ? 0 : 1;
+}
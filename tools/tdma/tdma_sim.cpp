@@ -0,0 +1,264 @@
+// Channel simulation of the beacon-driven TDMA mode of TdmaScheduler with
+// many nodes around one gateway, against plain ALOHA (every node sends as
+// soon as it has a frame). All nodes hear each other and the gateway; frames
+// that overlap on air are lost, beacons and join requests included, and
+// data frames are not retried. The gateway sees a collision as one corrupted
+// frame when it had locked onto the first frame of the overlap, as an
+// SX127x does, and sizes the join window from those.
+//
+//   tdma_sim [nodes] [interval s] [frame bytes] [seconds] [contention slots] [slot frame bytes]
+//
+// Without a node count it sweeps from 25 to 250 nodes. The slots default to
+// the firmware's (TDMA_DEFAULT_MAX_FRAME, TDMA_DEFAULT_CONTENTION_SLOTS).
+
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include "../../src/components/LoRa/FrameHeader.h"
+#include "../../src/components/LoRa/RadioConfig.h"
+#include "../../src/components/LoRa/TdmaScheduler.h"
+
+#define SIM_TICK_US 1000
+#define SIM_QUEUE 8 // frames a node holds, like the firmware's TX queue
+
+struct Node
+{
+    TdmaScheduler tdma;
+    uint32_t queuedUs[SIM_QUEUE]; // when each pending frame was generated
+    int pending = 0;
+    uint32_t backoffUs = 0;
+    double nextFrameUs = 0;
+    bool sending = false;
+};
+
+struct Transmission
+{
+    int node; // -1 for the beacon
+    uint32_t endUs;
+    bool collided;
+    bool join;
+    bool locked; // started on a quiet channel: the gateway is receiving it
+};
+
+struct Result
+{
+    int slots = 0;
+    int joinSlots = 0;
+    uint32_t periodMs = 0;
+    double settledS = -1; // every node had a slot
+    long offered = 0;
+    long delivered = 0;
+    long collided = 0;
+    long dropped = 0;
+    long beaconsLost = 0;
+    double latencyUs = 0;
+    double busyUs = 0;
+};
+
+// Start offset in the contention window, drawn as Custom_LoRa::transmit() does
+static uint32_t backoff(const TdmaScheduler &tdma, uint32_t airtime, std::mt19937 &rng)
+{
+    uint32_t range = tdma.backoffRangeUs(airtime);
+    return range ? rng() % range : 0;
+}
+
+static Result simulate(int nodes, double intervalS, size_t frameBytes, double seconds, uint8_t contentionSlots,
+                       size_t slotBytes, bool tdma)
+{
+    std::mt19937 rng(1);
+    std::exponential_distribution<double> arrival(1.0 / (intervalS * 1e6));
+
+    RadioConfig radio;
+    uint32_t airtime = timeOnAirUs(radio, frameBytes);
+    uint32_t joinAirtime = timeOnAirUs(radio, FRAME_HEADER_SIZE + FRAME_CRC32_SIZE);
+    uint32_t beaconAirtime = timeOnAirUs(radio, FRAME_HEADER_SIZE + FRAME_CRC32_SIZE + TDMA_BEACON_SIZE);
+
+    TdmaScheduler gateway;
+    gateway.configure(timeOnAirUs(radio, slotBytes), joinAirtime, contentionSlots);
+    std::vector<Node> node(nodes);
+    for (Node &n : node)
+    {
+        n.tdma.listen(0);
+        n.nextFrameUs = arrival(rng);
+    }
+
+    std::vector<Transmission> air;
+    uint8_t beacon[TDMA_BEACON_SIZE];
+    size_t beaconSize = 0;
+    bool beaconing = false;
+    uint32_t corrupted = 0; // since the last beacon
+    Result result;
+
+    uint32_t endUs = (uint32_t)(seconds * 1e6);
+    for (uint32_t now = 0; now < endUs; now += SIM_TICK_US)
+    {
+        // frames ending now: the gateway takes the clean ones
+        for (size_t i = 0; i < air.size();)
+        {
+            Transmission &tx = air[i];
+            if ((int32_t)(now - tx.endUs) < 0)
+            {
+                i++;
+                continue;
+            }
+
+            if (tx.node < 0)
+            {
+                gateway.beaconSent(tx.endUs);
+                beaconing = false;
+                if (tx.collided)
+                    result.beaconsLost++;
+                else
+                {
+                    for (int j = 0; j < nodes; j++)
+                        node[j].tdma.onBeacon(beacon, beaconSize, j + 1, tx.endUs);
+                }
+            }
+            else if (tx.join)
+            {
+                if (tx.collided && tx.locked)
+                    corrupted++;
+                else if (!tx.collided)
+                    gateway.assignSlot(tx.node + 1);
+                node[tx.node].sending = false;
+            }
+            else
+            {
+                Node &n = node[tx.node];
+                if (tx.collided && tx.locked)
+                    corrupted++;
+                if (tx.collided)
+                    result.collided++;
+                else
+                {
+                    result.delivered++;
+                    result.latencyUs += tx.endUs - n.queuedUs[0];
+                    if (tdma)
+                        gateway.assignSlot(tx.node + 1);
+                }
+                n.pending--;
+                for (int k = 0; k < n.pending; k++)
+                    n.queuedUs[k] = n.queuedUs[k + 1];
+                n.backoffUs = backoff(gateway, airtime, rng);
+                n.sending = false;
+            }
+            air[i] = air.back();
+            air.pop_back();
+        }
+
+        int started = 0;
+        bool quiet = air.empty();
+        if (tdma && !beaconing && gateway.beaconDue(now))
+        {
+            gateway.releaseIdle();
+            gateway.sizeJoinWindow(corrupted);
+            corrupted = 0;
+            gateway.setBeaconAirtime(beaconAirtime);
+            beaconSize = gateway.writeBeacon(beacon);
+            if (result.settledS < 0 && gateway.slotCount() == nodes)
+                result.settledS = now / 1e6;
+            air.push_back({-1, now + beaconAirtime, false, false, false});
+            result.busyUs += beaconAirtime;
+            beaconing = true;
+            started++;
+        }
+
+        for (int j = 0; j < nodes; j++)
+        {
+            Node &n = node[j];
+            while (n.nextFrameUs <= now)
+            {
+                result.offered++;
+                if (n.pending == SIM_QUEUE)
+                    result.dropped++;
+                else
+                {
+                    if (!n.pending)
+                        n.backoffUs = backoff(gateway, airtime, rng);
+                    n.queuedUs[n.pending++] = (uint32_t)n.nextFrameUs;
+                }
+                n.nextFrameUs += arrival(rng);
+            }
+
+            if (!n.pending || n.sending)
+                continue;
+
+            if (tdma && n.tdma.joinDue(now, joinAirtime, rng()))
+            {
+                air.push_back({j, now + joinAirtime, false, true, quiet && !started});
+                result.busyUs += joinAirtime;
+                n.sending = true;
+                started++;
+                continue;
+            }
+
+            if (tdma && !n.tdma.canTransmit(now, airtime, n.backoffUs))
+                continue;
+
+            air.push_back({j, now + airtime, false, false, quiet && !started});
+            result.busyUs += airtime;
+            n.sending = true;
+            started++;
+        }
+
+        // everything that shares the air with a new frame is lost
+        if (started && air.size() > 1)
+        {
+            for (Transmission &tx : air)
+                tx.collided = true;
+        }
+    }
+
+    if (tdma)
+    {
+        result.slots = gateway.slotCount();
+        result.joinSlots = gateway.joinSlots();
+        result.periodMs = gateway.periodMs();
+    }
+    if (result.delivered)
+        result.latencyUs /= result.delivered;
+    result.busyUs /= endUs;
+    return result;
+}
+
+static void print(const char *mode, int nodes, double seconds, const Result &r)
+{
+    double offered = r.offered ? r.offered : 1;
+    char settled[16] = "-";
+    if (r.settledS >= 0)
+        snprintf(settled, sizeof(settled), "%.0f", r.settledS);
+    printf("%-6s %5d %5d %4d %7u %7s %9.1f %9.1f %9.1f %9.2f %9.0f %6.2f %6ld\n", mode, nodes, r.slots, r.joinSlots,
+           r.periodMs, settled, 100 * r.delivered / offered, 100 * r.collided / offered, 100 * r.dropped / offered,
+           r.delivered / seconds, r.latencyUs / 1000, r.busyUs, r.beaconsLost);
+}
+
+int main(int argc, char **argv)
+{
+    int nodes = argc > 1 ? atoi(argv[1]) : 0;
+    double interval = argc > 2 ? atof(argv[2]) : 30;
+    size_t frame = argc > 3 ? atol(argv[3]) : 32;
+    double seconds = argc > 4 ? atof(argv[4]) : 1800;
+    uint8_t contention = argc > 5 ? atoi(argv[5]) : TDMA_DEFAULT_CONTENTION_SLOTS;
+    size_t slotFrame = argc > 6 ? atol(argv[6]) : TDMA_DEFAULT_MAX_FRAME;
+    if (nodes > 254)
+        nodes = 254; // one-byte addresses, 0xFF is broadcast
+    if (seconds > 4000)
+        seconds = 4000; // the scheduler's microsecond clock wraps at 71 minutes
+
+    RadioConfig radio;
+    printf("%zu-byte frames, %u us on air, one every %.0f s per node, %.0f s simulated\n", frame,
+           timeOnAirUs(radio, frame), interval, seconds);
+    printf("%zu-byte slots, %u contention slots\n\n", slotFrame, contention);
+    printf("%-6s %5s %5s %4s %7s %7s %9s %9s %9s %9s %9s %6s %6s\n", "mode", "nodes", "slots", "join", "period",
+           "settled", "delivered", "collided", "dropped", "goodput", "latency", "load", "beacon");
+    printf("%-6s %5s %5s %4s %7s %7s %9s %9s %9s %9s %9s %6s %6s\n", "", "", "", "", "(ms)", "(s)", "(%)", "(%)", "(%)",
+           "(fr/s)", "(ms)", "", "lost");
+
+    for (int n = nodes ? nodes : 25; n <= (nodes ? nodes : 250); n += n < 50 ? 25 : 50)
+    {
+        print("aloha", n, seconds, simulate(n, interval, frame, seconds, contention, slotFrame, false));
+        print("tdma", n, seconds, simulate(n, interval, frame, seconds, contention, slotFrame, true));
+    }
+    return 0;
+}
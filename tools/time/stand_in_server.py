@@ -0,0 +1,77 @@
+#!/usr/bin/env python3
+"""Stand-in for the time server the gateway's TimeService syncs against.
+
+Answers every GET with {"data":{"serverTime":<Unix ms>}}, the shape of the
+default server's answer. The time can be sent as a string, an integer or a
+float, shifted by a fixed offset, made to drift, and the answer delayed to
+exercise the round-trip limit. --chunked sends the answer with
+Transfer-Encoding: chunked instead of a Content-Length, as some servers and
+proxies do.
+
+    python3 stand_in_server.py --port 8081 --drift-ppm 50
+    # firmware: TimeService::instance().begin("http://<host ip>:8081/time")
+"""
+
+import argparse
+import json
+import time
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+started = time.time()
+
+
+class Handler(BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"
+
+    def do_GET(self):
+        server = self.server
+        if server.delay_ms:
+            time.sleep(server.delay_ms / 1000)
+
+        now = time.time()
+        ms = (now + (now - started) * server.drift_ppm / 1e6) * 1000 + server.offset_ms
+        value = {"string": str(int(ms)), "integer": int(ms), "float": float(int(ms))}[server.format]
+        body = json.dumps({"code": "00000", "msg": "success", "data": {"serverTime": value}}).encode()
+
+        self.send_response(200)
+        self.send_header("Content-Type", "application/json")
+        if server.chunked:
+            self.send_header("Transfer-Encoding", "chunked")
+            self.end_headers()
+            # a chunk boundary inside the number, the worst case for a parser
+            # reading the raw stream
+            split = body.index(b"serverTime") + 14
+            for chunk in (body[:split], body[split:], b""):
+                self.wfile.write(b"%x\r\n%s\r\n" % (len(chunk), chunk))
+        else:
+            self.send_header("Content-Length", str(len(body)))
+            self.end_headers()
+            self.wfile.write(body)
+        print(f"{self.client_address[0]}: serverTime {value}")
+
+    def log_message(self, format, *args):
+        pass
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--port", type=int, default=8081)
+    parser.add_argument("--format", choices=["string", "integer", "float"], default="string")
+    parser.add_argument("--offset-ms", type=int, default=0, help="added to the host clock")
+    parser.add_argument("--drift-ppm", type=float, default=0, help="rate error of the served clock")
+    parser.add_argument("--delay-ms", type=int, default=0, help="wait before answering")
+    parser.add_argument("--chunked", action="store_true", help="send the body in chunks")
+    args = parser.parse_args()
+
+    server = ThreadingHTTPServer(("", args.port), Handler)
+    server.format = args.format
+    server.offset_ms = args.offset_ms
+    server.drift_ppm = args.drift_ppm
+    server.delay_ms = args.delay_ms
+    server.chunked = args.chunked
+    print(f"listening on :{args.port}")
+    server.serve_forever()
+
+
+if __name__ == "__main__":
+    main()
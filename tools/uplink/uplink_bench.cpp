@@ -0,0 +1,58 @@
+// Decoder throughput: encodes a stream of frame records like the gateway
+// does, then times UplinkReader over it, fed in serial-sized chunks.
+//
+//   uplink_bench [records] [payload bytes]
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include "uplink_reader.h"
+
+int main(int argc, char **argv)
+{
+    size_t count = argc > 1 ? atol(argv[1]) : 200000;
+    size_t payload = argc > 2 ? atol(argv[2]) : 64;
+    if (payload > UPLINK_MAX_BODY)
+        payload = UPLINK_MAX_BODY;
+
+    Crc32 crc;
+    std::vector<uint8_t> stream;
+    uint8_t body[UPLINK_MAX_BODY];
+    uint8_t scratch[UPLINK_MAX_RECORD];
+    uint8_t encoded[UPLINK_MAX_ENCODED];
+
+    srand(1);
+    for (size_t i = 0; i < count; i++)
+    {
+        for (size_t j = 0; j < payload; j++)
+            body[j] = rand(); // includes zeros, which COBS has to stuff
+
+        UplinkHeader header = {};
+        header.type = UPLINK_TYPE_FRAME;
+        header.flags = UPLINK_FLAG_ADDRESSED;
+        header.length = payload;
+        header.timeUs = i * 1000;
+        header.source = i;
+        header.sequence = i;
+        header.rssi = -90;
+        header.snr = 7 * 16;
+        size_t length = uplinkEncode(crc, header, body, scratch, encoded);
+        stream.insert(stream.end(), encoded, encoded + length);
+    }
+
+    uint64_t bodyBytes = 0;
+    UplinkReader reader([&](const UplinkHeader &header, const uint8_t *) { bodyBytes += header.length; });
+    uint8_t sync = 0;
+    reader.feed(&sync, 1);
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t offset = 0; offset < stream.size(); offset += 256)
+        reader.feed(stream.data() + offset, stream.size() - offset < 256 ? stream.size() - offset : 256);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    printf("%llu records (%llu CRC errors), %zu wire bytes, %.1f MB/s, %.0f records/s\n",
+           (unsigned long long)reader.records(), (unsigned long long)reader.crcErrors(), stream.size(),
+           stream.size() / seconds / 1e6, reader.records() / seconds);
+    return reader.records() == count ? 0 : 1;
+}
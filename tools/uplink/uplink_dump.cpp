@@ -0,0 +1,94 @@
+// Prints the records of a gateway built with SERIAL_UPLINK 1.
+//
+//   uplink_dump /dev/ttyUSB0 [baud]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "uplink_reader.h"
+
+static speed_t toSpeed(long baud)
+{
+    switch (baud)
+    {
+    case 115200:
+        return B115200;
+    case 230400:
+        return B230400;
+    case 460800:
+        return B460800;
+    case 921600:
+        return B921600;
+    case 1500000:
+        return B1500000;
+    case 2000000:
+        return B2000000;
+    default:
+        return 0;
+    }
+}
+
+static void print(const UplinkHeader &header, const uint8_t *body)
+{
+    printf("%10.6f ", header.timeUs / 1e6);
+    switch (header.type)
+    {
+    case UPLINK_TYPE_FRAME:
+        if (header.flags & UPLINK_FLAG_ADDRESSED)
+            printf("frame src=%u seq=%u hops=%u ", header.source, header.sequence, header.hops);
+        else
+            printf("frame ");
+        printf("rssi=%d snr=%.2f len=%u: ", header.rssi, header.snr / 16.0, header.length);
+        for (size_t i = 0; i < header.length; i++)
+        {
+            uint8_t c = body[i];
+            if (c >= 0x20 && c < 0x7F)
+                putchar(c);
+            else
+                printf("\\x%02x", c);
+        }
+        putchar('\n');
+        break;
+    case UPLINK_TYPE_LOG:
+        printf("log %.*s", (int)header.length, (const char *)body);
+        if (!header.length || body[header.length - 1] != '\n')
+            putchar('\n');
+        break;
+    case UPLINK_TYPE_STATS:
+        printf("stats %u bytes%s\n", header.length, header.flags & UPLINK_FLAG_MORE ? " (more)" : "");
+        break;
+    default:
+        printf("type %u, %u bytes\n", header.type, header.length);
+        break;
+    }
+    fflush(stdout);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: %s <tty> [baud]\n", argv[0]);
+        return 2;
+    }
+
+    speed_t speed = toSpeed(argc > 2 ? atol(argv[2]) : 921600);
+    if (!speed)
+    {
+        fprintf(stderr, "unsupported baud rate\n");
+        return 2;
+    }
+
+    UplinkReader reader(print);
+    if (!reader.open(argv[1], speed))
+    {
+        perror(argv[1]);
+        return 1;
+    }
+
+    while (reader.poll())
+        ;
+
+    fprintf(stderr, "%llu records, %llu CRC errors, %llu overflows\n", (unsigned long long)reader.records(),
+            (unsigned long long)reader.crcErrors(), (unsigned long long)reader.overflows());
+    return 0;
+}
@@ -0,0 +1,130 @@
+#ifndef UPLINK_READER_H
+#define UPLINK_READER_H
+
+#include <fcntl.h>
+#include <functional>
+#include <termios.h>
+#include <unistd.h>
+#include "../../src/components/Gateway/UplinkProtocol.h"
+
+// Host side of the gateway's binary serial uplink. feed() accepts bytes in
+// any chunking, splits them on the 0x00 delimiter and hands every record
+// that decodes and passes its CRC to the callback. Bytes before the first
+// delimiter are discarded, so attaching to a running gateway is safe.
+class UplinkReader
+{
+  public:
+    typedef std::function<void(const UplinkHeader &, const uint8_t *)> Callback;
+
+  private:
+    Crc32 _crc;
+    Callback _callback;
+    uint8_t _buffer[UPLINK_MAX_ENCODED];
+    size_t _length = 0;
+    bool _synced = false;
+    bool _overflow = false;
+    int _fd = -1;
+
+    uint64_t _records = 0;
+    uint64_t _crcErrors = 0;  // framing or CRC failures
+    uint64_t _overflows = 0;  // delimiter missing for longer than a record
+
+    void record()
+    {
+        UplinkHeader header;
+        const uint8_t *body;
+        if (uplinkDecode(_crc, _buffer, _length, header, body))
+        {
+            _records++;
+            if (_callback)
+                _callback(header, body);
+        }
+        else
+        {
+            _crcErrors++;
+        }
+    }
+
+  public:
+    explicit UplinkReader(Callback callback) : _callback(callback) {}
+    ~UplinkReader() { close(); }
+
+    void feed(const uint8_t *data, size_t size)
+    {
+        for (size_t i = 0; i < size; i++)
+        {
+            uint8_t c = data[i];
+            if (c == 0)
+            {
+                if (_synced && _length && !_overflow)
+                    record();
+                _synced = true;
+                _overflow = false;
+                _length = 0;
+            }
+            else if (_length < sizeof(_buffer))
+            {
+                _buffer[_length++] = c;
+            }
+            else if (!_overflow && _synced)
+            {
+                _overflow = true;
+                _overflows++;
+            }
+        }
+    }
+
+    // Opens a tty in raw mode. baud is one of the termios B* constants,
+    // e.g. B921600.
+    bool open(const char *device, speed_t baud)
+    {
+        close();
+        _fd = ::open(device, O_RDONLY | O_NOCTTY);
+        if (_fd < 0)
+            return false;
+
+        struct termios tty;
+        if (tcgetattr(_fd, &tty) != 0)
+        {
+            close();
+            return false;
+        }
+        cfmakeraw(&tty);
+        cfsetispeed(&tty, baud);
+        cfsetospeed(&tty, baud);
+        tty.c_cflag |= CLOCAL | CREAD;
+        tty.c_cc[VMIN] = 1;
+        tty.c_cc[VTIME] = 0;
+        if (tcsetattr(_fd, TCSANOW, &tty) != 0)
+        {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    // Blocks until some bytes arrive and feeds them, returns false on EOF or
+    // error
+    bool poll()
+    {
+        uint8_t chunk[4096];
+        ssize_t n = ::read(_fd, chunk, sizeof(chunk));
+        if (n <= 0)
+            return false;
+        feed(chunk, n);
+        return true;
+    }
+
+    void close()
+    {
+        if (_fd >= 0)
+            ::close(_fd);
+        _fd = -1;
+    }
+
+    uint64_t records() const { return _records; }
+    uint64_t crcErrors() const { return _crcErrors; }
+    uint64_t overflows() const { return _overflows; }
+};
+
+#endif